@@ -18,6 +18,8 @@
 #include "glHelpers.h"
 #include "board.h"
 
+#include "MoveGen.h"
+
 using namespace Framework;
 
 
@@ -174,6 +176,7 @@ void Assignment::Run() {
         glfwPollEvents();
 
         parseInput();
+        updateOpponent(); // Never blocks: the search runs in the background
 
         // Clear screen
         RenderCommands::Clear();
@@ -236,9 +239,9 @@ void Assignment::moveMarkedSquare(int dx, int dy) {
     int y = markedSquare.y + dy; // new y
 
     // Constrain
-    if (x >= BOARD_COLS) x = BOARD_COLS-1;
+    if (x >= board->GetCols()) x = board->GetCols()-1;
     else if (x < 0) x = 0;
-    if (y >= BOARD_ROWS) y = BOARD_ROWS-1;
+    if (y >= board->GetRows()) y = board->GetRows()-1;
     else if (y < 0) y = 0;
     
     // Update markedSquare
@@ -246,32 +249,126 @@ void Assignment::moveMarkedSquare(int dx, int dy) {
     markedSquare.y = y;
 }
 
+// Board square (column x, row y) as a chess square
+static Chess::Square toSquare(Board::Pos p) {
+    return Chess::MakeSquare(p.x, p.y);
+}
+
 void Assignment::selectPiece() {
     if (selectedPiece) return; // Verify that there is no selected piece
 
+    // Only the player's own pieces, on the player's turn
+    if (gameOver || position.SideToMove() != playerColor) return;
+    Chess::Piece piece = position.PieceOn(toSquare(markedSquare));
+    if (piece == Chess::NoPiece || Chess::ColorOf(piece) != playerColor) return;
+
     // Find piece at currently marked pos
     selectedPiece = getPieceAtPos(markedSquare); // Select it
+    if (selectedPiece) highlightMoves(markedSquare);
 }
 
-// Moves the selected piece to the marked square (if possible)
+// Moves the selected piece to the marked square (if the move is legal)
 void Assignment::movePiece() {
 
     if (!selectedPiece) return; // Verify that there is a selected piece
 
-    // Check if there is a piece at the destination
-    auto destinationPiece = getPieceAtPos(markedSquare);
-    if (!destinationPiece) {
-        selectedPiece->SetPosition(markedSquare); // Move
-    }
+    Board::Pos from = selectedPiece->GetPosition();
+    Chess::Move move = Chess::FindLegalMove(position, toSquare(from), toSquare(markedSquare));
+    if (!move.IsNull()) playMove(move);
+
+    clearHighlights();
     selectedPiece = nullptr; // Reset
 }
 
+// Makes a legal move, for either side, and moves the cubes to match
+void Assignment::playMove(Chess::Move move) {
+    auto posOf = [](Chess::Square square) { return Board::Pos(Chess::FileOf(square), Chess::RankOf(square)); };
+    Board::Pos from = posOf(move.From());
+    Board::Pos to = posOf(move.To());
+
+    // Captured piece first: removing it invalidates the piece pointers
+    selectedPiece = nullptr;
+    if (move.Kind() == Chess::EnPassant)
+        removePieceAtPos(Board::Pos(to.x, from.y)); // The pawn passed beside us
+    else if (move.IsCapture())
+        removePieceAtPos(to);
+
+    getPieceAtPos(from)->SetPosition(to); // Move
+
+    // Castling also moves the rook, from the h or a file of the king's rank
+    const int rank = Chess::RankOf(move.From());
+    if (move.Kind() == Chess::KingCastle)
+        getPieceAtPos(posOf(Chess::MakeSquare(7, rank)))->SetPosition(Board::Pos(to.x-1, from.y));
+    else if (move.Kind() == Chess::QueenCastle)
+        getPieceAtPos(posOf(Chess::MakeSquare(0, rank)))->SetPosition(Board::Pos(to.x+1, from.y));
+
+    position.MakeMove(move);
+
+    // Game over?
+    Chess::MoveList replies;
+    Chess::GenerateLegalMoves(position, replies);
+    if (replies.Count == 0) {
+        std::cout << (position.InCheck() ? "Checkmate" : "Stalemate") << std::endl;
+        gameOver = true;
+    } else if (position.IsDraw()) {
+        std::cout << "Draw" << std::endl;
+        gameOver = true;
+    }
+}
+
+// Starts the opponent's search on its turn, and plays its move once the search is done
+void Assignment::updateOpponent() {
+    if (gameOver || position.SideToMove() == playerColor) return;
+
+    if (!opponentThinking) {
+        Chess::SearchLimits limits;
+        limits.TimeMs = opponentTimeMs;
+        opponent.Start(position, limits);
+        opponentThinking = true;
+        return;
+    }
+    if (opponent.IsRunning()) return;
+
+    opponentThinking = false;
+    Chess::SearchResult result = opponent.Wait();
+    if (!result.BestMove.IsNull()) playMove(result.BestMove);
+}
+
+// Colors the squares the piece at 'from' can legally move to
+void Assignment::highlightMoves(Board::Pos from) {
+    clearHighlights();
+
+    Chess::MoveList moves;
+    Chess::GenerateLegalMoves(position, moves);
+    for (Chess::Move move : moves) {
+        if (move.From() != toSquare(from)) continue;
+
+        Board::Pos to(Chess::FileOf(move.To()), Chess::RankOf(move.To()));
+        // Promotions give four moves to the same square
+        if (!highlightedSquares.empty() && highlightedSquares.back().first == to) continue;
+
+        highlightedSquares.push_back({to, board->GetSquareColor(to)});
+        board->SetSquareColor(to, glm::vec4(0.4f, 0.8f, 0.4f, 1.0f)); // Light green
+    }
+}
+
+// Restores the squares colored by highlightMoves()
+void Assignment::clearHighlights() {
+    for (auto &square : highlightedSquares)
+        board->SetSquareColor(square.first, square.second);
+    highlightedSquares.clear();
+}
+
 
 // Returns a pointer to the piece at the given pos (nullptr if none)
 Piece* Assignment::getPieceAtPos(Board::Pos p) {
-    for (int i = 0; i < pieces.size(); i++) {
-        if (pieces[i].GetPosition() == p)
-            return &pieces[i];
-    }
-    return nullptr;
-}
\ No newline at end of file
+    auto it = std::find_if(pieces.begin(), pieces.end(), [p](const Piece& piece) { return piece.GetPosition() == p; });
+    return it != pieces.end() ? &*it : nullptr;
+}
+
+// Removes the piece at the given pos (if any)
+void Assignment::removePieceAtPos(Board::Pos p) {
+    auto it = std::find_if(pieces.begin(), pieces.end(), [p](const Piece& piece) { return piece.GetPosition() == p; });
+    if (it != pieces.end())
+        pieces.erase(it);
+}
@@ -15,6 +15,9 @@
 #include "board.h"
 #include "piece.h"
 
+#include "Position.h"
+#include "Search.h"
+
 // GLFW Key callback
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
@@ -34,6 +37,15 @@ private:
     Board::Pos markedSquare = Board::Pos(0,0);
     Piece* selectedPiece = nullptr;
 
+    // Rules: red plays white from rows 0-1, blue plays black
+    Chess::Position position;
+    const Chess::Color playerColor = Chess::White;
+    Chess::Search opponent{32};     // Plays blue, searching on threads of its own
+    const int opponentTimeMs = 1000;
+    bool opponentThinking = false;
+    bool gameOver = false;
+    std::vector<std::pair<Board::Pos, glm::vec4>> highlightedSquares; // Legal destinations, with their own colors
+
     // Runtime
     double time = 0.0f; // Total time since start
     double dtime = 0.0f; // Time since last time update
@@ -46,8 +58,13 @@ private:
     void moveMarkedSquare(int deltaX, int deltaY);
     void selectPiece();
     void movePiece();
+    void playMove(Chess::Move move);
+    void updateOpponent();
+    void highlightMoves(Board::Pos from);
+    void clearHighlights();
 
     Piece* getPieceAtPos(Board::Pos p);
+    void removePieceAtPos(Board::Pos p);
 public:
     // Input
     std::vector<int> keysDown; // Keys that are currently pressed down
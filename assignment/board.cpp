@@ -1,30 +1,50 @@
+#include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "RenderCommands.h"
 #include "GeometricTools.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include "ViewFrustum.h"
+#include "StaticLayout.h"
 
 #include "board.h"
 #include "shaders/chessboard.glsh"
 
 using namespace Framework;
 
-Board::Board() {
+static constexpr char POSITION_ATTRIBUTE[] = "a_Position";
+static constexpr char COLOR_ATTRIBUTE[] = "a_Color";
+using BoardLayout = StaticLayout<Attr<ShaderDataType::Float2, POSITION_ATTRIBUTE>,
+                                 Attr<ShaderDataType::Unorm8x4, COLOR_ATTRIBUTE>>;
 
-    // Initialize board
-    auto chessBoardVertices = GeometricTools::UnitGridGeometry2D<BOARD_ROWS, BOARD_COLS>(); //data for verticies
-    auto chessBoardIndices = GeometricTools::UnitGridTopologyTriangles<BOARD_ROWS, BOARD_COLS>(); //data for squares/incencies
+Board::Board(int rows, int cols, int chunkSize) : rows(rows), cols(cols) {
 
-    auto vb = std::make_shared<VertexBuffer>(chessBoardVertices.data(), chessBoardVertices.size() * sizeof(chessBoardVertices[0]));
-    BufferLayout vboLayout = {
-        {ShaderDataType::Float2, "v_Position"}
-    };
-    vb->SetLayout(vboLayout);
-    
-    auto ib = std::make_shared<IndexBuffer>(chessBoardIndices.data(), chessBoardIndices.size());
+    // (chunkSize+1)^2 vertices must fit 16-bit indices
+    this->chunkSize = std::clamp(chunkSize, 1, 255);
+    chunkCols = (cols + this->chunkSize - 1) / this->chunkSize;
+    int chunkRows = (rows + this->chunkSize - 1) / this->chunkSize;
 
-    vertexArray = std::make_shared<VertexArray>();
-    vertexArray->AddVertexBuffer(vb);
-    vertexArray->SetIndexBuffer(ib);
+    // Initialize squares (checkered)
+    squareColors.resize((size_t)rows * cols);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            squareColors[(size_t)y * cols + x] = (x + y) % 2 == 0 ? glm::vec4(1.0f, 1.0f, 1.0f, 1.0f) : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+    }
+
+    // Initialize chunks. Meshes are built when a chunk is first drawn.
+    chunks.resize((size_t)chunkRows * chunkCols);
+    for (int cy = 0; cy < chunkRows; cy++) {
+        for (int cx = 0; cx < chunkCols; cx++) {
+            Chunk& chunk = chunks[(size_t)cy * chunkCols + cx];
+            chunk.first = Pos(cx * this->chunkSize, cy * this->chunkSize);
+            chunk.cols = std::min(this->chunkSize, cols - chunk.first.x);
+            chunk.rows = std::min(this->chunkSize, rows - chunk.first.y);
+            chunk.boundsMin = {-1.0f + 2.0f * chunk.first.x / cols, -1.0f + 2.0f * chunk.first.y / rows, 0.0f};
+            chunk.boundsMax = {-1.0f + 2.0f * (chunk.first.x + chunk.cols) / cols, -1.0f + 2.0f * (chunk.first.y + chunk.rows) / rows, 0.0f};
+        }
+    }
 
     // Shader
     shader = std::make_shared<Shader>(CB_VERTEX_SHADER, CB_FRAGMENT_SHADER);
@@ -35,14 +55,114 @@ Board::Board() {
 
 
 
+void Board::SetSquareColor(Pos square, const glm::vec4& color) {
+    if (!InBounds(square)) return;
+
+    squareColors[(size_t)square.y * cols + square.x] = color;
+    chunks[(size_t)(square.y / chunkSize) * chunkCols + square.x / chunkSize].dirty = true;
+}
+
+const glm::vec4& Board::GetSquareColor(Pos square) const {
+    static const glm::vec4 offBoard(0.0f);
+    if (!InBounds(square)) return offBoard;
+
+    return squareColors[(size_t)square.y * cols + square.x];
+}
+
+
+
+// Fills the vertex data of a chunk. The triangles of a square end in its top-right vertex,
+// which is the provoking vertex for flat shading, so the square's color is stored there.
+void Board::buildChunk(const Chunk& chunk, std::vector<Vertex>& vertices) const {
+
+    vertices.resize((size_t)(chunk.rows + 1) * (chunk.cols + 1));
+    Vertex* out = vertices.data();
+
+    for (int ly = 0; ly <= chunk.rows; ly++) {
+        int y = chunk.first.y + ly;
+        for (int lx = 0; lx <= chunk.cols; lx++) {
+            int x = chunk.first.x + lx;
+
+            // Position (same values as GeometricTools::UnitGridGeometry2D)
+            out->x = (-1)+(float)x*2/cols;
+            out->y = (-1)+(float)y*2/rows;
+
+            // Color of the square below-left of the vertex (unused on the chunk's first row/column)
+            out->color = (lx > 0 && ly > 0) ? MeshOptimizer::QuantizeUnorm8x4(squareColors[(size_t)(y - 1) * cols + (x - 1)]) : 0;
+
+            out++;
+        }
+    }
+}
+
+void Board::uploadChunk(Chunk& chunk, const std::vector<Vertex>& vertices) {
+
+    GLsizei size = (GLsizei)(vertices.size() * sizeof(Vertex));
+
+    // Rebuild: only the vertex data changes
+    if (chunk.vertexArray) {
+        chunk.vertexBuffer->BufferSubData(0, size, vertices.data());
+        return;
+    }
+
+    static_assert(BoardLayout::Stride == sizeof(Vertex), "Vertex does not match the layout");
+    static_assert(BoardLayout::Offset<1> == offsetof(Vertex, color), "Vertex does not match the layout");
+
+    chunk.vertexBuffer = std::make_shared<VertexBuffer>(vertices.data(), size);
+    chunk.vertexBuffer->SetLayout(BoardLayout::ToBufferLayout());
+
+    auto& ib = indexBuffers[{chunk.cols, chunk.rows}];
+    if (!ib) {
+        // Triangles keep their vertex order, so each square keeps its provoking vertex
+        auto indices = GeometricTools::UnitGridTopologyTriangles(chunk.rows, chunk.cols);
+        MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), (size_t)(chunk.rows + 1) * (chunk.cols + 1));
+        std::vector<GLushort> indices16(indices.begin(), indices.end());
+        ib = std::make_shared<IndexBuffer>(indices16.data(), (GLsizei)indices16.size());
+    }
+
+    chunk.vertexArray = std::make_shared<VertexArray>();
+    chunk.vertexArray->AddVertexBuffer(chunk.vertexBuffer);
+    chunk.vertexArray->SetIndexBuffer(ib);
+}
+
+
+
 void Board::Draw(glm::mat4 cameraModel, Pos markedSquare) {
 
-    vertexArray->Bind();          
+    // Cull chunks in the board's local space
+    ViewFrustum frustum(cameraModel * modelMatrix);
+    std::vector<Chunk*> visible;
+    std::vector<Chunk*> rebuild;
+    for (auto& chunk : chunks) {
+        if (!frustum.IntersectsBox(chunk.boundsMin, chunk.boundsMax)) continue;
+        visible.push_back(&chunk);
+        if (chunk.dirty) rebuild.push_back(&chunk);
+    }
+    visibleChunks = visible.size();
+
+    // Rebuild the visible dirty chunks: vertex data in parallel, upload on this thread
+    if (!rebuild.empty()) {
+        std::vector<std::vector<Vertex>> vertices(rebuild.size());
+        ThreadPool::GetShared().ParallelFor(0, rebuild.size(), 1, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                buildChunk(*rebuild[i], vertices[i]);
+            }
+        });
+        for (size_t i = 0; i < rebuild.size(); i++) {
+            uploadChunk(*rebuild[i], vertices[i]);
+            rebuild[i]->dirty = false;
+        }
+    }
+
     shader->Bind();
 
     shader->UploadUniformMatrix4("u_Model", modelMatrix);
     shader->UploadUniformMatrix4("u_ViewProjection", cameraModel);
     shader->UploadUniformInt2("u_markedSquare", markedSquare.x, markedSquare.y);
-    shader->UploadUniformInt2("u_gridLayout", BOARD_COLS, BOARD_ROWS);
-    RenderCommands::DrawIndex(vertexArray, GL_TRIANGLES);
+    shader->UploadUniformInt2("u_gridLayout", cols, rows);
+
+    for (auto chunk : visible) {
+        chunk->vertexArray->Bind();
+        RenderCommands::DrawIndex(chunk->vertexArray, GL_TRIANGLES);
+    }
 }
\ No newline at end of file
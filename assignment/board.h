@@ -2,7 +2,11 @@
 #define BOARD_H
 
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 #include "VertexArray.h"
 #include "Shader.h"
 #include "TextureManager.h"
@@ -12,6 +16,12 @@ const int BOARD_COLS = 8;
 constexpr float BOARD_SQUARE_XSIZE = 2.0f/(float)BOARD_COLS;
 constexpr float BOARD_SQUARE_YSIZE = 2.0f/(float)BOARD_ROWS;
 
+// Board of rows x cols squares, spanning [-1, 1] in x and y.
+//
+// The board is split into chunks of at most chunkSize x chunkSize squares, each with its own
+// mesh and bounding box. Chunks outside the camera frustum are skipped, and a chunk's mesh is
+// only (re)built when it is visible and its squares have changed, so boards with millions of
+// squares stay interactive.
 class Board {
   public:
     struct Pos {
@@ -22,17 +32,57 @@ class Board {
     };
 
   private:
-    std::shared_ptr<Framework::VertexArray> vertexArray;
+    struct Vertex {
+        float x, y;
+        uint32_t color;             // Unorm8x4
+    };
+
+    struct Chunk {
+        Pos first;                  // First square (column, row)
+        int cols, rows;             // Squares covered
+        glm::vec3 boundsMin, boundsMax;
+        std::shared_ptr<Framework::VertexArray> vertexArray; // Created when first visible
+        std::shared_ptr<Framework::VertexBuffer> vertexBuffer;
+        bool dirty = true;
+    };
+
+    int rows, cols;
+    int chunkSize;
+    int chunkCols;                  // Chunks per row
+    std::vector<glm::vec4> squareColors;
+    std::vector<Chunk> chunks;
+    // Chunks of equal size share their index buffer
+    std::map<std::pair<int, int>, std::shared_ptr<Framework::IndexBuffer>> indexBuffers;
+    size_t visibleChunks = 0;
+
     std::shared_ptr<Framework::Shader> shader;
     glm::mat4 modelMatrix;
 
+    void buildChunk(const Chunk& chunk, std::vector<Vertex>& vertices) const;
+    void uploadChunk(Chunk& chunk, const std::vector<Vertex>& vertices);
+
   public:
-    Board();
+    // chunkSize is limited to 255, so chunk meshes can use 16-bit indices.
+    Board(int rows = BOARD_ROWS, int cols = BOARD_COLS, int chunkSize = 64);
     ~Board() {}
 
+    int GetRows() const { return rows; }
+    int GetCols() const { return cols; }
+
+    bool InBounds(Pos square) const { return square.x >= 0 && square.x < cols && square.y >= 0 && square.y < rows; }
+
+    // Per-square color. Changing it marks the square's chunk for rebuilding. Squares off the
+    // board are ignored, and read as transparent black.
+    void SetSquareColor(Pos square, const glm::vec4& color);
+    const glm::vec4& GetSquareColor(Pos square) const;
+
     void Draw(glm::mat4 cameraModel, Pos markedSquare);
+
+    // Number of chunks drawn by the last Draw() call.
+    size_t GetVisibleChunkCount() const { return visibleChunks; }
+    size_t GetChunkCount() const { return chunks.size(); }
 };
 
 
 
-#endif
\ No newline at end of file
+#endif
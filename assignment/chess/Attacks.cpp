@@ -0,0 +1,158 @@
+#include "Attacks.h"
+
+#include <mutex>
+#include <vector>
+
+namespace Chess {
+
+    namespace Attacks {
+
+        Bitboard PawnTable[2][64];
+        Bitboard KnightTable[64];
+        Bitboard KingTable[64];
+        Bitboard BetweenTable[64][64];
+        Bitboard LineTable[64][64];
+        Magic RookMagics[64];
+        Magic BishopMagics[64];
+
+        namespace {
+            // Sizes of the attack tables: sum over the squares of 2^(mask bits)
+            Bitboard RookAttackTable[0x19000];
+            Bitboard BishopAttackTable[0x1480];
+
+            const int RookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+            const int BishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+            inline bool OnBoard(int file, int rank) {
+                return file >= 0 && file < 8 && rank >= 0 && rank < 8;
+            }
+
+            // Squares reached from 'square' by single steps
+            Bitboard Steps(Square square, const int (*steps)[2], int count) {
+                Bitboard result = 0;
+                for (int i = 0; i < count; i++) {
+                    int file = FileOf(square) + steps[i][0];
+                    int rank = RankOf(square) + steps[i][1];
+                    if (OnBoard(file, rank)) result |= SquareBit(MakeSquare(file, rank));
+                }
+                return result;
+            }
+
+            // Slider attacks by walking the rays, for building the tables
+            Bitboard SlidingAttacks(Square square, Bitboard occupied, const int (*directions)[2]) {
+                Bitboard result = 0;
+                for (int d = 0; d < 4; d++) {
+                    int file = FileOf(square) + directions[d][0];
+                    int rank = RankOf(square) + directions[d][1];
+                    while (OnBoard(file, rank)) {
+                        Bitboard bit = SquareBit(MakeSquare(file, rank));
+                        result |= bit;
+                        if (occupied & bit) break;
+                        file += directions[d][0];
+                        rank += directions[d][1];
+                    }
+                }
+                return result;
+            }
+
+            // xorshift64*, fixed seed: the same magics on every run
+            struct Random {
+                uint64_t State = 1070372ull;
+                uint64_t Next() {
+                    State ^= State >> 12;
+                    State ^= State << 25;
+                    State ^= State >> 27;
+                    return State * 2685821657736338717ull;
+                }
+                // Numbers with few bits set make good magic candidates
+                uint64_t Sparse() { return Next() & Next() & Next(); }
+            };
+
+            void InitMagics(Magic* magics, Bitboard* table, const int (*directions)[2], Random& random) {
+                std::vector<Bitboard> occupancies, references;
+                std::vector<int> epoch(4096, 0);
+                int attempt = 0;
+
+                for (Square square = 0; square < 64; square++) {
+                    Magic& magic = magics[square];
+
+                    // Edges only block squares beyond them, so they are left out of the mask
+                    Bitboard edges = ((Rank1 | Rank8) & ~(Rank1 << (8 * RankOf(square))))
+                                   | ((FileA | FileH) & ~(FileA << FileOf(square)));
+                    magic.Mask = SlidingAttacks(square, 0, directions) & ~edges;
+                    magic.Shift = 64 - PopCount(magic.Mask);
+                    magic.Table = table;
+
+                    // Every subset of the mask (Carry-Rippler) with its attack set
+                    occupancies.clear();
+                    references.clear();
+                    Bitboard subset = 0;
+                    do {
+                        occupancies.push_back(subset);
+                        references.push_back(SlidingAttacks(square, subset, directions));
+                        subset = (subset - magic.Mask) & magic.Mask;
+                    } while (subset);
+
+                    // Try numbers until every subset maps to a slot holding its attack set
+                    size_t i = 0;
+                    while (i < occupancies.size()) {
+                        magic.Number = random.Sparse();
+                        if (PopCount((magic.Mask * magic.Number) >> 56) < 6) continue;
+
+                        attempt++;
+                        for (i = 0; i < occupancies.size(); i++) {
+                            unsigned int index = magic.Index(occupancies[i]);
+                            if (epoch[index] < attempt) {
+                                epoch[index] = attempt;
+                                table[index] = references[i];
+                            } else if (table[index] != references[i]) {
+                                break;
+                            }
+                        }
+                    }
+
+                    table += occupancies.size();
+                }
+            }
+
+            void InitTables() {
+                const int pawnSteps[2][2][2] = {{{-1, 1}, {1, 1}}, {{-1, -1}, {1, -1}}};
+                const int knightSteps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+                const int kingSteps[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+
+                for (Square square = 0; square < 64; square++) {
+                    PawnTable[White][square] = Steps(square, pawnSteps[White], 2);
+                    PawnTable[Black][square] = Steps(square, pawnSteps[Black], 2);
+                    KnightTable[square] = Steps(square, knightSteps, 8);
+                    KingTable[square] = Steps(square, kingSteps, 8);
+                }
+
+                Random random;
+                InitMagics(RookMagics, RookAttackTable, RookDirections, random);
+                InitMagics(BishopMagics, BishopAttackTable, BishopDirections, random);
+
+                for (Square a = 0; a < 64; a++) {
+                    for (Square b = 0; b < 64; b++) {
+                        BetweenTable[a][b] = 0;
+                        LineTable[a][b] = 0;
+                        if (a == b) continue;
+
+                        const Bitboard bitA = SquareBit(a), bitB = SquareBit(b);
+                        if (RookAttacks(a, 0) & bitB) {
+                            BetweenTable[a][b] = RookAttacks(a, bitB) & RookAttacks(b, bitA);
+                            LineTable[a][b] = (RookAttacks(a, 0) & RookAttacks(b, 0)) | bitA | bitB;
+                        } else if (BishopAttacks(a, 0) & bitB) {
+                            BetweenTable[a][b] = BishopAttacks(a, bitB) & BishopAttacks(b, bitA);
+                            LineTable[a][b] = (BishopAttacks(a, 0) & BishopAttacks(b, 0)) | bitA | bitB;
+                        }
+                    }
+                }
+            }
+        }
+
+        void Init() {
+            static std::once_flag once;
+            std::call_once(once, InitTables);
+        }
+    };
+};
@@ -0,0 +1,58 @@
+#ifndef ATTACKS_H_
+#define ATTACKS_H_
+
+#include "Chess.h"
+
+// Attack tables. Sliding pieces use magic bitboards: the blockers on a piece's rays, times a
+// per-square magic number, give a perfect hash into a table of precomputed attack sets.
+namespace Chess {
+
+  namespace Attacks {
+
+    struct Magic {
+      Bitboard Mask;                // Ray squares that can block (board edges excluded)
+      Bitboard Number;
+      const Bitboard* Table;
+      unsigned int Shift;
+
+      inline unsigned int Index(Bitboard occupied) const {
+        return static_cast<unsigned int>(((occupied & Mask) * Number) >> Shift);
+      }
+    };
+
+    extern Bitboard PawnTable[2][64];   // Squares a pawn of the color attacks
+    extern Bitboard KnightTable[64];
+    extern Bitboard KingTable[64];
+    extern Bitboard BetweenTable[64][64]; // Squares strictly between two aligned squares
+    extern Bitboard LineTable[64][64];    // The whole line through two aligned squares
+    extern Magic RookMagics[64];
+    extern Magic BishopMagics[64];
+
+    // Fill the tables (done once; Position calls it).
+    void Init();
+
+    inline Bitboard PawnAttacks(Color color, Square square) { return PawnTable[color][square]; }
+    inline Bitboard KnightAttacks(Square square) { return KnightTable[square]; }
+    inline Bitboard KingAttacks(Square square) { return KingTable[square]; }
+
+    inline Bitboard RookAttacks(Square square, Bitboard occupied) {
+      const Magic& magic = RookMagics[square];
+      return magic.Table[magic.Index(occupied)];
+    }
+
+    inline Bitboard BishopAttacks(Square square, Bitboard occupied) {
+      const Magic& magic = BishopMagics[square];
+      return magic.Table[magic.Index(occupied)];
+    }
+
+    inline Bitboard QueenAttacks(Square square, Bitboard occupied) {
+      return RookAttacks(square, occupied) | BishopAttacks(square, occupied);
+    }
+
+    // Empty unless the squares share a rank, file or diagonal
+    inline Bitboard Between(Square a, Square b) { return BetweenTable[a][b]; }
+    inline Bitboard Line(Square a, Square b) { return LineTable[a][b]; }
+  };
+};
+
+#endif // ATTACKS_H_
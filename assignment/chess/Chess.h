@@ -0,0 +1,134 @@
+#ifndef CHESS_H_
+#define CHESS_H_
+
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Basic types of the chess engine: squares, pieces, bitboards and moves.
+//
+// Squares are numbered 0 (a1) to 63 (h8), rank by rank. A bitboard is a set of squares, one
+// bit per square.
+namespace Chess {
+
+  using Bitboard = uint64_t;
+  using Square = int;
+
+  constexpr Square NoSquare = 64;
+
+  enum Color : uint8_t { White, Black };
+
+  enum PieceType : uint8_t { Pawn, Knight, Bishop, Rook, Queen, King };
+
+  // Color * 6 + PieceType
+  enum Piece : uint8_t {
+    WhitePawn, WhiteKnight, WhiteBishop, WhiteRook, WhiteQueen, WhiteKing,
+    BlackPawn, BlackKnight, BlackBishop, BlackRook, BlackQueen, BlackKing,
+    NoPiece
+  };
+
+  enum CastlingRights : uint8_t {
+    WhiteKingSide = 1, WhiteQueenSide = 2, BlackKingSide = 4, BlackQueenSide = 8,
+    AllCastling = 15
+  };
+
+  inline constexpr Color Opponent(Color color) { return static_cast<Color>(color ^ 1); }
+  inline constexpr Piece MakePiece(Color color, PieceType type) { return static_cast<Piece>(color * 6 + type); }
+  inline constexpr Color ColorOf(Piece piece) { return static_cast<Color>(piece / 6); }
+  inline constexpr PieceType TypeOf(Piece piece) { return static_cast<PieceType>(piece % 6); }
+
+  inline constexpr int FileOf(Square square) { return square & 7; }
+  inline constexpr int RankOf(Square square) { return square >> 3; }
+  inline constexpr Square MakeSquare(int file, int rank) { return rank * 8 + file; }
+
+  // Bitboards
+
+  constexpr Bitboard FileA = 0x0101010101010101ull;
+  constexpr Bitboard FileH = FileA << 7;
+  constexpr Bitboard Rank1 = 0xffull;
+  constexpr Bitboard Rank2 = Rank1 << 8;
+  constexpr Bitboard Rank3 = Rank1 << 16;
+  constexpr Bitboard Rank6 = Rank1 << 40;
+  constexpr Bitboard Rank7 = Rank1 << 48;
+  constexpr Bitboard Rank8 = Rank1 << 56;
+
+  inline constexpr Bitboard SquareBit(Square square) { return 1ull << square; }
+
+  inline int PopCount(Bitboard b) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(b));
+#else
+    return __builtin_popcountll(b);
+#endif
+  }
+
+  // Lowest square in a non-empty bitboard
+  inline Square LowestSquare(Bitboard b) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, b);
+    return static_cast<Square>(index);
+#else
+    return __builtin_ctzll(b);
+#endif
+  }
+
+  // Remove and return the lowest square of a non-empty bitboard
+  inline Square PopLowestSquare(Bitboard& b) {
+    Square square = LowestSquare(b);
+    b &= b - 1;
+    return square;
+  }
+
+  // Moves
+  //
+  // 16 bits: origin (6), destination (6) and a 4-bit kind. The kinds follow the usual
+  // layout: bit 2 marks captures and bit 3 promotions, whose low two bits give the piece.
+
+  enum MoveKind : uint16_t {
+    Quiet = 0, DoublePush = 1, KingCastle = 2, QueenCastle = 3,
+    Capture = 4, EnPassant = 5,
+    PromoteKnight = 8, PromoteBishop = 9, PromoteRook = 10, PromoteQueen = 11,
+    CapturePromoteKnight = 12, CapturePromoteBishop = 13, CapturePromoteRook = 14, CapturePromoteQueen = 15
+  };
+
+  struct Move {
+    uint16_t Data = 0;
+
+    Move() = default;
+    constexpr Move(Square from, Square to, MoveKind kind)
+      : Data(static_cast<uint16_t>(from | (to << 6) | (kind << 12))) {}
+
+    inline constexpr Square From() const { return Data & 63; }
+    inline constexpr Square To() const { return (Data >> 6) & 63; }
+    inline constexpr MoveKind Kind() const { return static_cast<MoveKind>(Data >> 12); }
+    inline constexpr bool IsCapture() const { return (Data >> 12) & Capture; }
+    inline constexpr bool IsPromotion() const { return (Data >> 12) & 8; }
+    inline constexpr PieceType Promotion() const { return static_cast<PieceType>(Knight + ((Data >> 12) & 3)); }
+    inline constexpr bool IsNull() const { return Data == 0; }
+
+    inline constexpr bool operator==(Move other) const { return Data == other.Data; }
+    inline constexpr bool operator!=(Move other) const { return Data != other.Data; }
+  };
+
+  // Long algebraic notation, as used by UCI: "e2e4", "e7e8q"
+  std::string ToUci(Move move);
+  std::string SquareName(Square square);
+
+  // Enough for any legal position (the most known is 218)
+  struct MoveList {
+    Move Moves[256];
+    int Count = 0;
+
+    inline void Add(Move move) { Moves[Count++] = move; }
+    inline const Move* begin() const { return Moves; }
+    inline const Move* end() const { return Moves + Count; }
+    inline Move* begin() { return Moves; }
+    inline Move* end() { return Moves + Count; }
+  };
+};
+
+#endif // CHESS_H_
@@ -0,0 +1,118 @@
+#include "Evaluate.h"
+
+namespace Chess {
+
+    const int PieceValues[6] = {100, 320, 330, 500, 900, 0};
+
+    namespace {
+        // Piece-square tables for white, written as the board is seen from white's side:
+        // rank 8 first. A white piece on 'square' reads entry square ^ 56, a black one 'square'.
+        const int PawnTable[64] = {
+              0,   0,   0,   0,   0,   0,   0,   0,
+             50,  50,  50,  50,  50,  50,  50,  50,
+             10,  10,  20,  30,  30,  20,  10,  10,
+              5,   5,  10,  25,  25,  10,   5,   5,
+              0,   0,   0,  20,  20,   0,   0,   0,
+              5,  -5, -10,   0,   0, -10,  -5,   5,
+              5,  10,  10, -20, -20,  10,  10,   5,
+              0,   0,   0,   0,   0,   0,   0,   0
+        };
+        const int KnightTable[64] = {
+            -50, -40, -30, -30, -30, -30, -40, -50,
+            -40, -20,   0,   0,   0,   0, -20, -40,
+            -30,   0,  10,  15,  15,  10,   0, -30,
+            -30,   5,  15,  20,  20,  15,   5, -30,
+            -30,   0,  15,  20,  20,  15,   0, -30,
+            -30,   5,  10,  15,  15,  10,   5, -30,
+            -40, -20,   0,   5,   5,   0, -20, -40,
+            -50, -40, -30, -30, -30, -30, -40, -50
+        };
+        const int BishopTable[64] = {
+            -20, -10, -10, -10, -10, -10, -10, -20,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -10,   0,   5,  10,  10,   5,   0, -10,
+            -10,   5,   5,  10,  10,   5,   5, -10,
+            -10,   0,  10,  10,  10,  10,   0, -10,
+            -10,  10,  10,  10,  10,  10,  10, -10,
+            -10,   5,   0,   0,   0,   0,   5, -10,
+            -20, -10, -10, -10, -10, -10, -10, -20
+        };
+        const int RookTable[64] = {
+              0,   0,   0,   0,   0,   0,   0,   0,
+              5,  10,  10,  10,  10,  10,  10,   5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+              0,   0,   0,   5,   5,   0,   0,   0
+        };
+        const int QueenTable[64] = {
+            -20, -10, -10,  -5,  -5, -10, -10, -20,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -10,   0,   5,   5,   5,   5,   0, -10,
+             -5,   0,   5,   5,   5,   5,   0,  -5,
+              0,   0,   5,   5,   5,   5,   0,  -5,
+            -10,   5,   5,   5,   5,   5,   0, -10,
+            -10,   0,   5,   0,   0,   0,   0, -10,
+            -20, -10, -10,  -5,  -5, -10, -10, -20
+        };
+        // Sheltered in the middlegame...
+        const int KingMiddleTable[64] = {
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -20, -30, -30, -40, -40, -30, -30, -20,
+            -10, -20, -20, -20, -20, -20, -20, -10,
+             20,  20,   0,   0,   0,   0,  20,  20,
+             20,  30,  10,   0,   0,  10,  30,  20
+        };
+        // ...and central in the endgame
+        const int KingEndTable[64] = {
+            -50, -40, -30, -20, -20, -30, -40, -50,
+            -30, -20, -10,   0,   0, -10, -20, -30,
+            -30, -10,  20,  30,  30,  20, -10, -30,
+            -30, -10,  30,  40,  40,  30, -10, -30,
+            -30, -10,  30,  40,  40,  30, -10, -30,
+            -30, -10,  20,  30,  30,  20, -10, -30,
+            -30, -30,   0,   0,   0,   0, -30, -30,
+            -50, -30, -30, -30, -30, -30, -30, -50
+        };
+
+        const int* const PieceTables[5] = {PawnTable, KnightTable, BishopTable, RookTable, QueenTable};
+
+        // Game phase: 24 with all pieces on the board, 0 with only kings and pawns
+        const int PhaseWeights[6] = {0, 1, 1, 2, 4, 0};
+        constexpr int MaxPhase = 24;
+
+        // Material and tables of one color, from white's point of view of the tables
+        template<Color Us>
+        int EvaluateSide(const Position& position, int phase) {
+            constexpr int Flip = Us == White ? 56 : 0;
+            int score = 0;
+            for (int type = Pawn; type <= Queen; type++) {
+                Bitboard pieces = position.Pieces(Us, static_cast<PieceType>(type));
+                while (pieces) {
+                    score += PieceValues[type] + PieceTables[type][PopLowestSquare(pieces) ^ Flip];
+                }
+            }
+
+            const Square king = position.KingSquare(Us) ^ Flip;
+            score += (KingMiddleTable[king] * phase + KingEndTable[king] * (MaxPhase - phase)) / MaxPhase;
+            return score;
+        }
+    }
+
+    int Evaluate(const Position& position) {
+        int phase = 0;
+        for (int type = Knight; type <= Queen; type++) {
+            phase += PhaseWeights[type] * PopCount(position.Pieces(White, static_cast<PieceType>(type))
+                                                 | position.Pieces(Black, static_cast<PieceType>(type)));
+        }
+        if (phase > MaxPhase) phase = MaxPhase;     // Promotions
+
+        const int score = EvaluateSide<White>(position, phase) - EvaluateSide<Black>(position, phase);
+        return position.SideToMove() == White ? score : -score;
+    }
+};
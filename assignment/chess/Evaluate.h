@@ -0,0 +1,18 @@
+#ifndef EVALUATE_H_
+#define EVALUATE_H_
+
+#include "Chess.h"
+#include "Position.h"
+
+namespace Chess {
+
+  // Pawn = 100, by piece type. The king has no material value.
+  extern const int PieceValues[6];
+
+  // Static evaluation in centipawns, from the side to move's point of view: material plus
+  // piece-square tables. The king's table is blended from middlegame to endgame as the
+  // pieces come off.
+  int Evaluate(const Position& position);
+};
+
+#endif // EVALUATE_H_
@@ -0,0 +1,220 @@
+#include "MoveGen.h"
+
+namespace Chess {
+
+    namespace {
+        template<int Offset>
+        inline Bitboard Shift(Bitboard b) {
+            return Offset > 0 ? b << Offset : b >> -Offset;
+        }
+
+        // Moves from 'from' to each of 'targets'
+        inline void AddMoves(MoveList& moves, Square from, Bitboard targets, Bitboard enemies) {
+            while (targets) {
+                Square to = PopLowestSquare(targets);
+                moves.Add(Move(from, to, (enemies & SquareBit(to)) ? Capture : Quiet));
+            }
+        }
+
+        // Pawn moves to each of 'targets', made by pawns 'offset' squares back
+        inline void AddPawnMoves(MoveList& moves, Bitboard targets, int offset, MoveKind kind) {
+            while (targets) {
+                Square to = PopLowestSquare(targets);
+                moves.Add(Move(to - offset, to, kind));
+            }
+        }
+
+        // Queen first, since it is nearly always the best
+        inline void AddPromotions(MoveList& moves, Square from, Square to, bool capture) {
+            const int base = capture ? CapturePromoteKnight : PromoteKnight;
+            for (int piece = 3; piece >= 0; piece--) moves.Add(Move(from, to, static_cast<MoveKind>(base + piece)));
+        }
+
+        inline void AddPawnPromotions(MoveList& moves, Bitboard targets, int offset, bool capture) {
+            while (targets) {
+                Square to = PopLowestSquare(targets);
+                AddPromotions(moves, to - offset, to, capture);
+            }
+        }
+
+        template<Color Us>
+        void Generate(const Position& position, MoveList& moves) {
+            constexpr Color Them = Opponent(Us);
+            constexpr int Up = Us == White ? 8 : -8;
+            constexpr Bitboard StartRank = Us == White ? Rank2 : Rank7;
+            constexpr Bitboard PromotionRank = Us == White ? Rank7 : Rank2;    // Pawns about to promote
+            constexpr Bitboard DoublePushRank = Us == White ? Rank3 : Rank6;   // Reached by a first single push
+
+            const Bitboard ours = position.Pieces(Us);
+            const Bitboard theirs = position.Pieces(Them);
+            const Bitboard occupied = ours | theirs;
+            const Square king = position.KingSquare(Us);
+
+            // King: sliders see through the king's old square, so it cannot step back along a check
+            const Bitboard withoutKing = occupied ^ SquareBit(king);
+            Bitboard kingTargets = Attacks::KingAttacks(king) & ~ours;
+            while (kingTargets) {
+                Square to = PopLowestSquare(kingTargets);
+                if (!(position.AttackersTo(to, withoutKing) & theirs)) moves.Add(Move(king, to, (theirs & SquareBit(to)) ? Capture : Quiet));
+            }
+
+            const Bitboard checkers = position.AttackersTo(king, occupied) & theirs;
+            if (checkers & (checkers - 1)) return;      // Double check: only the king moves
+
+            // Other pieces must take the checker or step in between
+            const Bitboard checkMask = checkers ? Attacks::Between(king, LowestSquare(checkers)) | checkers : ~0ull;
+            const Bitboard targets = ~ours & checkMask;
+
+            // Pieces pinned to the king may only move along the pin
+            const Bitboard theirRooks = position.Pieces(Them, Rook) | position.Pieces(Them, Queen);
+            const Bitboard theirBishops = position.Pieces(Them, Bishop) | position.Pieces(Them, Queen);
+            Bitboard pinned = 0;
+            Bitboard snipers = (Attacks::RookAttacks(king, 0) & theirRooks) | (Attacks::BishopAttacks(king, 0) & theirBishops);
+            while (snipers) {
+                const Bitboard between = Attacks::Between(king, PopLowestSquare(snipers)) & occupied;
+                if (between && !(between & (between - 1))) pinned |= between & ours;
+            }
+
+            // A pinned knight can never stay on the pin line
+            Bitboard knights = position.Pieces(Us, Knight) & ~pinned;
+            while (knights) {
+                Square from = PopLowestSquare(knights);
+                AddMoves(moves, from, Attacks::KnightAttacks(from) & targets, theirs);
+            }
+
+            Bitboard bishops = position.Pieces(Us, Bishop) | position.Pieces(Us, Queen);
+            while (bishops) {
+                Square from = PopLowestSquare(bishops);
+                Bitboard to = Attacks::BishopAttacks(from, occupied) & targets;
+                if (pinned & SquareBit(from)) to &= Attacks::Line(king, from);
+                AddMoves(moves, from, to, theirs);
+            }
+
+            Bitboard rooks = position.Pieces(Us, Rook) | position.Pieces(Us, Queen);
+            while (rooks) {
+                Square from = PopLowestSquare(rooks);
+                Bitboard to = Attacks::RookAttacks(from, occupied) & targets;
+                if (pinned & SquareBit(from)) to &= Attacks::Line(king, from);
+                AddMoves(moves, from, to, theirs);
+            }
+
+            // Pawns that are not pinned, all at once with shifts
+            const Bitboard pawns = position.Pieces(Us, Pawn);
+            const Bitboard empty = ~occupied;
+            {
+                const Bitboard normal = pawns & ~pinned & ~PromotionRank;
+                const Bitboard promoting = pawns & ~pinned & PromotionRank;
+
+                Bitboard single = Shift<Up>(normal) & empty;
+                Bitboard twice = Shift<Up>(single & DoublePushRank) & empty & checkMask;
+                single &= checkMask;
+                AddPawnMoves(moves, single, Up, Quiet);
+                AddPawnMoves(moves, twice, 2 * Up, DoublePush);
+
+                // Towards file a (Up - 1) and towards file h (Up + 1)
+                AddPawnMoves(moves, Shift<Up - 1>(normal & ~FileA) & theirs & checkMask, Up - 1, Capture);
+                AddPawnMoves(moves, Shift<Up + 1>(normal & ~FileH) & theirs & checkMask, Up + 1, Capture);
+
+                if (promoting) {
+                    AddPawnPromotions(moves, Shift<Up>(promoting) & empty & checkMask, Up, false);
+                    AddPawnPromotions(moves, Shift<Up - 1>(promoting & ~FileA) & theirs & checkMask, Up - 1, true);
+                    AddPawnPromotions(moves, Shift<Up + 1>(promoting & ~FileH) & theirs & checkMask, Up + 1, true);
+                }
+            }
+
+            // Pinned pawns, one at a time
+            Bitboard pinnedPawns = pawns & pinned;
+            while (pinnedPawns) {
+                const Square from = PopLowestSquare(pinnedPawns);
+                const Bitboard allowed = Attacks::Line(king, from) & checkMask;
+                const bool promotes = (PromotionRank & SquareBit(from)) != 0;
+
+                const Square one = from + Up;
+                if (!(occupied & SquareBit(one))) {
+                    if (allowed & SquareBit(one)) {
+                        if (promotes) AddPromotions(moves, from, one, false);
+                        else moves.Add(Move(from, one, Quiet));
+                    }
+                    const Square two = one + Up;
+                    if ((StartRank & SquareBit(from)) && !(occupied & SquareBit(two)) && (allowed & SquareBit(two))) {
+                        moves.Add(Move(from, two, DoublePush));
+                    }
+                }
+
+                Bitboard captures = Attacks::PawnAttacks(Us, from) & theirs & allowed;
+                while (captures) {
+                    Square to = PopLowestSquare(captures);
+                    if (promotes) AddPromotions(moves, from, to, true);
+                    else moves.Add(Move(from, to, Capture));
+                }
+            }
+
+            // En passant removes two pawns from a rank at once, which the pin test above does not
+            // cover, so each capture is checked with the resulting occupancy
+            const Square enPassant = position.EnPassantSquare();
+            if (enPassant != NoSquare) {
+                const Square captured = enPassant - Up;
+                Bitboard candidates = Attacks::PawnAttacks(Them, enPassant) & pawns;
+                while (candidates) {
+                    const Square from = PopLowestSquare(candidates);
+                    const Bitboard after = (occupied ^ SquareBit(from) ^ SquareBit(captured)) | SquareBit(enPassant);
+                    const Bitboard attackers = (Attacks::RookAttacks(king, after) & theirRooks)
+                                             | (Attacks::BishopAttacks(king, after) & theirBishops)
+                                             | (Attacks::KnightAttacks(king) & position.Pieces(Them, Knight))
+                                             | (Attacks::PawnAttacks(Us, king) & position.Pieces(Them, Pawn) & ~SquareBit(captured));
+                    if (!attackers) moves.Add(Move(from, enPassant, EnPassant));
+                }
+            }
+
+            // Castling: not out of, through or into check
+            if (!checkers) {
+                const uint8_t rights = position.GetCastlingRights();
+                constexpr uint8_t KingSideRight = Us == White ? WhiteKingSide : BlackKingSide;
+                constexpr uint8_t QueenSideRight = Us == White ? WhiteQueenSide : BlackQueenSide;
+                auto safe = [&](Square square) { return !(position.AttackersTo(square, occupied) & theirs); };
+
+                if ((rights & KingSideRight) && !(occupied & (SquareBit(king + 1) | SquareBit(king + 2)))
+                    && safe(king + 1) && safe(king + 2)) {
+                    moves.Add(Move(king, king + 2, KingCastle));
+                }
+                if ((rights & QueenSideRight) && !(occupied & (SquareBit(king - 1) | SquareBit(king - 2) | SquareBit(king - 3)))
+                    && safe(king - 1) && safe(king - 2)) {
+                    moves.Add(Move(king, king - 2, QueenCastle));
+                }
+            }
+        }
+    }
+
+    void GenerateLegalMoves(const Position& position, MoveList& moves) {
+        moves.Count = 0;
+        if (position.SideToMove() == White) Generate<White>(position, moves);
+        else Generate<Black>(position, moves);
+    }
+
+    Move FindLegalMove(const Position& position, Square from, Square to, PieceType promotion) {
+        MoveList moves;
+        GenerateLegalMoves(position, moves);
+        for (Move move : moves) {
+            if (move.From() != from || move.To() != to) continue;
+            if (move.IsPromotion() && move.Promotion() != promotion) continue;
+            return move;
+        }
+        return Move();
+    }
+
+    uint64_t Perft(Position& position, int depth) {
+        if (depth <= 0) return 1;
+
+        MoveList moves;
+        GenerateLegalMoves(position, moves);
+        if (depth == 1) return moves.Count;     // Bulk counting: the leaves are not made
+
+        uint64_t nodes = 0;
+        for (Move move : moves) {
+            position.MakeMove(move);
+            nodes += Perft(position, depth - 1);
+            position.UnmakeMove(move);
+        }
+        return nodes;
+    }
+};
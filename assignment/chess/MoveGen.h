@@ -0,0 +1,23 @@
+#ifndef MOVEGEN_H_
+#define MOVEGEN_H_
+
+#include <cstdint>
+
+#include "Chess.h"
+#include "Position.h"
+
+namespace Chess {
+
+  // Legal moves of the side to move. Pins and checks are resolved while generating, so no
+  // move has to be made and taken back to test it.
+  void GenerateLegalMoves(const Position& position, MoveList& moves);
+
+  // The legal move from 'from' to 'to', or a null move if there is none. Promotions become
+  // 'promotion' (a queen unless asked otherwise).
+  Move FindLegalMove(const Position& position, Square from, Square to, PieceType promotion = Queen);
+
+  // Number of leaf nodes of the legal move tree 'depth' plies deep.
+  uint64_t Perft(Position& position, int depth);
+};
+
+#endif // MOVEGEN_H_
@@ -0,0 +1,356 @@
+#include "Position.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+
+namespace Chess {
+
+    namespace {
+        // Zobrist keys
+        uint64_t PieceKeys[12][64];
+        uint64_t CastlingKeys[16];
+        uint64_t EnPassantKeys[8];
+        uint64_t SideKey;
+
+        // Castling rights that survive a move from or to each square
+        uint8_t CastlingMasks[64];
+
+        const char PieceChars[] = "PNBRQKpnbrqk";
+
+        void InitKeys() {
+            uint64_t state = 0x9e3779b97f4a7c15ull;
+            auto next = [&state]() {
+                // splitmix64
+                uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                return z ^ (z >> 31);
+            };
+            for (auto& keys : PieceKeys) {
+                for (auto& key : keys) key = next();
+            }
+            // Each right has its own key; a set of rights is the xor of its members
+            uint64_t rightKeys[4] = {next(), next(), next(), next()};
+            for (int rights = 0; rights < 16; rights++) {
+                CastlingKeys[rights] = 0;
+                for (int i = 0; i < 4; i++) {
+                    if (rights & (1 << i)) CastlingKeys[rights] ^= rightKeys[i];
+                }
+            }
+            for (auto& key : EnPassantKeys) key = next();
+            SideKey = next();
+
+            std::memset(CastlingMasks, AllCastling, sizeof(CastlingMasks));
+            CastlingMasks[MakeSquare(0, 0)] &= ~WhiteQueenSide;
+            CastlingMasks[MakeSquare(7, 0)] &= ~WhiteKingSide;
+            CastlingMasks[MakeSquare(4, 0)] &= ~(WhiteKingSide | WhiteQueenSide);
+            CastlingMasks[MakeSquare(0, 7)] &= ~BlackQueenSide;
+            CastlingMasks[MakeSquare(7, 7)] &= ~BlackKingSide;
+            CastlingMasks[MakeSquare(4, 7)] &= ~(BlackKingSide | BlackQueenSide);
+        }
+
+        void Init() {
+            static std::once_flag once;
+            std::call_once(once, []() {
+                Attacks::Init();
+                InitKeys();
+            });
+        }
+
+        Square ParseSquare(const std::string& name) {
+            if (name.size() != 2 || name[0] < 'a' || name[0] > 'h' || name[1] < '1' || name[1] > '8') return NoSquare;
+            return MakeSquare(name[0] - 'a', name[1] - '1');
+        }
+    }
+
+    std::string SquareName(Square square) {
+        return {static_cast<char>('a' + FileOf(square)), static_cast<char>('1' + RankOf(square))};
+    }
+
+    std::string ToUci(Move move) {
+        std::string result = SquareName(move.From()) + SquareName(move.To());
+        if (move.IsPromotion()) result += "nbrq"[move.Promotion() - Knight];
+        return result;
+    }
+
+    Position::Position() {
+        Init();
+        Clear();
+        History.reserve(256);
+        SetFen(StartFen);
+    }
+
+    void Position::Clear() {
+        std::memset(PieceBitboards, 0, sizeof(PieceBitboards));
+        std::memset(ColorBitboards, 0, sizeof(ColorBitboards));
+        for (Piece& piece : Board) piece = NoPiece;
+        Side = White;
+        Fullmove = 1;
+        State = {0, NoSquare, 0, 0, NoPiece};
+        History.clear();
+    }
+
+    bool Position::SetFen(const std::string& fen) {
+        std::istringstream stream(fen);
+        std::string placement, side, castling = "-", enPassant = "-";
+        int halfmove = 0, fullmove = 1;
+        if (!(stream >> placement >> side)) return false;
+        stream >> castling >> enPassant >> halfmove >> fullmove;
+
+        Position parsed(*this);
+        parsed.Clear();
+
+        // Placement, from rank 8 down
+        int file = 0, rank = 7;
+        for (char c : placement) {
+            if (c == '/') {
+                if (file != 8 || rank == 0) return false;
+                file = 0;
+                rank--;
+            } else if (c >= '1' && c <= '8') {
+                file += c - '0';
+                if (file > 8) return false;
+            } else {
+                const char* found = std::strchr(PieceChars, c);
+                if (!found || c == '\0' || file > 7) return false;
+                parsed.PutPiece(static_cast<Piece>(found - PieceChars), MakeSquare(file, rank));
+                file++;
+            }
+        }
+        if (file != 8 || rank != 0) return false;
+        if (PopCount(parsed.Pieces(White, King)) != 1 || PopCount(parsed.Pieces(Black, King)) != 1) return false;
+
+        if (side != "w" && side != "b") return false;
+        parsed.Side = side == "w" ? White : Black;
+
+        if (castling != "-") {
+            for (char c : castling) {
+                switch (c) {
+                    case 'K': parsed.State.Castling |= WhiteKingSide; break;
+                    case 'Q': parsed.State.Castling |= WhiteQueenSide; break;
+                    case 'k': parsed.State.Castling |= BlackKingSide; break;
+                    case 'q': parsed.State.Castling |= BlackQueenSide; break;
+                    default: return false;
+                }
+            }
+        }
+        // Rights whose king or rook is not at home are dropped
+        for (Square square : {MakeSquare(0, 0), MakeSquare(7, 0), MakeSquare(4, 0)}) {
+            if (parsed.Board[square] != (FileOf(square) == 4 ? WhiteKing : WhiteRook)) parsed.State.Castling &= CastlingMasks[square];
+        }
+        for (Square square : {MakeSquare(0, 7), MakeSquare(7, 7), MakeSquare(4, 7)}) {
+            if (parsed.Board[square] != (FileOf(square) == 4 ? BlackKing : BlackRook)) parsed.State.Castling &= CastlingMasks[square];
+        }
+
+        // Only kept when a pawn can take it, like MakeMove does, so equal positions hash equally
+        if (enPassant != "-") {
+            Square square = ParseSquare(enPassant);
+            if (square == NoSquare) return false;
+            const Color them = Opponent(parsed.Side);
+            const bool pushed = RankOf(square) == (parsed.Side == White ? 5 : 2)
+                             && parsed.Board[square] == NoPiece
+                             && parsed.Board[square + (parsed.Side == White ? -8 : 8)] == MakePiece(them, Pawn);
+            if (pushed && (Attacks::PawnAttacks(them, square) & parsed.Pieces(parsed.Side, Pawn))) parsed.State.EnPassant = square;
+        }
+
+        parsed.State.HalfmoveClock = static_cast<uint8_t>(std::min(std::max(halfmove, 0), 255));
+        parsed.Fullmove = std::max(fullmove, 1);
+        parsed.State.Hash = parsed.ComputeHash();
+
+        // The side that just moved must not be in check
+        if (parsed.IsAttacked(parsed.KingSquare(Opponent(parsed.Side)), parsed.Side)) return false;
+
+        *this = parsed;
+        return true;
+    }
+
+    std::string Position::GetFen() const {
+        std::string fen;
+        for (int rank = 7; rank >= 0; rank--) {
+            int empty = 0;
+            for (int file = 0; file < 8; file++) {
+                Piece piece = Board[MakeSquare(file, rank)];
+                if (piece == NoPiece) {
+                    empty++;
+                    continue;
+                }
+                if (empty) fen += static_cast<char>('0' + empty);
+                empty = 0;
+                fen += PieceChars[piece];
+            }
+            if (empty) fen += static_cast<char>('0' + empty);
+            if (rank) fen += '/';
+        }
+
+        fen += Side == White ? " w " : " b ";
+        if (!State.Castling) fen += '-';
+        if (State.Castling & WhiteKingSide) fen += 'K';
+        if (State.Castling & WhiteQueenSide) fen += 'Q';
+        if (State.Castling & BlackKingSide) fen += 'k';
+        if (State.Castling & BlackQueenSide) fen += 'q';
+        fen += ' ';
+        fen += State.EnPassant == NoSquare ? "-" : SquareName(State.EnPassant);
+        fen += ' ' + std::to_string(State.HalfmoveClock) + ' ' + std::to_string(Fullmove);
+        return fen;
+    }
+
+    uint64_t Position::ComputeHash() const {
+        uint64_t hash = 0;
+        for (Square square = 0; square < 64; square++) {
+            if (Board[square] != NoPiece) hash ^= PieceKeys[Board[square]][square];
+        }
+        hash ^= CastlingKeys[State.Castling];
+        if (State.EnPassant != NoSquare) hash ^= EnPassantKeys[FileOf(State.EnPassant)];
+        if (Side == Black) hash ^= SideKey;
+        return hash;
+    }
+
+    Bitboard Position::AttackersTo(Square square, Bitboard occupied) const {
+        const Bitboard rooks = PieceBitboards[WhiteRook] | PieceBitboards[BlackRook] | PieceBitboards[WhiteQueen] | PieceBitboards[BlackQueen];
+        const Bitboard bishops = PieceBitboards[WhiteBishop] | PieceBitboards[BlackBishop] | PieceBitboards[WhiteQueen] | PieceBitboards[BlackQueen];
+        return (Attacks::PawnAttacks(Black, square) & PieceBitboards[WhitePawn])
+             | (Attacks::PawnAttacks(White, square) & PieceBitboards[BlackPawn])
+             | (Attacks::KnightAttacks(square) & (PieceBitboards[WhiteKnight] | PieceBitboards[BlackKnight]))
+             | (Attacks::KingAttacks(square) & (PieceBitboards[WhiteKing] | PieceBitboards[BlackKing]))
+             | (Attacks::RookAttacks(square, occupied) & rooks)
+             | (Attacks::BishopAttacks(square, occupied) & bishops);
+    }
+
+    inline void Position::PutPiece(Piece piece, Square square) {
+        const Bitboard bit = SquareBit(square);
+        PieceBitboards[piece] |= bit;
+        ColorBitboards[ColorOf(piece)] |= bit;
+        Board[square] = piece;
+    }
+
+    inline void Position::RemovePiece(Square square) {
+        const Bitboard bit = SquareBit(square);
+        const Piece piece = Board[square];
+        PieceBitboards[piece] ^= bit;
+        ColorBitboards[ColorOf(piece)] ^= bit;
+        Board[square] = NoPiece;
+    }
+
+    inline void Position::MovePiece(Square from, Square to) {
+        const Bitboard bits = SquareBit(from) | SquareBit(to);
+        const Piece piece = Board[from];
+        PieceBitboards[piece] ^= bits;
+        ColorBitboards[ColorOf(piece)] ^= bits;
+        Board[to] = piece;
+        Board[from] = NoPiece;
+    }
+
+    void Position::MakeMove(Move move) {
+        History.push_back(State);
+
+        const Square from = move.From(), to = move.To();
+        const MoveKind kind = move.Kind();
+        const Color us = Side, them = Opponent(Side);
+        const Piece piece = Board[from];
+
+        uint64_t hash = State.Hash ^ SideKey;
+        if (State.EnPassant != NoSquare) hash ^= EnPassantKeys[FileOf(State.EnPassant)];
+        State.EnPassant = NoSquare;
+        State.HalfmoveClock++;
+        State.Captured = NoPiece;
+
+        if (move.IsCapture()) {
+            const Square square = kind == EnPassant ? to + (us == White ? -8 : 8) : to;
+            State.Captured = Board[square];
+            State.HalfmoveClock = 0;
+            hash ^= PieceKeys[State.Captured][square];
+            RemovePiece(square);
+        }
+
+        hash ^= PieceKeys[piece][from] ^ PieceKeys[piece][to];
+        MovePiece(from, to);
+
+        if (TypeOf(piece) == Pawn) {
+            State.HalfmoveClock = 0;
+            if (kind == DoublePush) {
+                const Square square = (from + to) / 2;
+                if (Attacks::PawnAttacks(us, square) & Pieces(them, Pawn)) {
+                    State.EnPassant = square;
+                    hash ^= EnPassantKeys[FileOf(square)];
+                }
+            } else if (move.IsPromotion()) {
+                const Piece promoted = MakePiece(us, move.Promotion());
+                hash ^= PieceKeys[piece][to] ^ PieceKeys[promoted][to];
+                RemovePiece(to);
+                PutPiece(promoted, to);
+            }
+        } else if (kind == KingCastle || kind == QueenCastle) {
+            const Square rookFrom = kind == KingCastle ? to + 1 : to - 2;
+            const Square rookTo = kind == KingCastle ? to - 1 : to + 1;
+            const Piece rook = Board[rookFrom];
+            hash ^= PieceKeys[rook][rookFrom] ^ PieceKeys[rook][rookTo];
+            MovePiece(rookFrom, rookTo);
+        }
+
+        const uint8_t castling = State.Castling & CastlingMasks[from] & CastlingMasks[to];
+        hash ^= CastlingKeys[State.Castling] ^ CastlingKeys[castling];
+        State.Castling = castling;
+        State.Hash = hash;
+
+        if (us == Black) Fullmove++;
+        Side = them;
+    }
+
+    void Position::UnmakeMove(Move move) {
+        Side = Opponent(Side);
+        const Color us = Side;
+        if (us == Black) Fullmove--;
+
+        const Square from = move.From(), to = move.To();
+        const MoveKind kind = move.Kind();
+
+        if (move.IsPromotion()) {
+            RemovePiece(to);
+            PutPiece(MakePiece(us, Pawn), to);
+        } else if (kind == KingCastle || kind == QueenCastle) {
+            const Square rookFrom = kind == KingCastle ? to + 1 : to - 2;
+            const Square rookTo = kind == KingCastle ? to - 1 : to + 1;
+            MovePiece(rookTo, rookFrom);
+        }
+
+        MovePiece(to, from);
+
+        if (State.Captured != NoPiece) {
+            PutPiece(State.Captured, kind == EnPassant ? to + (us == White ? -8 : 8) : to);
+        }
+
+        State = History.back();
+        History.pop_back();
+    }
+
+    void Position::MakeNullMove() {
+        History.push_back(State);
+
+        State.Hash ^= SideKey;
+        if (State.EnPassant != NoSquare) State.Hash ^= EnPassantKeys[FileOf(State.EnPassant)];
+        State.EnPassant = NoSquare;
+        State.HalfmoveClock = 0;
+        State.Captured = NoPiece;
+        Side = Opponent(Side);
+    }
+
+    void Position::UnmakeNullMove() {
+        Side = Opponent(Side);
+        State = History.back();
+        History.pop_back();
+    }
+
+    bool Position::IsDraw() const {
+        if (State.HalfmoveClock >= 100) return true;
+
+        // Same side to move: every second earlier position, back to the last irreversible move
+        const int count = static_cast<int>(History.size());
+        const int end = std::min<int>(State.HalfmoveClock, count);
+        for (int back = 2; back <= end; back += 2) {
+            if (History[count - back].Hash == State.Hash) return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,82 @@
+#ifndef POSITION_H_
+#define POSITION_H_
+
+#include <string>
+#include <vector>
+
+#include "Attacks.h"
+#include "Chess.h"
+
+namespace Chess {
+
+  // A chess position: one bitboard per piece and per color, plus a square-indexed board for
+  // "what stands here". MakeMove()/UnmakeMove() update it in place and keep the previous
+  // states on a stack, so a search walks the tree on a single Position.
+  class Position {
+  public:
+    static constexpr const char* StartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    Position();                                         // The initial position
+
+    // Forsyth-Edwards Notation. On failure the position is left unchanged.
+    bool SetFen(const std::string& fen);
+    std::string GetFen() const;
+
+    inline Piece PieceOn(Square square) const { return Board[square]; }
+    inline Bitboard Pieces(Color color, PieceType type) const { return PieceBitboards[MakePiece(color, type)]; }
+    inline Bitboard Pieces(Color color) const { return ColorBitboards[color]; }
+    inline Bitboard Occupied() const { return ColorBitboards[White] | ColorBitboards[Black]; }
+    inline Square KingSquare(Color color) const { return LowestSquare(Pieces(color, King)); }
+
+    inline Color SideToMove() const { return Side; }
+    inline uint8_t GetCastlingRights() const { return State.Castling; }
+    inline Square EnPassantSquare() const { return State.EnPassant; }     // NoSquare if none
+    inline int HalfmoveClock() const { return State.HalfmoveClock; }
+    inline int FullmoveNumber() const { return Fullmove; }
+    inline uint64_t Hash() const { return State.Hash; }                   // Zobrist key
+
+    // Pieces of both colors attacking 'square', with the given occupancy
+    Bitboard AttackersTo(Square square, Bitboard occupied) const;
+    inline bool IsAttacked(Square square, Color by) const { return (AttackersTo(square, Occupied()) & Pieces(by)) != 0; }
+    inline bool InCheck() const { return IsAttacked(KingSquare(Side), Opponent(Side)); }
+
+    // The move must be legal (GenerateLegalMoves).
+    void MakeMove(Move move);
+    void UnmakeMove(Move move);
+
+    // Passes the turn, for null-move pruning. Not allowed in check. Repetitions are not
+    // looked for across it.
+    void MakeNullMove();
+    void UnmakeNullMove();
+
+    // Fifty-move rule, or a repetition of an earlier position since the last capture or
+    // pawn move. A single repetition counts, which is what a search wants.
+    bool IsDraw() const;
+
+  private:
+    struct StateInfo {
+      uint64_t Hash;
+      Square EnPassant;
+      uint8_t Castling;
+      uint8_t HalfmoveClock;
+      Piece Captured;                 // By the move that led here
+    };
+
+    void Clear();
+    void PutPiece(Piece piece, Square square);
+    void RemovePiece(Square square);
+    void MovePiece(Square from, Square to);
+    uint64_t ComputeHash() const;
+
+  private:
+    Bitboard PieceBitboards[12];
+    Bitboard ColorBitboards[2];
+    Piece Board[64];
+    Color Side;
+    int Fullmove;
+    StateInfo State;
+    std::vector<StateInfo> History;   // States before each move made
+  };
+};
+
+#endif // POSITION_H_
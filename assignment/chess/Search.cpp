@@ -0,0 +1,351 @@
+#include "Search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+#include "Evaluate.h"
+#include "MoveGen.h"
+
+namespace Chess {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr int Infinity = 32000;
+
+        // Mate scores are stored relative to the node, so they stay right at other plies
+        inline int ScoreToTable(int score, int ply) {
+            return score >= MateBound ? score + ply : score <= -MateBound ? score - ply : score;
+        }
+        inline int ScoreFromTable(int score, int ply) {
+            return score >= MateBound ? score - ply : score <= -MateBound ? score + ply : score;
+        }
+
+        // One search thread. Everything but the table and the stop flag is its own.
+        class Worker {
+        public:
+            Worker(const Position& position, TranspositionTable& table, std::atomic<bool>& stopped,
+                   int id, bool hasDeadline, Clock::time_point deadline)
+              : Pos(position), Table(table), Stopped(stopped), Id(id), HasDeadline(hasDeadline), Deadline(deadline) {}
+
+            void IterativeDeepening(int maxDepth);
+
+            Move BestMove;
+            int BestScore = 0;
+            int CompletedDepth = 0;
+            uint64_t Nodes = 0;
+
+        private:
+            int AlphaBeta(int alpha, int beta, int depth, int ply, bool allowNull);
+            int Quiesce(int alpha, int beta, int ply);
+
+            void ScoreMoves(const MoveList& moves, int* scores, Move tableMove, int ply) const;
+            static void PickNext(MoveList& moves, int* scores, int index);
+
+            // Counts the node; the main thread also watches the clock
+            inline bool ShouldStop() {
+                if ((++Nodes & 1023) == 0 && Id == 0 && HasDeadline && Clock::now() >= Deadline) {
+                    Stopped.store(true, std::memory_order_relaxed);
+                }
+                return Stopped.load(std::memory_order_relaxed);
+            }
+
+            inline bool HasPieces(Color color) const {
+                return (Pos.Pieces(color) & ~Pos.Pieces(color, Pawn) & ~Pos.Pieces(color, King)) != 0;
+            }
+
+        private:
+            Position Pos;
+            TranspositionTable& Table;
+            std::atomic<bool>& Stopped;
+            const int Id;
+            const bool HasDeadline;
+            const Clock::time_point Deadline;
+
+            Move IterationBest;                 // Root move of the running iteration
+            Move Killers[MaxPly][2];            // Quiet moves that cut off at each ply
+            int History[2][64][64] = {};        // Quiet cutoffs by side, origin and destination
+        };
+
+        void Worker::IterativeDeepening(int maxDepth) {
+            // Odd helpers run one iteration ahead, so the threads spread over two depths
+            for (int depth = 1 + (Id & 1); depth <= maxDepth; depth++) {
+                const int score = AlphaBeta(-Infinity, Infinity, depth, 0, false);
+                if (Stopped.load(std::memory_order_relaxed)) break;
+
+                BestMove = IterationBest;
+                BestScore = score;
+                CompletedDepth = depth;
+
+                // A mate found within the full depth will not get any shorter
+                if (std::abs(score) >= MateBound && MateScore - std::abs(score) <= depth) break;
+            }
+        }
+
+        int Worker::AlphaBeta(int alpha, int beta, int depth, int ply, bool allowNull) {
+            const bool pvNode = beta - alpha > 1;
+            const bool root = ply == 0;
+
+            if (!root) {
+                if (Pos.IsDraw()) return 0;
+                if (ply >= MaxPly - 1) return Evaluate(Pos);
+
+                // No line from here can beat a shorter mate already found
+                alpha = std::max(alpha, -MateScore + ply);
+                beta = std::min(beta, MateScore - ply - 1);
+                if (alpha >= beta) return alpha;
+            }
+
+            const bool inCheck = Pos.InCheck();
+            if (inCheck) depth++;                                   // Check extension
+            if (depth <= 0) return Quiesce(alpha, beta, ply);
+
+            if (ShouldStop()) return 0;
+
+            Move tableMove;
+            TranspositionTable::Entry entry;
+            if (Table.Probe(Pos.Hash(), entry)) {
+                tableMove = entry.BestMove;
+                if (!pvNode && entry.Depth >= depth) {
+                    const int score = ScoreFromTable(entry.Score, ply);
+                    if (entry.Type == TranspositionTable::ExactBound
+                        || (entry.Type == TranspositionTable::LowerBound && score >= beta)
+                        || (entry.Type == TranspositionTable::UpperBound && score <= alpha)) {
+                        return score;
+                    }
+                }
+            }
+
+            // Null move: if passing still fails high, a real move will too. Not without pieces,
+            // where passing may be the only thing that would help (zugzwang).
+            if (allowNull && !pvNode && !inCheck && depth >= 3 && HasPieces(Pos.SideToMove()) && Evaluate(Pos) >= beta) {
+                const int reduction = 2 + depth / 6;
+                Pos.MakeNullMove();
+                const int score = -AlphaBeta(-beta, -beta + 1, depth - 1 - reduction, ply + 1, false);
+                Pos.UnmakeNullMove();
+                if (Stopped.load(std::memory_order_relaxed)) return 0;
+                if (score >= beta) return score >= MateBound ? beta : score;
+            }
+
+            MoveList moves;
+            GenerateLegalMoves(Pos, moves);
+            if (moves.Count == 0) return inCheck ? -MateScore + ply : 0;
+
+            int scores[256];
+            ScoreMoves(moves, scores, tableMove, ply);
+
+            const int originalAlpha = alpha;
+            const Color us = Pos.SideToMove();
+            int bestScore = -Infinity;
+            Move bestMove;
+
+            for (int i = 0; i < moves.Count; i++) {
+                PickNext(moves, scores, i);
+                const Move move = moves.Moves[i];
+                const bool quiet = !move.IsCapture() && !move.IsPromotion();
+
+                Pos.MakeMove(move);
+                int score;
+                if (i == 0) {
+                    score = -AlphaBeta(-beta, -alpha, depth - 1, ply + 1, true);
+                } else {
+                    // Late quiet moves rarely matter: search them shallower, and again at full
+                    // depth only if they turn out to
+                    int reduction = 0;
+                    if (depth >= 3 && i >= 3 && quiet && !inCheck && move != Killers[ply][0] && move != Killers[ply][1]) {
+                        reduction = (i >= 8 && depth >= 6) ? 2 : 1;
+                    }
+                    score = -AlphaBeta(-alpha - 1, -alpha, depth - 1 - reduction, ply + 1, true);
+                    if (score > alpha && reduction) score = -AlphaBeta(-alpha - 1, -alpha, depth - 1, ply + 1, true);
+                    if (score > alpha && score < beta) score = -AlphaBeta(-beta, -alpha, depth - 1, ply + 1, true);
+                }
+                Pos.UnmakeMove(move);
+
+                if (Stopped.load(std::memory_order_relaxed)) return 0;
+
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestMove = move;
+                    if (root) IterationBest = move;
+
+                    if (score > alpha) {
+                        alpha = score;
+                        if (alpha >= beta) {
+                            if (quiet) {
+                                if (Killers[ply][0] != move) {
+                                    Killers[ply][1] = Killers[ply][0];
+                                    Killers[ply][0] = move;
+                                }
+                                int& history = History[us][move.From()][move.To()];
+                                history = std::min(history + depth * depth, 1 << 18);
+                            }
+                            break;
+                        }
+                    }
+                }
+            }
+
+            const TranspositionTable::Bound type = bestScore >= beta ? TranspositionTable::LowerBound
+                                                 : bestScore > originalAlpha ? TranspositionTable::ExactBound
+                                                 : TranspositionTable::UpperBound;
+            Table.Store(Pos.Hash(), bestMove, ScoreToTable(bestScore, ply), depth, type);
+            return bestScore;
+        }
+
+        // Captures (and promotions) only, until the position is quiet. In check, every
+        // evasion is searched, since standing pat is not an option.
+        int Worker::Quiesce(int alpha, int beta, int ply) {
+            if (ShouldStop()) return 0;
+            if (ply >= MaxPly - 1) return Evaluate(Pos);
+
+            const bool inCheck = Pos.InCheck();
+            int bestScore = -Infinity;
+            if (!inCheck) {
+                bestScore = Evaluate(Pos);
+                if (bestScore >= beta) return bestScore;
+                alpha = std::max(alpha, bestScore);
+            }
+
+            MoveList moves;
+            GenerateLegalMoves(Pos, moves);
+            if (moves.Count == 0) return inCheck ? -MateScore + ply : 0;
+
+            if (!inCheck) {
+                int count = 0;
+                for (Move move : moves) {
+                    if (move.IsCapture() || move.Kind() == PromoteQueen) moves.Moves[count++] = move;
+                }
+                moves.Count = count;
+            }
+
+            int scores[256];
+            ScoreMoves(moves, scores, Move(), ply);
+
+            for (int i = 0; i < moves.Count; i++) {
+                PickNext(moves, scores, i);
+                Pos.MakeMove(moves.Moves[i]);
+                const int score = -Quiesce(-beta, -alpha, ply + 1);
+                Pos.UnmakeMove(moves.Moves[i]);
+
+                if (Stopped.load(std::memory_order_relaxed)) return 0;
+
+                if (score > bestScore) {
+                    bestScore = score;
+                    if (score > alpha) {
+                        alpha = score;
+                        if (alpha >= beta) break;
+                    }
+                }
+            }
+            return bestScore;
+        }
+
+        // Table move, then captures by most valuable victim and least valuable attacker,
+        // promotions, killers, and the remaining quiet moves by history
+        void Worker::ScoreMoves(const MoveList& moves, int* scores, Move tableMove, int ply) const {
+            const Color us = Pos.SideToMove();
+            for (int i = 0; i < moves.Count; i++) {
+                const Move move = moves.Moves[i];
+                int score;
+                if (move == tableMove) {
+                    score = 1 << 30;
+                } else if (move.IsCapture()) {
+                    const int victim = move.Kind() == EnPassant ? Pawn : TypeOf(Pos.PieceOn(move.To()));
+                    const int attacker = TypeOf(Pos.PieceOn(move.From()));
+                    score = (1 << 24) + victim * 16 - attacker + (move.IsPromotion() ? move.Promotion() * 64 : 0);
+                } else if (move.IsPromotion()) {
+                    score = (1 << 23) + move.Promotion();
+                } else if (move == Killers[ply][0]) {
+                    score = (1 << 22) + 1;
+                } else if (move == Killers[ply][1]) {
+                    score = 1 << 22;
+                } else {
+                    score = History[us][move.From()][move.To()];
+                }
+                scores[i] = score;
+            }
+        }
+
+        // Selection sort, one step at a time: most nodes cut off after the first few moves
+        void Worker::PickNext(MoveList& moves, int* scores, int index) {
+            int best = index;
+            for (int i = index + 1; i < moves.Count; i++) {
+                if (scores[i] > scores[best]) best = i;
+            }
+            std::swap(moves.Moves[index], moves.Moves[best]);
+            std::swap(scores[index], scores[best]);
+        }
+    }
+
+    Search::Search(size_t hashMegabytes) : Table(hashMegabytes) {}
+
+    Search::~Search() {
+        Stop();
+        if (Thread.joinable()) Thread.join();
+    }
+
+    void Search::Start(const Position& position, const SearchLimits& limits) {
+        Stop();
+        if (Thread.joinable()) Thread.join();
+
+        Stopped.store(false, std::memory_order_relaxed);
+        Running.store(true, std::memory_order_release);
+        Thread = std::thread(&Search::Think, this, position, limits);
+    }
+
+    SearchResult Search::Wait() {
+        if (Thread.joinable()) Thread.join();
+        return Result;
+    }
+
+    SearchResult Search::Run(const Position& position, const SearchLimits& limits) {
+        Start(position, limits);
+        return Wait();
+    }
+
+    void Search::Think(Position position, SearchLimits limits) {
+        const Clock::time_point start = Clock::now();
+        const Clock::time_point deadline = start + std::chrono::milliseconds(limits.TimeMs);
+        const int maxDepth = std::min(std::max(limits.Depth, 1), MaxPly - 8);
+
+        unsigned int threads = limits.Threads ? limits.Threads : std::thread::hardware_concurrency();
+        threads = std::max(threads, 1u);
+
+        Table.NewSearch();
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (unsigned int i = 0; i < threads; i++) {
+            workers.push_back(std::make_unique<Worker>(position, Table, Stopped, i, limits.TimeMs > 0, deadline));
+        }
+
+        std::vector<std::thread> helpers;
+        for (unsigned int i = 1; i < threads; i++) {
+            helpers.emplace_back([&workers, i, maxDepth]() { workers[i]->IterativeDeepening(maxDepth); });
+        }
+
+        // The main thread decides when the search is over
+        Worker& main = *workers[0];
+        main.IterativeDeepening(maxDepth);
+        Stopped.store(true, std::memory_order_relaxed);
+        for (std::thread& helper : helpers) helper.join();
+
+        SearchResult result;
+        result.BestMove = main.BestMove;
+        result.Score = main.BestScore;
+        result.Depth = main.CompletedDepth;
+        for (auto& worker : workers) result.Nodes += worker->Nodes;
+        result.Seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // Stopped before the first iteration finished: any legal move beats none
+        if (result.BestMove.IsNull()) {
+            MoveList moves;
+            GenerateLegalMoves(position, moves);
+            if (moves.Count) result.BestMove = moves.Moves[0];
+        }
+
+        Result = result;
+        Running.store(false, std::memory_order_release);
+    }
+};
@@ -0,0 +1,75 @@
+#ifndef SEARCH_H_
+#define SEARCH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Chess.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+
+namespace Chess {
+
+  struct SearchLimits {
+    int Depth = 64;                 // Deepest iteration
+    int TimeMs = 0;                 // Wall time, 0 for none
+    unsigned int Threads = 0;       // 0 for every hardware thread
+  };
+
+  struct SearchResult {
+    Move BestMove;                  // Null if the side to move has no legal move
+    int Score = 0;                  // Centipawns for the side to move, or a mate score
+    int Depth = 0;                  // Deepest iteration completed
+    uint64_t Nodes = 0;             // Summed over the threads
+    double Seconds = 0.0;
+  };
+
+  // Scores beyond this are mates: MateScore - plies to mate
+  constexpr int MateScore = 31000;
+  constexpr int MaxPly = 128;
+  constexpr int MateBound = MateScore - MaxPly;
+
+  // Iterative deepening alpha-beta (principal variation search) on a background thread.
+  //
+  // Lazy SMP: every thread searches the same root with its own position and move ordering
+  // state, and they share the transposition table, so each thread mostly finds the work the
+  // others have already done. Helper threads start some iterations deeper to spread out.
+  // The main thread's result is reported; the search ends when it finishes or time runs out.
+  class Search {
+  public:
+    explicit Search(size_t hashMegabytes = 64);
+    ~Search();                                      // Stops a running search
+
+    Search(const Search&) = delete;
+    void operator=(const Search&) = delete;
+
+    // Starts searching a copy of 'position' and returns at once.
+    void Start(const Position& position, const SearchLimits& limits);
+    // Asks a running search to finish; its result is the last completed iteration.
+    void Stop() { Stopped.store(true, std::memory_order_relaxed); }
+    // False once the search has finished, so Wait() will not block.
+    bool IsRunning() const { return Running.load(std::memory_order_acquire); }
+    // Blocks until the search has finished and returns its result.
+    SearchResult Wait();
+
+    // Start() and Wait()
+    SearchResult Run(const Position& position, const SearchLimits& limits);
+
+    // Forget earlier searches. Not while searching.
+    void ClearHash() { Table.Clear(); }
+
+  private:
+    void Think(Position position, SearchLimits limits);
+
+  private:
+    TranspositionTable Table;
+    std::thread Thread;
+    std::atomic<bool> Stopped{false};
+    std::atomic<bool> Running{false};
+    SearchResult Result;
+  };
+};
+
+#endif // SEARCH_H_
@@ -0,0 +1,83 @@
+#include "TranspositionTable.h"
+
+#include <algorithm>
+
+namespace Chess {
+
+    TranspositionTable::TranspositionTable(size_t megabytes) {
+        Resize(megabytes);
+    }
+
+    void TranspositionTable::Resize(size_t megabytes) {
+        // Largest power of two of buckets that fits
+        const size_t bucketBytes = sizeof(Slot) * BucketSize;
+        size_t buckets = 1;
+        while (buckets * 2 * bucketBytes <= megabytes * 1024 * 1024) buckets *= 2;
+
+        Slots.reset(new Slot[buckets * BucketSize]);
+        BucketMask = buckets - 1;
+        Clear();
+    }
+
+    void TranspositionTable::Clear() {
+        const size_t count = (BucketMask + 1) * BucketSize;
+        for (size_t i = 0; i < count; i++) {
+            Slots[i].Check.store(0, std::memory_order_relaxed);
+            Slots[i].Data.store(0, std::memory_order_relaxed);
+        }
+        Generation = 0;
+    }
+
+    bool TranspositionTable::Probe(uint64_t key, Entry& entry) const {
+        const Slot* bucket = BucketOf(key);
+        for (size_t i = 0; i < BucketSize; i++) {
+            const uint64_t data = bucket[i].Data.load(std::memory_order_relaxed);
+            if ((bucket[i].Check.load(std::memory_order_relaxed) ^ data) != key || !data) continue;
+
+            entry.BestMove.Data = uint16_t(data);
+            entry.Score = int16_t(uint16_t(data >> 16));
+            entry.Depth = DepthOf(data);
+            entry.Type = static_cast<Bound>((data >> 40) & 3);
+            return true;
+        }
+        return false;
+    }
+
+    void TranspositionTable::Store(uint64_t key, Move bestMove, int score, int depth, Bound type) {
+        Slot* bucket = BucketOf(key);
+
+        // The key's own slot, else the one worth least: old searches first, then shallow ones
+        Slot* replace = bucket;
+        int worst = 1 << 30;
+        for (size_t i = 0; i < BucketSize; i++) {
+            const uint64_t data = bucket[i].Data.load(std::memory_order_relaxed);
+            if ((bucket[i].Check.load(std::memory_order_relaxed) ^ data) == key) {
+                // A shallower result does not overwrite a deeper one, but keep a move if none is known
+                if (type != ExactBound && depth < DepthOf(data) - 2) return;
+                if (bestMove.IsNull()) bestMove.Data = uint16_t(data);
+                replace = &bucket[i];
+                break;
+            }
+            const int age = (Generation - GenerationOf(data)) & GenerationMask;
+            const int worth = DepthOf(data) - 8 * age;
+            if (worth < worst) {
+                worst = worth;
+                replace = &bucket[i];
+            }
+        }
+
+        const uint64_t data = Pack(bestMove, score, depth < 0 ? 0 : depth, type, Generation);
+        replace->Check.store(key ^ data, std::memory_order_relaxed);
+        replace->Data.store(data, std::memory_order_relaxed);
+    }
+
+    int TranspositionTable::Usage() const {
+        const size_t samples = std::min<size_t>(1000, (BucketMask + 1) * BucketSize);
+        int used = 0;
+        for (size_t i = 0; i < samples; i++) {
+            const uint64_t data = Slots[i].Data.load(std::memory_order_relaxed);
+            if (data && GenerationOf(data) == Generation) used++;
+        }
+        return static_cast<int>(used * 1000 / samples);
+    }
+};
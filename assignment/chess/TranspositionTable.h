@@ -0,0 +1,74 @@
+#ifndef TRANSPOSITIONTABLE_H_
+#define TRANSPOSITIONTABLE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Chess.h"
+
+namespace Chess {
+
+  // Search results by Zobrist key, shared by all search threads without locks.
+  //
+  // Each slot is two 64-bit words: the packed entry, and the key xor the entry. A reader
+  // only accepts a slot whose words xor back to its key, so a slot torn by two threads
+  // writing at once reads as a miss rather than as a wrong entry.
+  class TranspositionTable {
+  public:
+    enum Bound : uint8_t { NoBound, UpperBound, LowerBound, ExactBound };
+
+    struct Entry {
+      Move BestMove;
+      int Score = 0;
+      int Depth = 0;
+      Bound Type = NoBound;
+    };
+
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    void operator=(const TranspositionTable&) = delete;
+
+    // Resizing and clearing must not overlap a search.
+    void Resize(size_t megabytes);
+    void Clear();
+
+    // Starts a new search: entries of earlier searches are replaced first.
+    void NewSearch() { Generation = (Generation + 1) & GenerationMask; }
+
+    bool Probe(uint64_t key, Entry& entry) const;
+    void Store(uint64_t key, Move bestMove, int score, int depth, Bound type);
+
+    // Per mille of slots used by the current search (sampled)
+    int Usage() const;
+
+  private:
+    struct Slot {
+      std::atomic<uint64_t> Check;      // Key ^ Data
+      std::atomic<uint64_t> Data;
+    };
+
+    // Slots sharing a cache line; a key may use any of them
+    static constexpr size_t BucketSize = 4;
+    static constexpr uint8_t GenerationMask = 63;
+
+    // Data: move (16) | score (16) | depth (8) | bound (2) | generation (6)
+    static inline uint64_t Pack(Move move, int score, int depth, Bound type, uint8_t generation) {
+      return move.Data | (uint64_t(uint16_t(int16_t(score))) << 16) | (uint64_t(uint8_t(depth)) << 32)
+           | (uint64_t(type) << 40) | (uint64_t(generation) << 42);
+    }
+    static inline int DepthOf(uint64_t data) { return uint8_t(data >> 32); }
+    static inline uint8_t GenerationOf(uint64_t data) { return uint8_t(data >> 42) & GenerationMask; }
+
+    inline Slot* BucketOf(uint64_t key) const { return &Slots[(key & BucketMask) * BucketSize]; }
+
+  private:
+    std::unique_ptr<Slot[]> Slots;
+    size_t BucketMask = 0;            // Bucket count - 1 (a power of two)
+    uint8_t Generation = 0;
+  };
+};
+
+#endif // TRANSPOSITIONTABLE_H_
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "MoveGen.h"
+#include "Position.h"
+
+// Move generator check and benchmark.
+//
+//   perft [depth] [fen]    leaf count of one position, split by root move
+//   perft bench [depth]    the standard test positions against their known counts
+
+namespace {
+    struct TestPosition {
+        const char* Name;
+        const char* Fen;
+        uint64_t Counts[6];     // Depths 1 to 6, 0 where not known
+    };
+
+    const TestPosition TestPositions[] = {
+        {"initial", Chess::Position::StartFen, {20, 400, 8902, 197281, 4865609, 119060324}},
+        {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", {48, 2039, 97862, 4085603, 193690690, 0}},
+        {"position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", {14, 191, 2812, 43238, 674624, 11030083}},
+        {"position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", {6, 264, 9467, 422333, 15833292, 0}},
+        {"position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", {44, 1486, 62379, 2103487, 89941194, 0}},
+        {"position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", {46, 2079, 89890, 3894594, 164075551, 0}},
+    };
+
+    double Seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void PrintSpeed(uint64_t nodes, double seconds) {
+        printf("%llu nodes in %.3f s, %.1f Mnps\n", static_cast<unsigned long long>(nodes), seconds,
+               seconds > 0.0 ? nodes / seconds / 1e6 : 0.0);
+    }
+
+    int Divide(Chess::Position& position, int depth) {
+        auto start = std::chrono::steady_clock::now();
+
+        Chess::MoveList moves;
+        Chess::GenerateLegalMoves(position, moves);
+        uint64_t total = 0;
+        for (Chess::Move move : moves) {
+            position.MakeMove(move);
+            uint64_t nodes = Chess::Perft(position, depth - 1);
+            position.UnmakeMove(move);
+            printf("%s: %llu\n", Chess::ToUci(move).c_str(), static_cast<unsigned long long>(nodes));
+            total += nodes;
+        }
+
+        printf("\n");
+        PrintSpeed(total, Seconds(start));
+        return 0;
+    }
+
+    int Bench(int maxDepth) {
+        uint64_t totalNodes = 0;
+        int failures = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const TestPosition& test : TestPositions) {
+            Chess::Position position;
+            position.SetFen(test.Fen);
+
+            for (int depth = 1; depth <= maxDepth && depth <= 6; depth++) {
+                if (test.Counts[depth - 1] == 0) break;
+
+                uint64_t nodes = Chess::Perft(position, depth);
+                totalNodes += nodes;
+                bool ok = nodes == test.Counts[depth - 1];
+                if (!ok) failures++;
+                printf("%-10s depth %d: %12llu %s\n", test.Name, depth, static_cast<unsigned long long>(nodes),
+                       ok ? "ok" : "WRONG");
+            }
+        }
+
+        printf("\n");
+        PrintSpeed(totalNodes, Seconds(start));
+        if (failures) printf("%d wrong counts\n", failures);
+        return failures ? 1 : 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return Bench(argc > 2 ? atoi(argv[2]) : 5);
+    }
+
+    int depth = argc > 1 ? atoi(argv[1]) : 5;
+    if (depth < 1) {
+        printf("usage: perft [depth] [fen] | perft bench [depth]\n");
+        return 1;
+    }
+
+    Chess::Position position;
+    if (argc > 2) {
+        // The FEN may arrive as one argument or split on its spaces
+        std::string fen = argv[2];
+        for (int i = 3; i < argc; i++) fen += std::string(" ") + argv[i];
+        if (!position.SetFen(fen)) {
+            printf("invalid FEN: %s\n", fen.c_str());
+            return 1;
+        }
+    }
+
+    return Divide(position, depth);
+}
@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "Position.h"
+#include "Search.h"
+
+// Search benchmark: fixed-depth searches of a few positions with 1, 2, 4, ... threads,
+// reporting time, nodes per second and the speedup over one thread.
+//
+//   searchbench [depth] [max threads]
+
+namespace {
+    const char* BenchPositions[] = {
+        Chess::Position::StartFen,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+}
+
+int main(int argc, char** argv) {
+    const int depth = argc > 1 ? atoi(argv[1]) : 9;
+    unsigned int maxThreads = argc > 2 ? static_cast<unsigned int>(atoi(argv[2])) : std::thread::hardware_concurrency();
+    if (depth < 1 || maxThreads < 1) {
+        printf("usage: searchbench [depth] [max threads]\n");
+        return 1;
+    }
+
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    printf("depth %d, %u hardware threads\n\n", depth, std::thread::hardware_concurrency());
+    printf("threads      time (s)         nodes     Mnps   speedup\n");
+
+    Chess::Search search(64);
+    double singleThreadSeconds = 0.0;
+    for (unsigned int threads : threadCounts) {
+        double seconds = 0.0;
+        uint64_t nodes = 0;
+
+        for (const char* fen : BenchPositions) {
+            Chess::Position position;
+            position.SetFen(fen);
+
+            // Every run starts from an empty table
+            search.ClearHash();
+            Chess::SearchLimits limits;
+            limits.Depth = depth;
+            limits.Threads = threads;
+            Chess::SearchResult result = search.Run(position, limits);
+
+            seconds += result.Seconds;
+            nodes += result.Nodes;
+        }
+
+        if (threads == 1) singleThreadSeconds = seconds;
+        printf("%7u %13.3f %13llu %8.2f %9.2f\n", threads, seconds, static_cast<unsigned long long>(nodes),
+               nodes / seconds / 1e6, singleThreadSeconds / seconds);
+    }
+
+    return 0;
+}
@@ -5,22 +5,14 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include "tiny_obj_loader.h"
+#include "MeshLoader.h"
+#include "ClusterCuller.h"
 
 #include <iostream>
 #include <set>
 #include <cmath>
-
-//------------------------------------------------------------------------------
-// VERTEX STRUCT
-//------------------------------------------------------------------------------
-struct Vertex
-{
-    glm::vec3 location;
-    glm::vec3 normals;
-    glm::vec2 texCoords;
-};
-
+#include <cstring>
+#include <string>
 
 // -----------------------------------------------------------------------------
 // FUNCTION PROTOTYPES
@@ -30,11 +22,11 @@ GLuint CompileShader(const std::string& vertexShader,
 
 GLuint CreateSquare();
 
-GLuint LoadModel(const std::string, int& size);
+std::shared_ptr<Framework::VertexArray> LoadModel(const std::string, std::unique_ptr<Framework::ClusterCuller>&);
 
-void Camera(const float, const GLuint);
+glm::mat4 Camera(const float, const GLuint, glm::mat4&);
 
-void Transform(const float, const GLuint);
+glm::mat4 Transform(const float, const GLuint);
 
 void Light(const float, const GLuint);
 
@@ -99,12 +91,24 @@ int main()
     glEnable(GL_DEPTH_TEST);
 
 
-    int size = 0;
-    auto potVAO = LoadModel(std::string(MODELS_DIR), size);
+    std::unique_ptr<Framework::ClusterCuller> culler;
+    auto pot = LoadModel(std::string(MODELS_DIR), culler);
+    if (!pot)
+    {
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
     auto ShaderProgram = CompileShader(VertexShaderSrc, directionalLightFragmentShaderSrc);
     ///auto ShaderProgram = CompileShader(VertexShaderSrc, pointLightFragmentShaderSrc); //Feel free to test with pointlights as well by un-commenting this.
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
+    //The teacup is drawn in meshlets, and the ones outside the view or facing away from the camera are skipped.
+    //By default a compute shader decides which to draw; press C to let the CPU decide instead.
+    bool cullOnGpu = true;
+    bool cullKeyDown = false;
+    std::cout << "Culling meshlets on the GPU (C switches to the CPU)" << std::endl;
+
     double currentTime = 0.0;
     glfwSetTime(0.0);
     while (!glfwWindowShouldClose(window))
@@ -119,12 +123,27 @@ int main()
         // Draw SQUARE
         auto vertexColorLocation = glGetUniformLocation(ShaderProgram, "u_Color");
         glUseProgram(ShaderProgram);
-        glBindVertexArray(potVAO);
+        pot->Bind();
         glUniform4f(vertexColorLocation, 0.4f, 0.4f, 0.45f, 1.0f);
-        Camera(currentTime, ShaderProgram);
-        Transform(currentTime, ShaderProgram);
+        glm::mat4 view;
+        glm::mat4 viewProjection = Camera(currentTime, ShaderProgram, view);
+        glm::mat4 model = Transform(currentTime, ShaderProgram);
         Light(currentTime, ShaderProgram);
-        glDrawArrays(GL_TRIANGLES, 0, size);
+
+        //The culler works in model space, so it needs the camera position as the teacup sees it.
+        //The camera sits at the origin of view space, which the inverse view matrix moves to the world.
+        glm::vec3 cameraPosition = glm::vec3(glm::inverse(model) * glm::inverse(view)[3]);
+        if (cullOnGpu)
+        {
+            //The compute shader uses its own program, so ours has to be bound again before drawing
+            culler->CullOnGpu(viewProjection * model, cameraPosition);
+            glUseProgram(ShaderProgram);
+            culler->DrawIndirect();
+        }
+        else
+        {
+            culler->Draw(culler->Cull(viewProjection * model, cameraPosition));
+        }
 
         glfwSwapBuffers(window);
 
@@ -132,12 +151,33 @@ int main()
         {
             break;
         }
+
+        //Switch on the key press only, not on every frame the key is held
+        bool cullKey = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
+        if (cullKey && !cullKeyDown)
+        {
+            cullOnGpu = !cullOnGpu;
+
+            //Both paths should keep the same meshlets for this frame. Reading the GPU's draw commands back
+            //stalls until it is done, which is fine once per key press.
+            std::vector<uint32_t> cpuVisible = culler->Cull(viewProjection * model, cameraPosition);
+            culler->CullOnGpu(viewProjection * model, cameraPosition);
+            std::vector<uint32_t> gpuVisible = culler->ReadGpuVisible();
+            glUseProgram(ShaderProgram);
+            std::cout << "Culling meshlets on the " << (cullOnGpu ? "GPU" : "CPU") << ": "
+                      << cpuVisible.size() << " of " << culler->GetMeshletCount() << " visible, the GPU "
+                      << (gpuVisible == cpuVisible ? "agrees" : "keeps " + std::to_string(gpuVisible.size()) + " (MISMATCH)")
+                      << std::endl;
+        }
+        cullKeyDown = cullKey;
     }
 
     glUseProgram(0);
     glDeleteProgram(ShaderProgram);
 
-    CleanVAO(potVAO);
+    //The buffers must be deleted while the OpenGL context still exists
+    culler.reset();
+    pot.reset();
 
     glfwTerminate();
 
@@ -267,86 +307,49 @@ void CleanVAO(GLuint& vao)
 // -----------------------------------------------------------------------------
 // Code handling the camera
 // -----------------------------------------------------------------------------
-GLuint LoadModel(const std::string path, int& size)
+std::shared_ptr<Framework::VertexArray> LoadModel(const std::string path, std::unique_ptr<Framework::ClusterCuller>& culler)
 {
+    //The MeshLoader parses the obj file with ParseOBJ (in parallel chunks), merges the vertices that neighbouring triangles share
+    //and packs normals and texture coordinates into fewer bytes. The result is saved in a cache file next to the
+    //model (teacup.obj.fwmesh), so later runs skip all of that and upload the cached data directly.
+    double start = glfwGetTime();
+    Framework::MeshLoader::MeshData data;
+    if (!Framework::MeshLoader::LoadData(path + "/teacup.obj", data))
+    {
+        return nullptr;
+    }
 
-    //We create a vector of Vertex structs. OpenGL can understand these, and so will accept them as input.
-    std::vector<Vertex> vertices;
-
-    //Some variables that we are going to use to store data from tinyObj
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials; //This one goes unused for now, seeing as we don't need materials for this model.
-    
-    //Some variables incase there is something wrong with our obj file
-    std::string warn;
-    std::string err;
+    std::cout << "Loaded " << data.IndexCount / 3 << " triangles, " << data.VertexCount << " vertices of "
+              << data.Layout.GetStride() << " bytes " << (data.FromCache ? "from the cache" : "from the obj file")
+              << " in " << (glfwGetTime() - start) * 1000.0 << " ms" << std::endl;
 
-    //We use tinobj to load our models. Feel free to find other .obj files and see if you can load them.
-    tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, (path + "/teacup.obj").c_str(), path.c_str());
+    //Position, normal and texture coordinates end up in attribute locations 0, 1 and 2, like in our shader
+    auto vertexArray = Framework::MeshLoader::Upload(data);
 
-    if (!warn.empty()) {
-        std::cout << warn << std::endl;
-    }
-
-    if (!err.empty()) {
-        std::cerr << err << std::endl;
+    //Split the triangles into meshlets of up to 124 triangles. The positions are the first three floats of every vertex.
+    const char* vertices = static_cast<const char*>(data.Vertices);
+    std::vector<glm::vec3> positions(data.VertexCount);
+    for (size_t i = 0; i < data.VertexCount; i++)
+    {
+        std::memcpy(&positions[i], vertices + i * data.Layout.GetStride(), sizeof(glm::vec3));
     }
-
-    //For each shape defined in the obj file
-    for (auto shape : shapes)
+    std::vector<uint32_t> indices(data.IndexCount);
+    for (size_t i = 0; i < data.IndexCount; i++)
     {
-        //We find each mesh
-        for (auto meshIndex : shape.mesh.indices)
-        {
-            //And store the data for each vertice, including normals
-            glm::vec3 vertice = {
-                attrib.vertices[meshIndex.vertex_index * 3],
-                attrib.vertices[(meshIndex.vertex_index * 3) + 1],
-                attrib.vertices[(meshIndex.vertex_index * 3) + 2]
-            };
-            glm::vec3 normal = {
-                attrib.normals[meshIndex.normal_index * 3],
-                attrib.normals[(meshIndex.normal_index * 3) + 1],
-                attrib.normals[(meshIndex.normal_index * 3) + 2]
-            };
-            glm::vec2 textureCoordinate = {                         //These go unnused, but if you want textures, you will need them.
-                attrib.texcoords[meshIndex.texcoord_index * 2],
-                attrib.texcoords[(meshIndex.texcoord_index * 2) + 1]
-            };
-
-            vertices.push_back({ vertice, normal, textureCoordinate }); //We add our new vertice struct to our vector
-
-        }
+        indices[i] = data.IndexType == GL_UNSIGNED_SHORT ? static_cast<const GLushort*>(data.Indices)[i]
+                                                         : static_cast<const GLuint*>(data.Indices)[i];
     }
+    auto meshlets = Framework::MeshOptimizer::BuildMeshlets(indices.data(), indices.size(), positions.data(), positions.size());
 
-    GLuint VAO;
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    //The culler's index buffer has the triangles of every meshlet in one piece, and replaces the mesh's own
+    culler = std::make_unique<Framework::ClusterCuller>(meshlets);
+    vertexArray->SetIndexBuffer(culler->GetIndexBuffer());
+    std::cout << "Split into " << culler->GetMeshletCount() << " meshlets" << std::endl;
 
-    GLuint VBO;
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-    //As you can see, OpenGL will accept a vector of structs as a valid input here
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), &vertices[0], GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 8, nullptr);
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 8, (void*)(sizeof(float) * 3));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 8, (void*)(sizeof(float) * 6));
-    
-    //This will be needed later to specify how much we need to draw. Look at the main loop to find this variable again.
-    size = vertices.size();
-
-    return VAO;
+    return vertexArray;
 }
 
-void Transform(const float time, const GLuint shaderprogram)
+glm::mat4 Transform(const float time, const GLuint shaderprogram)
 {
 
     //Presentation below purely for ease of viewing individual components of calculation, and not at all necessary.
@@ -371,13 +374,16 @@ void Transform(const float time, const GLuint shaderprogram)
     //Send data from matrices to uniform
     //                 Location of uniform  How many matrices we are sending    value_ptr to our transformation matrix
     glUniformMatrix4fv(transformationmat, 1, false, glm::value_ptr(transformation));
+
+    return transformation;
 }
 
 
 // -----------------------------------------------------------------------------
 // Code handling the camera
 // -----------------------------------------------------------------------------
-void Camera(const float time, const GLuint shaderprogram)
+//Returns projection * view, and the view matrix on its own in 'view'
+glm::mat4 Camera(const float time, const GLuint shaderprogram, glm::mat4& view)
 {
 
     //Matrix which helps project our 3D objects onto a 2D image. Not as relevant in 2D projects
@@ -386,7 +392,7 @@ void Camera(const float time, const GLuint shaderprogram)
 
     //Matrix which defines where in the scene our camera is
     //                           Position of camera     Direction camera is looking     Vector pointing upwards
-    glm::mat4 view = glm::lookAt(glm::vec3(0.f, 0.f, -1.f), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+    view = glm::lookAt(glm::vec3(0.f, 0.f, -1.f), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
 
     //Get unforms to place our matrices into
     GLuint projmat = glGetUniformLocation(shaderprogram, "u_ProjectionMat");
@@ -395,6 +401,8 @@ void Camera(const float time, const GLuint shaderprogram)
     //Send data from matrices to uniform
     glUniformMatrix4fv(projmat, 1, false, glm::value_ptr(projection));
     glUniformMatrix4fv(viewmat, 1, false, glm::value_ptr(view));
+
+    return projection * view;
 }
 
 void Light(const float time, const GLuint shaderprogram)
@@ -0,0 +1,44 @@
+#include "ViewFrustum.h"
+
+namespace Framework {
+    ViewFrustum::ViewFrustum(const glm::mat4& viewProjection) {
+
+        // Rows of the matrix (glm is column-major)
+        glm::vec4 rows[4];
+        for (int i = 0; i < 4; i++) {
+            rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        }
+
+        // A point is inside when -w <= x, y, z <= w in clip space
+        Planes[0] = rows[3] + rows[0]; // Left
+        Planes[1] = rows[3] - rows[0]; // Right
+        Planes[2] = rows[3] + rows[1]; // Bottom
+        Planes[3] = rows[3] - rows[1]; // Top
+        Planes[4] = rows[3] + rows[2]; // Near
+        Planes[5] = rows[3] - rows[2]; // Far
+
+        // Normalize, so sphere radii can be compared with the distances
+        for (auto& plane : Planes) {
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f) plane /= length;
+        }
+    }
+
+    bool ViewFrustum::IntersectsBox(const glm::vec3& min, const glm::vec3& max) const {
+        for (const auto& plane : Planes) {
+            // Corner furthest along the plane normal
+            glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x,
+                             plane.y >= 0.0f ? max.y : min.y,
+                             plane.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) return false;
+        }
+        return true;
+    }
+
+    bool ViewFrustum::IntersectsSphere(const glm::vec3& center, float radius) const {
+        for (const auto& plane : Planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,32 @@
+#ifndef VIEWFRUSTUM_H_
+#define VIEWFRUSTUM_H_
+
+#include <array>
+#include <glm/glm.hpp>
+
+namespace Framework {
+  // The six clipping planes of a view-projection matrix, used for culling.
+  //
+  // The planes are extracted from the combined matrix, so passing
+  // ViewProjection * Model gives planes in the model's local space and
+  // objects can be tested without transforming their bounds.
+  class ViewFrustum {
+  public:
+    explicit ViewFrustum(const glm::mat4& viewProjection);
+
+    // True if the axis-aligned box is (possibly partly) inside the frustum.
+    // Conservative: boxes near a frustum corner may pass although not visible.
+    bool IntersectsBox(const glm::vec3& min, const glm::vec3& max) const;
+    // True if the sphere is (possibly partly) inside the frustum.
+    bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+    // Left, right, bottom, top, near, far; for culling in shaders.
+    inline const std::array<glm::vec4, 6>& GetPlanes() const { return Planes; }
+
+  private:
+    // (normal, distance), pointing inwards: inside when dot(normal, p) + distance >= 0
+    std::array<glm::vec4, 6> Planes;
+  };
+};
+
+#endif // VIEWFRUSTUM_H_
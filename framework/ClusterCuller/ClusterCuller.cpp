@@ -0,0 +1,204 @@
+#include "ClusterCuller.h"
+
+#include <algorithm>
+#include <string>
+
+namespace Framework {
+
+    namespace {
+        // One entry of the meshlet buffer, as the compute shader reads it
+        struct GpuMeshlet {
+            MeshOptimizer::MeshletBounds Bounds;
+            GLuint FirstIndex;
+            GLuint IndexCount;
+            GLuint Padding[2];
+        };
+        static_assert(sizeof(GpuMeshlet) == 64, "GpuMeshlet must match the std430 layout");
+
+        // Layout fixed by glMultiDrawElementsIndirect
+        struct DrawElementsIndirectCommand {
+            GLuint Count;
+            GLuint InstanceCount;
+            GLuint FirstIndex;
+            GLint BaseVertex;
+            GLuint BaseInstance;
+        };
+
+        constexpr GLuint WorkGroupSize = 64;
+
+        const std::string CullShaderSrc = R"(
+#version 430 core
+
+layout(local_size_x = 64) in;
+
+struct Meshlet {
+    vec4 Sphere;            // Center, radius
+    vec4 ConeApex;
+    vec4 ConeAxisCutoff;
+    uint FirstIndex;
+    uint IndexCount;
+    uint Padding0;
+    uint Padding1;
+};
+
+struct DrawCommand {
+    uint Count;
+    uint InstanceCount;
+    uint FirstIndex;
+    int BaseVertex;
+    uint BaseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Meshlets { Meshlet meshlets[]; };
+layout(std430, binding = 1) writeonly buffer Commands { DrawCommand commands[]; };
+
+uniform vec4 u_Planes[6];           // Frustum planes in model space, pointing inwards
+uniform vec3 u_CameraPosition;      // In model space
+uniform uint u_MeshletCount;
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= u_MeshletCount) return;
+    Meshlet meshlet = meshlets[index];
+
+    bool visible = true;
+    for (int i = 0; i < 6; i++) {
+        visible = visible && dot(u_Planes[i].xyz, meshlet.Sphere.xyz) + u_Planes[i].w >= -meshlet.Sphere.w;
+    }
+    visible = visible && dot(normalize(meshlet.ConeApex.xyz - u_CameraPosition), meshlet.ConeAxisCutoff.xyz) < meshlet.ConeAxisCutoff.w;
+
+    commands[index] = DrawCommand(meshlet.IndexCount, visible ? 1u : 0u, meshlet.FirstIndex, 0, 0u);
+}
+)";
+    }
+
+    ClusterCuller::ClusterCuller(const MeshOptimizer::MeshletData& meshlets)
+        : Bounds(meshlets.Bounds) {
+
+        // The triangles of each meshlet, back to back, with mesh vertex indices
+        std::vector<GLuint> indices;
+        indices.reserve(meshlets.Triangles.size());
+        std::vector<GpuMeshlet> gpuMeshlets;
+        gpuMeshlets.reserve(meshlets.Meshlets.size());
+        GLuint maxIndex = 0;
+        for (size_t i = 0; i < meshlets.Meshlets.size(); i++) {
+            const MeshOptimizer::Meshlet& meshlet = meshlets.Meshlets[i];
+            FirstIndices.push_back(static_cast<GLuint>(indices.size()));
+            IndexCounts.push_back(static_cast<GLsizei>(3 * meshlet.TriangleCount));
+            gpuMeshlets.push_back({Bounds[i], FirstIndices.back(), 3 * meshlet.TriangleCount, {0, 0}});
+
+            const uint8_t* local = &meshlets.Triangles[3 * meshlet.TriangleOffset];
+            for (uint32_t j = 0; j < 3 * meshlet.TriangleCount; j++) {
+                GLuint index = meshlets.Vertices[meshlet.VertexOffset + local[j]];
+                indices.push_back(index);
+                maxIndex = std::max(maxIndex, index);
+            }
+        }
+
+        if (maxIndex <= 0xffff) {
+            std::vector<GLushort> shortIndices(indices.begin(), indices.end());
+            Indices = std::make_shared<IndexBuffer>(shortIndices.data(), (GLsizei)shortIndices.size());
+        } else {
+            Indices = std::make_shared<IndexBuffer>(indices.data(), (GLsizei)indices.size());
+        }
+
+        glGenBuffers(1, &MeshletBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, MeshletBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, gpuMeshlets.size() * sizeof(GpuMeshlet), gpuMeshlets.data(), GL_STATIC_DRAW);
+
+        // Until the first CullOnGpu, every meshlet is drawn
+        std::vector<DrawElementsIndirectCommand> commands;
+        commands.reserve(gpuMeshlets.size());
+        for (const GpuMeshlet& meshlet : gpuMeshlets) commands.push_back({meshlet.IndexCount, 1, meshlet.FirstIndex, 0, 0});
+        glGenBuffers(1, &CommandBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, CommandBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    ClusterCuller::~ClusterCuller() {
+        glDeleteBuffers(1, &MeshletBuffer);
+        glDeleteBuffers(1, &CommandBuffer);
+    }
+
+    bool ClusterCuller::IsVisible(const MeshOptimizer::MeshletBounds& bounds, const ViewFrustum& frustum, const glm::vec3& cameraPosition) {
+        if (!frustum.IntersectsSphere(bounds.Center, bounds.Radius)) return false;
+        return glm::dot(glm::normalize(bounds.ConeApex - cameraPosition), bounds.ConeAxis) < bounds.ConeCutoff;
+    }
+
+    std::vector<uint32_t> ClusterCuller::Cull(const glm::mat4& modelViewProjection, const glm::vec3& cameraPosition) const {
+        ViewFrustum frustum(modelViewProjection);
+        std::vector<uint32_t> visible;
+        for (size_t i = 0; i < Bounds.size(); i++) {
+            if (IsVisible(Bounds[i], frustum, cameraPosition)) visible.push_back(static_cast<uint32_t>(i));
+        }
+        return visible;
+    }
+
+    void ClusterCuller::Draw(const std::vector<uint32_t>& meshlets) const {
+        if (meshlets.empty()) return;
+
+        const size_t indexSize = Indices->GetType() == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+        std::vector<GLsizei> counts;
+        std::vector<const void*> offsets;
+        counts.reserve(meshlets.size());
+        offsets.reserve(meshlets.size());
+        for (uint32_t meshlet : meshlets) {
+            // Neighbouring meshlets are drawn as one range
+            const void* offset = reinterpret_cast<const void*>(FirstIndices[meshlet] * indexSize);
+            if (!counts.empty() && static_cast<const char*>(offsets.back()) + counts.back() * indexSize == offset) {
+                counts.back() += IndexCounts[meshlet];
+                continue;
+            }
+            counts.push_back(IndexCounts[meshlet]);
+            offsets.push_back(offset);
+        }
+        glMultiDrawElements(GL_TRIANGLES, counts.data(), Indices->GetType(), offsets.data(), (GLsizei)counts.size());
+    }
+
+    void ClusterCuller::CullOnGpu(const glm::mat4& modelViewProjection, const glm::vec3& cameraPosition) {
+        if (Bounds.empty()) return;
+        if (!CullShader) CullShader = std::make_unique<Shader>(CullShaderSrc);
+
+        ViewFrustum frustum(modelViewProjection);
+        CullShader->Bind();
+        for (int i = 0; i < 6; i++) {
+            CullShader->UploadUniformFloat4("u_Planes[" + std::to_string(i) + "]", frustum.GetPlanes()[i]);
+        }
+        CullShader->UploadUniformFloat3("u_CameraPosition", cameraPosition);
+        CullShader->UploadUniformUInt1("u_MeshletCount", (GLuint)Bounds.size());
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, MeshletBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, CommandBuffer);
+        glDispatchCompute((GLuint)(Bounds.size() + WorkGroupSize - 1) / WorkGroupSize, 1, 1);
+        CullShader->Unbind();
+
+        // The commands are read by the next indirect draw
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+    }
+
+    void ClusterCuller::DrawIndirect() const {
+        if (Bounds.empty()) return;
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, CommandBuffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, Indices->GetType(), nullptr, (GLsizei)Bounds.size(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    std::vector<uint32_t> ClusterCuller::ReadGpuVisible() const {
+        std::vector<DrawElementsIndirectCommand> commands(Bounds.size());
+        if (commands.empty()) return {};
+
+        // The shader's writes must land before the buffer is read
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, CommandBuffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        std::vector<uint32_t> visible;
+        for (size_t i = 0; i < commands.size(); i++) {
+            if (commands[i].InstanceCount != 0) visible.push_back(static_cast<uint32_t>(i));
+        }
+        return visible;
+    }
+};
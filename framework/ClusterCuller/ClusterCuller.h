@@ -0,0 +1,67 @@
+#ifndef CLUSTERCULLER_H_
+#define CLUSTERCULLER_H_
+
+#include <glad/glad.h>
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "IndexBuffer.h"
+#include "MeshOptimizer.h"
+#include "Shader.h"
+#include "ViewFrustum.h"
+
+namespace Framework {
+
+  // Culling of the meshlets of a mesh (MeshOptimizer::BuildMeshlets): meshlets outside the view
+  // frustum or facing away from the camera are not drawn.
+  //
+  // The culler owns an index buffer with the triangles of each meshlet in one contiguous range,
+  // which replaces the mesh's own (VertexArray::SetIndexBuffer). Culling works in model space:
+  // it takes projection * view * model and the camera position in model space, so the model
+  // matrix should not scale non-uniformly.
+  //
+  //   CPU: Cull() returns the visible meshlets and Draw() draws them (glMultiDrawElements).
+  //   GPU: CullOnGpu() runs a compute shader that writes one indirect draw command per meshlet,
+  //        with no instances if it is culled, and DrawIndirect() draws them all in one call
+  //        (glMultiDrawElementsIndirect). Nothing is read back to the CPU, except by
+  //        ReadGpuVisible(), which is for checking the two paths against each other.
+  class ClusterCuller {
+  public:
+    explicit ClusterCuller(const MeshOptimizer::MeshletData& meshlets);
+    ~ClusterCuller();
+
+    ClusterCuller(const ClusterCuller&) = delete;
+    ClusterCuller& operator=(const ClusterCuller&) = delete;
+
+    inline const std::shared_ptr<IndexBuffer>& GetIndexBuffer() const { return Indices; }
+    inline size_t GetMeshletCount() const { return Bounds.size(); }
+
+    // The test both paths use: sphere against the frustum, then the normal cone.
+    static bool IsVisible(const MeshOptimizer::MeshletBounds& bounds, const ViewFrustum& frustum, const glm::vec3& cameraPosition);
+
+    // Indices of the visible meshlets.
+    std::vector<uint32_t> Cull(const glm::mat4& modelViewProjection, const glm::vec3& cameraPosition) const;
+    // Draw the given meshlets. The mesh's VertexArray must be bound.
+    void Draw(const std::vector<uint32_t>& meshlets) const;
+
+    // Write the draw commands on the GPU (compiles the compute shader on first use).
+    void CullOnGpu(const glm::mat4& modelViewProjection, const glm::vec3& cameraPosition);
+    // Draw the meshlets CullOnGpu kept. The mesh's VertexArray must be bound.
+    void DrawIndirect() const;
+    // Indices of the meshlets the last CullOnGpu kept, read back from the draw commands. Waits
+    // for the GPU to finish.
+    std::vector<uint32_t> ReadGpuVisible() const;
+
+  private:
+    std::vector<MeshOptimizer::MeshletBounds> Bounds;
+    std::vector<GLsizei> IndexCounts;          // Per meshlet
+    std::vector<GLuint> FirstIndices;
+    std::shared_ptr<IndexBuffer> Indices;
+    GLuint MeshletBuffer = 0;                  // Bounds and index ranges, std430
+    GLuint CommandBuffer = 0;                  // DrawElementsIndirectCommand per meshlet
+    std::unique_ptr<Shader> CullShader;
+  };
+};
+
+#endif // CLUSTERCULLER_H_
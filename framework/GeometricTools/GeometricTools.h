@@ -33,6 +33,66 @@ namespace Framework {
         -0.5f,  0.5f  //top-left
       };
     
+    namespace Detail {
+      // Number of floats per grid vertex for the given attributes.
+      constexpr uint UnitGridStride(bool colors, bool textures) {
+        return 2 + (colors ? 4 : 0) + (textures ? 2 : 0);
+      }
+
+      // Writes the grid vertices to 'out', which must hold (rows+1)*(cols+1) vertices.
+      // Shared by the compile-time and runtime variants so both produce the same data.
+      constexpr void FillUnitGridGeometry2D(float* out, uint rows, uint cols, bool colors, bool textures) {
+        bool even = true;
+        for (uint y = 0; y <= rows; y++) {
+          for (uint x = 0; x <= cols; x++) {
+            // Position attribute
+            *out++ = (-1)+(float)x*2/cols; // Vertex x-coord
+            *out++ = (-1)+(float)y*2/rows; // Vertex y-coord
+
+            // Color attribute
+            if (colors) {
+              const float c = even ? 1.0f : 0.0f;
+              *out++ = c; *out++ = c; *out++ = c; *out++ = 1.0f;
+            }
+
+            // Textures attribute
+            if (textures) {
+              *out++ = (float)x/cols;
+              *out++ = (float)y/rows;
+            }
+
+            even = !even;
+          }
+        }
+      }
+
+      // Writes the grid indices (6 per square) to 'out'.
+      constexpr void FillUnitGridTopologyTriangles(uint* out, uint rows, uint cols) {
+        auto rowMult = cols+1; // Multiplier for row number / amount of columns+1
+        /*
+        vertexArray = [punkt1, punkt2, punkt3,
+                      punkt4, punkt5, punkt6,
+                      punkt7, punkt8, punkt9]
+        cols = 2
+        rows = 2
+        rowMult = 3
+        */
+        for (uint row = 0; row < rows; row++) {
+          for (uint col = 0; col < cols; col++) {
+            // Single tile (square)
+            // Primitive 1 (triangle)
+            *out++ = rowMult* row   + col;    //vertex a (top-left)
+            *out++ = rowMult* row   +(col+1); //vertex b (top-right)
+            *out++ = rowMult*(row+1)+(col+1); //vertex c (bottom-right)
+            // Primitive 2 (triangle)
+            *out++ = rowMult* row   + col;    //vertex a (top-left)
+            *out++ = rowMult*(row+1)+ col;    //vertex d (bottom-left)
+            *out++ = rowMult*(row+1)+(col+1); //vertex c (bottom-right)
+          }
+        }
+      }
+    }
+
     /**
      *  Geometry (vertices) of unit grid in 2D
      * 
@@ -40,8 +100,12 @@ namespace Framework {
      * 
      *  If template argument 'textures' is true, a texture coordinate attribute is added to the vertex buffer.
      * 
+     *  Evaluated at compile time when used in a constant expression, e.g.
+     *  'static constexpr auto grid = UnitGridGeometry2D<8, 8>();', which places the data in the
+     *  binary's read-only data.
+     * 
      *  @returns
-     * Vector of vertices (floats) with format:
+     * Array of vertices (floats) with format:
      * 
      * 1. positions (2)
      * 
@@ -50,80 +114,57 @@ namespace Framework {
      * 3. (opt) texture coordinates (2)
      */
     template <uint rows, uint cols, bool colors = false, bool textures = false>
-    constexpr std::vector<float> UnitGridGeometry2D() {
-      std::vector<float> vertecies;
-
-      if (rows == 0 || cols == 0) return vertecies; // Cannot have 0 rows or cols
+    constexpr std::array<float, (rows+1)*(cols+1)*Detail::UnitGridStride(colors, textures)> UnitGridGeometry2D() {
+      static_assert(rows > 0 && cols > 0, "Cannot have 0 rows or cols");
 
-      // Loop through and create each vertex
-      bool even = true;
-      for (int y = 0; y <= rows; y++) {
-        for (int x = 0; x <= cols; x++) {
-          // Position attribute
-          vertecies.push_back((-1)+(float)x*2/cols); // Vertex x-coord
-          vertecies.push_back((-1)+(float)y*2/rows); // Vertex y-coord
-          //std::cout << "(" << x << "x," << y << "y) ";
-
-          // Color attribute
-          if (colors) {
-            if (even) {
-              vertecies.insert(vertecies.end(), {1.0f, 1.0f, 1.0f, 1.0f});
-            } else {
-              vertecies.insert(vertecies.end(), {0.0f, 0.0f, 0.0f, 1.0f});
-            }
-          }
+      std::array<float, (rows+1)*(cols+1)*Detail::UnitGridStride(colors, textures)> vertecies{};
+      Detail::FillUnitGridGeometry2D(vertecies.data(), rows, cols, colors, textures);
+      return vertecies;
+    }
 
-          // Textures attribute
-          if (textures) {
-            vertecies.push_back((float)x/cols);
-            vertecies.push_back((float)y/rows);
-          }
+    /**
+     *  Geometry (vertices) of unit grid in 2D, for sizes only known at runtime.
+     * 
+     *  Same format as UnitGridGeometry2D<rows, cols, colors, textures>().
+     * 
+     *  @returns Vector of vertices (floats), empty if rows or cols is 0
+     */
+    inline std::vector<float> UnitGridGeometry2D(uint rows, uint cols, bool colors = false, bool textures = false) {
+      std::vector<float> vertecies;
+      if (rows == 0 || cols == 0) return vertecies; // Cannot have 0 rows or cols
 
-          even = !even;
-        }
-        //std::cout << "\n";
-      }
+      vertecies.resize((size_t)(rows+1)*(cols+1)*Detail::UnitGridStride(colors, textures));
+      Detail::FillUnitGridGeometry2D(vertecies.data(), rows, cols, colors, textures);
       return vertecies;
     }
     
     /**
      *  Topology (indecies) of unit grid in 2D (using triangles).
      * 
+     *  Evaluated at compile time when used in a constant expression.
+     * 
      *  @returns Array of indecies (uint)
      */
     template <uint rows, uint cols>
-    constexpr std::vector<uint> UnitGridTopologyTriangles() {
+    constexpr std::array<uint, rows*cols*6> UnitGridTopologyTriangles() {
+      static_assert(rows > 0 && cols > 0, "Cannot have 0 rows or cols");
+
+      std::array<uint, rows*cols*6> indecies{};
+      Detail::FillUnitGridTopologyTriangles(indecies.data(), rows, cols);
+      return indecies;
+    }
+
+    /**
+     *  Topology (indecies) of unit grid in 2D (using triangles), for sizes only known at runtime.
+     * 
+     *  @returns Vector of indecies (uint), empty if rows or cols is 0
+     */
+    inline std::vector<uint> UnitGridTopologyTriangles(uint rows, uint cols) {
       std::vector<uint> indecies;
       if (rows == 0 || cols == 0) return indecies; // Cannot have 0 rows or cols
-      
-      // Loop through each row and column except the last one
-      auto rowMult = cols+1; // Multiplier for row number / amount of columns+1
-      /*
-      vertexArray = [punkt1, punkt2, punkt3,
-                    punkt4, punkt5, punkt6,
-                    punkt7, punkt8, punkt9] 
-      cols = 2
-      rows = 2
-      rowMult = 3
-      */
-
-      for (int row = 0; row < rows; row++) {
-        for (int col = 0; col < cols; col++) {
-          
-          // Single tile (square)
-          // Primitive 1 (triangle)
-          //std::cout << "(";
-          indecies.push_back(rowMult* row   + col);   // std::cout << indecies.back() << ",";  //vertex a (top-left)
-          indecies.push_back(rowMult* row   +(col+1));// std::cout << indecies.back() << ",";  //vertex b (top-right)
-          indecies.push_back(rowMult*(row+1)+(col+1));// std::cout << indecies.back() << ") "; //vertex c (bottom-right)
-          // Primitive 2 (triangle)
-          //std::cout << "(";
-          indecies.push_back(rowMult* row   + col);   // std::cout << indecies.back() << ",";   //vertex a (top-left)
-          indecies.push_back(rowMult*(row+1)+ col);   // std::cout << indecies.back() << ",";   //vertex d (bottom-left)
-          indecies.push_back(rowMult*(row+1)+(col+1));// std::cout << indecies.back() << ")\n"; //vertex c (bottom-right)
-        }
-      }
 
+      indecies.resize((size_t)rows*cols*6);
+      Detail::FillUnitGridTopologyTriangles(indecies.data(), rows, cols);
       return indecies;
     }
 
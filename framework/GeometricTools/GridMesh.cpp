@@ -0,0 +1,144 @@
+#include "GridMesh.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace Framework {
+
+    namespace {
+        // Vertices (and tiles) handled per parallel block
+        constexpr size_t BlockSize = 1 << 16;
+
+        // Writes the vertex rows [firstRow, lastRow). The attribute choice is a template
+        // parameter so the per-vertex loop has no branches.
+        template <bool colors, bool textures>
+        void WriteVertexRows(float* vertices, unsigned int rows, unsigned int cols, size_t firstRow, size_t lastRow,
+                             const std::vector<float>& xPositions, const std::vector<float>& uCoords) {
+            const size_t rowVertices = static_cast<size_t>(cols) + 1;
+            constexpr size_t stride = 2 + (colors ? 4 : 0) + (textures ? 2 : 0);
+
+            for (size_t y = firstRow; y < lastRow; y++) {
+                const float yPosition = (-1) + (float)y * 2 / rows;
+                const float vCoord = (float)y / rows;
+                const size_t first = y * rowVertices;
+                float* out = vertices + first * stride;
+
+                for (size_t x = 0; x < rowVertices; x++, out += stride) {
+                    out[0] = xPositions[x];
+                    out[1] = yPosition;
+                    if (colors) {
+                        // Alternates white/black along the linear vertex index
+                        const float c = (float)(1 - ((first + x) & 1));
+                        out[2] = c;
+                        out[3] = c;
+                        out[4] = c;
+                        out[5] = 1.0f;
+                    }
+                    if (textures) {
+                        out[stride - 2] = uCoords[x];
+                        out[stride - 1] = vCoord;
+                    }
+                }
+            }
+        }
+
+        // Writes the indices of one chunk, relative to its base vertex.
+        template <typename Index>
+        void WriteChunkIndices(Index* out, const GridMesh::Chunk& chunk, unsigned int cols) {
+            const Index rowMult = static_cast<Index>(cols + 1);
+
+            for (unsigned int row = 0; row < chunk.RowCount; row++) {
+                const Index top = static_cast<Index>(row * rowMult);
+                const Index bottom = static_cast<Index>(top + rowMult);
+                for (unsigned int col = 0; col < cols; col++) {
+                    // Same winding as GeometricTools::UnitGridTopologyTriangles()
+                    out[0] = top + col;
+                    out[1] = top + col + 1;
+                    out[2] = bottom + col + 1;
+                    out[3] = top + col;
+                    out[4] = bottom + col;
+                    out[5] = bottom + col + 1;
+                    out += 6;
+                }
+            }
+        }
+    }
+
+    GridMesh::GridMesh(unsigned int rows, unsigned int cols, bool colors, bool textures, unsigned int maxChunkRows)
+        : Rows(rows), Cols(cols), Stride(2 + (colors ? 4 : 0) + (textures ? 2 : 0)) {
+        if (rows == 0 || cols == 0) return; // Cannot have 0 rows or cols
+
+        PlanChunks(maxChunkRows);
+        GenerateVertices(colors, textures);
+        GenerateIndices();
+    }
+
+    void GridMesh::PlanChunks(unsigned int maxChunkRows) {
+        const size_t rowVertices = static_cast<size_t>(Cols) + 1;
+
+        // A chunk of n tile rows references n+1 vertex rows
+        size_t chunkRows = maxChunkRows;
+        if (chunkRows == 0) {
+            const size_t fit16 = 65536 / rowVertices;
+            chunkRows = fit16 >= 2 ? fit16 - 1 : std::max<size_t>(BlockSize / Cols, 1);
+        }
+
+        size_t offset16 = 0;
+        size_t offset32 = 0;
+        Chunks.reserve((Rows + chunkRows - 1) / chunkRows);
+        for (size_t first = 0; first < Rows; first += chunkRows) {
+            Chunk chunk;
+            chunk.FirstRow = static_cast<unsigned int>(first);
+            chunk.RowCount = static_cast<unsigned int>(std::min<size_t>(chunkRows, Rows - first));
+            chunk.BaseVertex = first * rowVertices;
+            chunk.VertexCount = (chunk.RowCount + 1) * rowVertices;
+            chunk.IndexCount = static_cast<size_t>(chunk.RowCount) * Cols * 6;
+            chunk.WideIndices = chunk.VertexCount > 65536;
+
+            size_t& offset = chunk.WideIndices ? offset32 : offset16;
+            chunk.IndexOffset = offset;
+            offset += chunk.IndexCount;
+
+            Chunks.push_back(chunk);
+        }
+
+        Indices16.resize(offset16);
+        Indices32.resize(offset32);
+    }
+
+    void GridMesh::GenerateVertices(bool colors, bool textures) {
+        Vertices.resize(GetVertexCount() * Stride);
+
+        // Values shared by all rows
+        std::vector<float> xPositions(Cols + 1);
+        std::vector<float> uCoords(Cols + 1);
+        for (unsigned int x = 0; x <= Cols; x++) {
+            xPositions[x] = (-1) + (float)x * 2 / Cols;
+            uCoords[x] = (float)x / Cols;
+        }
+
+        auto write = &WriteVertexRows<false, false>;
+        if (colors && textures) write = &WriteVertexRows<true, true>;
+        else if (colors) write = &WriteVertexRows<true, false>;
+        else if (textures) write = &WriteVertexRows<false, true>;
+
+        const size_t grain = std::max<size_t>(BlockSize / (Cols + 1), 1);
+        float* vertices = Vertices.data();
+        ThreadPool::GetShared().ParallelFor(0, static_cast<size_t>(Rows) + 1, grain, [&](size_t first, size_t last) {
+            write(vertices, Rows, Cols, first, last, xPositions, uCoords);
+        });
+    }
+
+    void GridMesh::GenerateIndices() {
+        ThreadPool::GetShared().ParallelFor(0, Chunks.size(), 1, [this](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                const Chunk& chunk = Chunks[i];
+                if (chunk.WideIndices) {
+                    WriteChunkIndices(Indices32.data() + chunk.IndexOffset, chunk, Cols);
+                } else {
+                    WriteChunkIndices(Indices16.data() + chunk.IndexOffset, chunk, Cols);
+                }
+            }
+        });
+    }
+};
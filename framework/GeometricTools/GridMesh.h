@@ -0,0 +1,67 @@
+#ifndef GRIDMESH_H_
+#define GRIDMESH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Framework {
+
+  // Runtime generator for large unit grids (e.g. 4096x4096 tiles).
+  //
+  // The vertices use the same format and values as GeometricTools::UnitGridGeometry2D():
+  // positions (2), optional colors (4) and optional texture coordinates (2). Vertices and
+  // indices are written straight into exactly sized buffers, in parallel row blocks on the
+  // shared ThreadPool.
+  //
+  // The tile rows are split into chunks. Indices in a chunk are relative to the chunk's
+  // BaseVertex, so a chunk is drawn with
+  //   glDrawElementsBaseVertex(GL_TRIANGLES, chunk.IndexCount, type, offset, chunk.BaseVertex)
+  // Chunks whose vertices fit in 16 bits use 16-bit indices (stored in GetIndices16()),
+  // others 32-bit indices (stored in GetIndices32()).
+  class GridMesh {
+  public:
+    struct Chunk {
+      unsigned int FirstRow;    // First tile row covered by the chunk
+      unsigned int RowCount;    // Number of tile rows
+      size_t BaseVertex;        // Added to every index of the chunk
+      size_t VertexCount;       // Vertices referenced by the chunk, starting at BaseVertex
+      size_t IndexOffset;       // First index in GetIndices16() or GetIndices32()
+      size_t IndexCount;
+      bool WideIndices;         // true: 32-bit indices, false: 16-bit indices
+    };
+
+  public:
+    // Constructor. Generates the grid. 'maxChunkRows' limits the tile rows per chunk;
+    // 0 picks the largest chunks that still fit 16-bit indices.
+    GridMesh(unsigned int rows, unsigned int cols, bool colors = false, bool textures = false,
+             unsigned int maxChunkRows = 0);
+
+    inline unsigned int GetRows() const { return Rows; }
+    inline unsigned int GetCols() const { return Cols; }
+    // Number of floats per vertex.
+    inline unsigned int GetStride() const { return Stride; }
+    inline size_t GetVertexCount() const { return static_cast<size_t>(Rows + 1) * (Cols + 1); }
+
+    inline const std::vector<float>& GetVertices() const { return Vertices; }
+    inline const std::vector<uint16_t>& GetIndices16() const { return Indices16; }
+    inline const std::vector<uint32_t>& GetIndices32() const { return Indices32; }
+    inline const std::vector<Chunk>& GetChunks() const { return Chunks; }
+
+  private:
+    void PlanChunks(unsigned int maxChunkRows);
+    void GenerateVertices(bool colors, bool textures);
+    void GenerateIndices();
+
+  private:
+    unsigned int Rows;
+    unsigned int Cols;
+    unsigned int Stride;
+    std::vector<float> Vertices;
+    std::vector<uint16_t> Indices16;
+    std::vector<uint32_t> Indices32;
+    std::vector<Chunk> Chunks;
+  };
+};
+
+#endif // GRIDMESH_H_
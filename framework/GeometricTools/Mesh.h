@@ -0,0 +1,52 @@
+#ifndef MESH_H_
+#define MESH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Framework {
+
+  // Indexed triangle mesh with one array per vertex attribute.
+  //
+  // Normals, TexCoords and Tangents are either empty or hold one entry per position.
+  // Tangents store the bitangent sign in w: bitangent = w * cross(normal, tangent).
+  struct Mesh {
+    std::vector<glm::vec3> Positions;
+    std::vector<glm::vec3> Normals;
+    std::vector<glm::vec2> TexCoords;
+    std::vector<glm::vec4> Tangents;
+    std::vector<uint32_t> Indices; // Triangle list
+
+    inline size_t GetVertexCount() const { return Positions.size(); }
+    inline size_t GetTriangleCount() const { return Indices.size() / 3; }
+
+    // Number of floats per interleaved vertex.
+    inline size_t GetStride() const {
+      return 3 + (Normals.empty() ? 0 : 3) + (TexCoords.empty() ? 0 : 2) + (Tangents.empty() ? 0 : 4);
+    }
+
+    // Vertex data for a VertexBuffer: position (3), normal (3), texture coordinates (2),
+    // tangent (4), where missing attributes are left out.
+    std::vector<float> Interleave() const {
+      std::vector<float> vertices(GetVertexCount() * GetStride());
+      float* out = vertices.data();
+      for (size_t i = 0; i < Positions.size(); i++) {
+        *out++ = Positions[i].x; *out++ = Positions[i].y; *out++ = Positions[i].z;
+        if (!Normals.empty()) {
+          *out++ = Normals[i].x; *out++ = Normals[i].y; *out++ = Normals[i].z;
+        }
+        if (!TexCoords.empty()) {
+          *out++ = TexCoords[i].x; *out++ = TexCoords[i].y;
+        }
+        if (!Tangents.empty()) {
+          *out++ = Tangents[i].x; *out++ = Tangents[i].y; *out++ = Tangents[i].z; *out++ = Tangents[i].w;
+        }
+      }
+      return vertices;
+    }
+  };
+};
+
+#endif // MESH_H_
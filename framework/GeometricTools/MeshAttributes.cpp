@@ -0,0 +1,257 @@
+#include "MeshAttributes.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define MESHATTRIBUTES_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Framework {
+namespace MeshAttributes {
+
+    namespace {
+        // Triangles or vertices per parallel block; smaller meshes stay on the calling thread
+        constexpr size_t Grain = 1 << 14;
+        constexpr float Pi = 3.14159265358979323846f;
+
+        // acos approximation (Abramowitz & Stegun 4.4.45), error below 7e-5 radians.
+        // Plenty for weights, and easy to vectorize.
+        inline float FastAcos(float x) {
+            x = std::min(std::max(x, -1.0f), 1.0f);
+            float a = std::abs(x);
+            float r = std::sqrt(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f + a * -0.0187293f)));
+            return x < 0.0f ? Pi - r : r;
+        }
+
+        // Angle between two vectors (0 if one of them is zero)
+        inline float Angle(const glm::vec3& u, const glm::vec3& v) {
+            float denominator = std::sqrt(glm::dot(u, u) * glm::dot(v, v));
+            return denominator > 0.0f ? FastAcos(glm::dot(u, v) / denominator) : 0.0f;
+        }
+
+        // Contributions of triangle t to the normals of its three corners
+        void TriangleNormal(const Mesh& mesh, size_t t, NormalWeighting weighting, glm::vec3* out) {
+            const glm::vec3& a = mesh.Positions[mesh.Indices[3 * t]];
+            const glm::vec3& b = mesh.Positions[mesh.Indices[3 * t + 1]];
+            const glm::vec3& c = mesh.Positions[mesh.Indices[3 * t + 2]];
+            glm::vec3 normal = glm::cross(b - a, c - a); // Length: twice the area
+
+            if (weighting == NormalWeighting::Area) {
+                out[0] = out[1] = out[2] = normal;
+                return;
+            }
+
+            float length = glm::length(normal);
+            if (length == 0.0f) {
+                out[0] = out[1] = out[2] = glm::vec3(0.0f);
+                return;
+            }
+            normal /= length;
+            out[0] = normal * Angle(b - a, c - a);
+            out[1] = normal * Angle(c - b, a - b);
+            out[2] = normal * Angle(a - c, b - c);
+        }
+
+#ifdef MESHATTRIBUTES_SSE2
+        inline __m128 Dot(__m128 ux, __m128 uy, __m128 uz, __m128 vx, __m128 vy, __m128 vz) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ux, vx), _mm_mul_ps(uy, vy)), _mm_mul_ps(uz, vz));
+        }
+
+        // Four angles at once, see Angle() and FastAcos()
+        inline __m128 Angle4(__m128 ux, __m128 uy, __m128 uz, __m128 vx, __m128 vy, __m128 vz) {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            __m128 denominator = _mm_sqrt_ps(_mm_mul_ps(Dot(ux, uy, uz, ux, uy, uz), Dot(vx, vy, vz, vx, vy, vz)));
+            __m128 valid = _mm_cmpgt_ps(denominator, zero);
+            __m128 x = _mm_div_ps(Dot(ux, uy, uz, vx, vy, vz), _mm_or_ps(denominator, _mm_andnot_ps(valid, one)));
+            x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), one);
+
+            __m128 negative = _mm_cmplt_ps(x, zero);
+            __m128 a = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+            __m128 poly = _mm_add_ps(_mm_set1_ps(0.0742610f), _mm_mul_ps(a, _mm_set1_ps(-0.0187293f)));
+            poly = _mm_add_ps(_mm_set1_ps(-0.2121144f), _mm_mul_ps(a, poly));
+            poly = _mm_add_ps(_mm_set1_ps(1.5707288f), _mm_mul_ps(a, poly));
+            __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(one, a)), poly);
+            r = _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(Pi), r)), _mm_andnot_ps(negative, r));
+            return _mm_and_ps(valid, r);
+        }
+
+        // TriangleNormal() for triangles t..t+3
+        void TriangleNormal4(const Mesh& mesh, size_t t, NormalWeighting weighting, glm::vec3* out) {
+            const uint32_t* indices = mesh.Indices.data() + 3 * t;
+            const glm::vec3* positions = mesh.Positions.data();
+
+            // Gather into structure-of-arrays form
+            alignas(16) float p[9][4];
+            for (int k = 0; k < 4; k++) {
+                for (int corner = 0; corner < 3; corner++) {
+                    const glm::vec3& v = positions[indices[3 * k + corner]];
+                    p[3 * corner][k] = v.x;
+                    p[3 * corner + 1][k] = v.y;
+                    p[3 * corner + 2][k] = v.z;
+                }
+            }
+            __m128 ax = _mm_load_ps(p[0]), ay = _mm_load_ps(p[1]), az = _mm_load_ps(p[2]);
+            __m128 e1x = _mm_sub_ps(_mm_load_ps(p[3]), ax), e1y = _mm_sub_ps(_mm_load_ps(p[4]), ay), e1z = _mm_sub_ps(_mm_load_ps(p[5]), az);
+            __m128 e2x = _mm_sub_ps(_mm_load_ps(p[6]), ax), e2y = _mm_sub_ps(_mm_load_ps(p[7]), ay), e2z = _mm_sub_ps(_mm_load_ps(p[8]), az);
+
+            // normal = cross(e1, e2)
+            __m128 nx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+            __m128 ny = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+            __m128 nz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+
+            alignas(16) float w[3][4];
+            if (weighting == NormalWeighting::Area) {
+                for (int corner = 0; corner < 3; corner++) _mm_store_ps(w[corner], _mm_set1_ps(1.0f));
+            } else {
+                __m128 length = _mm_sqrt_ps(Dot(nx, ny, nz, nx, ny, nz));
+                __m128 valid = _mm_cmpgt_ps(length, _mm_setzero_ps());
+                __m128 inverse = _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), _mm_or_ps(length, _mm_andnot_ps(valid, _mm_set1_ps(1.0f)))));
+                nx = _mm_mul_ps(nx, inverse);
+                ny = _mm_mul_ps(ny, inverse);
+                nz = _mm_mul_ps(nz, inverse);
+
+                const __m128 zero = _mm_setzero_ps();
+                __m128 e3x = _mm_sub_ps(e2x, e1x), e3y = _mm_sub_ps(e2y, e1y), e3z = _mm_sub_ps(e2z, e1z); // c - b
+                _mm_store_ps(w[0], Angle4(e1x, e1y, e1z, e2x, e2y, e2z));
+                _mm_store_ps(w[1], Angle4(e3x, e3y, e3z, _mm_sub_ps(zero, e1x), _mm_sub_ps(zero, e1y), _mm_sub_ps(zero, e1z)));
+                _mm_store_ps(w[2], Angle4(_mm_sub_ps(zero, e2x), _mm_sub_ps(zero, e2y), _mm_sub_ps(zero, e2z),
+                                          _mm_sub_ps(zero, e3x), _mm_sub_ps(zero, e3y), _mm_sub_ps(zero, e3z)));
+            }
+
+            alignas(16) float n[3][4];
+            _mm_store_ps(n[0], nx);
+            _mm_store_ps(n[1], ny);
+            _mm_store_ps(n[2], nz);
+            for (int k = 0; k < 4; k++) {
+                glm::vec3 normal(n[0][k], n[1][k], n[2][k]);
+                for (int corner = 0; corner < 3; corner++) out[3 * k + corner] = normal * w[corner][k];
+            }
+        }
+#endif
+
+        // Corners (3 * triangle + corner) using each vertex, in compressed sparse row form:
+        // the corners of vertex v are Corners[Offsets[v]] .. Corners[Offsets[v + 1] - 1].
+        struct Adjacency {
+            std::vector<uint32_t> Offsets;
+            std::vector<uint32_t> Corners;
+        };
+
+        Adjacency BuildAdjacency(const Mesh& mesh) {
+            Adjacency adjacency;
+            adjacency.Offsets.assign(mesh.GetVertexCount() + 1, 0);
+            for (uint32_t index : mesh.Indices) adjacency.Offsets[index + 1]++;
+            for (size_t v = 0; v < mesh.GetVertexCount(); v++) adjacency.Offsets[v + 1] += adjacency.Offsets[v];
+
+            std::vector<uint32_t> cursor(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+            adjacency.Corners.resize(mesh.Indices.size());
+            for (size_t i = 0; i < mesh.Indices.size(); i++) {
+                adjacency.Corners[cursor[mesh.Indices[i]]++] = static_cast<uint32_t>(i);
+            }
+            return adjacency;
+        }
+
+        // Unit vector perpendicular to n
+        glm::vec3 AnyPerpendicular(const glm::vec3& n) {
+            glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            return glm::normalize(glm::cross(n, axis));
+        }
+    }
+
+    void ComputeNormals(Mesh& mesh, NormalWeighting weighting) {
+        const size_t triangles = mesh.GetTriangleCount();
+        ThreadPool& pool = ThreadPool::GetShared();
+
+        // Per-corner contributions
+        std::vector<glm::vec3> contributions(3 * triangles);
+        pool.ParallelFor(0, triangles, Grain, [&](size_t first, size_t last) {
+            size_t t = first;
+#ifdef MESHATTRIBUTES_SSE2
+            for (; t + 4 <= last; t += 4) TriangleNormal4(mesh, t, weighting, &contributions[3 * t]);
+#endif
+            for (; t < last; t++) TriangleNormal(mesh, t, weighting, &contributions[3 * t]);
+        });
+
+        // Sum per vertex
+        Adjacency adjacency = BuildAdjacency(mesh);
+        mesh.Normals.resize(mesh.GetVertexCount());
+        pool.ParallelFor(0, mesh.GetVertexCount(), Grain, [&](size_t first, size_t last) {
+            for (size_t v = first; v < last; v++) {
+                glm::vec3 sum(0.0f);
+                for (uint32_t i = adjacency.Offsets[v]; i < adjacency.Offsets[v + 1]; i++) sum += contributions[adjacency.Corners[i]];
+                float length = glm::length(sum);
+                mesh.Normals[v] = length > 0.0f ? sum / length : glm::vec3(0.0f);
+            }
+        });
+    }
+
+    bool ComputeTangents(Mesh& mesh) {
+        if (mesh.Normals.size() != mesh.GetVertexCount() || mesh.TexCoords.size() != mesh.GetVertexCount()) return false;
+
+        const size_t triangles = mesh.GetTriangleCount();
+        ThreadPool& pool = ThreadPool::GetShared();
+
+        // Per-corner tangent and bitangent, projected into the plane of the vertex normal and
+        // weighted by the corner angle in that plane
+        std::vector<glm::vec3> tangents(3 * triangles);
+        std::vector<glm::vec3> bitangents(3 * triangles);
+        pool.ParallelFor(0, triangles, Grain, [&](size_t first, size_t last) {
+            for (size_t t = first; t < last; t++) {
+                const uint32_t* index = &mesh.Indices[3 * t];
+                const glm::vec3 p[3] = {mesh.Positions[index[0]], mesh.Positions[index[1]], mesh.Positions[index[2]]};
+                const glm::vec2 uv[3] = {mesh.TexCoords[index[0]], mesh.TexCoords[index[1]], mesh.TexCoords[index[2]]};
+
+                glm::vec3 dp1 = p[1] - p[0], dp2 = p[2] - p[0];
+                glm::vec2 duv1 = uv[1] - uv[0], duv2 = uv[2] - uv[0];
+                float signedArea = duv1.x * duv2.y - duv1.y * duv2.x;
+
+                // As in MikkTSpace only the orientation of the texture space is used, not its scale
+                float orientation = signedArea < 0.0f ? -1.0f : 1.0f;
+                glm::vec3 tangent = orientation * (dp1 * duv2.y - dp2 * duv1.y);
+                glm::vec3 bitangent = orientation * (dp2 * duv1.x - dp1 * duv2.x);
+                if (signedArea == 0.0f) tangent = bitangent = glm::vec3(0.0f);
+
+                for (int corner = 0; corner < 3; corner++) {
+                    const glm::vec3& n = mesh.Normals[index[corner]];
+                    glm::vec3 t0 = tangent - n * glm::dot(n, tangent);
+                    glm::vec3 b0 = bitangent - n * glm::dot(n, bitangent);
+                    float tl = glm::length(t0), bl = glm::length(b0);
+
+                    glm::vec3 e1 = p[(corner + 1) % 3] - p[corner], e2 = p[(corner + 2) % 3] - p[corner];
+                    float weight = Angle(e1 - n * glm::dot(n, e1), e2 - n * glm::dot(n, e2));
+
+                    tangents[3 * t + corner] = tl > 0.0f ? t0 * (weight / tl) : glm::vec3(0.0f);
+                    bitangents[3 * t + corner] = bl > 0.0f ? b0 * (weight / bl) : glm::vec3(0.0f);
+                }
+            }
+        });
+
+        // Sum per vertex
+        Adjacency adjacency = BuildAdjacency(mesh);
+        mesh.Tangents.resize(mesh.GetVertexCount());
+        pool.ParallelFor(0, mesh.GetVertexCount(), Grain, [&](size_t first, size_t last) {
+            for (size_t v = first; v < last; v++) {
+                glm::vec3 tangent(0.0f), bitangent(0.0f);
+                for (uint32_t i = adjacency.Offsets[v]; i < adjacency.Offsets[v + 1]; i++) {
+                    tangent += tangents[adjacency.Corners[i]];
+                    bitangent += bitangents[adjacency.Corners[i]];
+                }
+
+                const glm::vec3& n = mesh.Normals[v];
+                tangent -= n * glm::dot(n, tangent);
+                float length = glm::length(tangent);
+                if (length > 0.0f) tangent /= length;
+                else tangent = glm::dot(n, n) > 0.0f ? AnyPerpendicular(n) : glm::vec3(1.0f, 0.0f, 0.0f);
+
+                float sign = glm::dot(glm::cross(n, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+                mesh.Tangents[v] = glm::vec4(tangent, sign);
+            }
+        });
+        return true;
+    }
+};
+};
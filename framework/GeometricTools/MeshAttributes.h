@@ -0,0 +1,43 @@
+#ifndef MESHATTRIBUTES_H_
+#define MESHATTRIBUTES_H_
+
+#include "Mesh.h"
+
+namespace Framework {
+
+  // Vertex normal and tangent generation for indexed meshes.
+  //
+  // Both work in three passes: per-triangle contributions (SSE2 for normals), a
+  // vertex-to-triangle adjacency table, and a per-vertex sum over that table. Large meshes
+  // run the first and last pass on the shared ThreadPool; as every vertex only reads its own
+  // adjacency list, the result does not depend on the number of threads.
+  namespace MeshAttributes {
+
+    enum class NormalWeighting {
+      Area,   // Triangles contribute in proportion to their area
+      Angle   // Triangles contribute in proportion to their angle at the vertex
+    };
+
+    /**
+     *  Replace the mesh's normals with smooth vertex normals.
+     *
+     *  Vertices not used by any triangle get a zero normal.
+     */
+    void ComputeNormals(Mesh& mesh, NormalWeighting weighting = NormalWeighting::Angle);
+
+    /**
+     *  Replace the mesh's tangents, following the MikkTSpace conventions: per-triangle
+     *  tangents from the texture coordinates, weighted by corner angle, orthogonalized
+     *  against the vertex normal, with the bitangent sign in w.
+     *
+     *  Requires normals and texture coordinates. Unlike the reference MikkTSpace code,
+     *  vertices are never split, so vertices shared across a mirrored UV seam get an
+     *  averaged tangent.
+     *
+     *  @returns false (and leaves the mesh unchanged) if normals or texture coordinates are missing
+     */
+    bool ComputeTangents(Mesh& mesh);
+  };
+};
+
+#endif // MESHATTRIBUTES_H_
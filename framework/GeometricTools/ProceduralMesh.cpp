@@ -0,0 +1,230 @@
+#include "ProceduralMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Framework {
+namespace ProceduralMesh {
+
+    namespace {
+        constexpr float Pi = 3.14159265358979323846f;
+
+        // Point of a profile curve in the (radius, y) half plane
+        struct ProfilePoint {
+            float r, y;     // Position
+            float nr, ny;   // Normal
+            float v;        // Texture coordinate along the profile
+        };
+
+        // Sweeps the profile (ordered so that y increases on the outside) around the Y axis.
+        void Revolve(Mesh& mesh, const std::vector<ProfilePoint>& profile, unsigned int segments) {
+            const uint32_t base = static_cast<uint32_t>(mesh.Positions.size());
+            const uint32_t columns = segments + 1; // Seam column duplicated for the texture coordinates
+
+            for (const auto& p : profile) {
+                for (unsigned int s = 0; s <= segments; s++) {
+                    float angle = 2.0f * Pi * s / segments;
+                    float sine = std::sin(angle), cosine = std::cos(angle);
+                    mesh.Positions.push_back({p.r * sine, p.y, p.r * cosine});
+                    mesh.Normals.push_back(glm::normalize(glm::vec3(p.nr * sine, p.ny, p.nr * cosine)));
+                    mesh.TexCoords.push_back({(float)s / segments, p.v});
+                }
+            }
+
+            for (uint32_t i = 0; i + 1 < profile.size(); i++) {
+                // Rows on the axis (poles, apex) collapse one triangle of each quad
+                const bool bottomOnAxis = profile[i].r == 0.0f;
+                const bool topOnAxis = profile[i + 1].r == 0.0f;
+                for (uint32_t s = 0; s < segments; s++) {
+                    uint32_t a = base + i * columns + s; // bottom-left
+                    uint32_t b = a + 1;                  // bottom-right
+                    uint32_t c = b + columns;            // top-right
+                    uint32_t d = a + columns;            // top-left
+                    if (!bottomOnAxis) mesh.Indices.insert(mesh.Indices.end(), {a, b, c});
+                    if (!topOnAxis) mesh.Indices.insert(mesh.Indices.end(), {a, c, d});
+                }
+            }
+        }
+
+        // Flat disk at height y facing +Y (up) or -Y.
+        void Cap(Mesh& mesh, float radius, float y, bool up, unsigned int segments) {
+            const uint32_t center = static_cast<uint32_t>(mesh.Positions.size());
+            const glm::vec3 normal(0.0f, up ? 1.0f : -1.0f, 0.0f);
+
+            mesh.Positions.push_back({0.0f, y, 0.0f});
+            mesh.Normals.push_back(normal);
+            mesh.TexCoords.push_back({0.5f, 0.5f});
+            for (unsigned int s = 0; s <= segments; s++) {
+                float angle = 2.0f * Pi * s / segments;
+                float sine = std::sin(angle), cosine = std::cos(angle);
+                mesh.Positions.push_back({radius * sine, y, radius * cosine});
+                mesh.Normals.push_back(normal);
+                mesh.TexCoords.push_back({0.5f + 0.5f * sine, 0.5f + 0.5f * cosine});
+            }
+
+            for (uint32_t s = 0; s < segments; s++) {
+                uint32_t a = center + 1 + s;
+                if (up) mesh.Indices.insert(mesh.Indices.end(), {center, a, a + 1});
+                else mesh.Indices.insert(mesh.Indices.end(), {center, a + 1, a});
+            }
+        }
+
+        // Circle arc of 'rings' steps from angle 'from' to 'to', shifted by 'yOffset'
+        void AppendArc(std::vector<ProfilePoint>& profile, float radius, float from, float to, unsigned int rings,
+                       float yOffset, float vFrom, float vTo) {
+            for (unsigned int i = 0; i <= rings; i++) {
+                float t = (float)i / rings;
+                float angle = i == rings ? to : from + (to - from) * t;
+                float cosine = std::cos(angle), sine = std::sin(angle);
+                // Exactly on the axis at the poles
+                if (std::abs(angle) == Pi / 2) cosine = 0.0f;
+                profile.push_back({radius * cosine, radius * sine + yOffset, cosine, sine, vFrom + (vTo - vFrom) * t});
+            }
+        }
+
+        struct CacheKey {
+            ShapeParams params;
+            int lod;
+
+            bool operator==(const CacheKey& r) const {
+                return params.Type == r.params.Type && params.Radius == r.params.Radius && params.Height == r.params.Height
+                    && params.TubeRadius == r.params.TubeRadius && lod == r.lod;
+            }
+        };
+
+        struct CacheKeyHash {
+            size_t operator()(const CacheKey& key) const {
+                size_t hash = std::hash<int>()(static_cast<int>(key.params.Type));
+                auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2); };
+                combine(std::hash<float>()(key.params.Radius));
+                combine(std::hash<float>()(key.params.Height));
+                combine(std::hash<float>()(key.params.TubeRadius));
+                combine(std::hash<int>()(key.lod));
+                return hash;
+            }
+        };
+
+        std::mutex CacheMutex;
+        std::unordered_map<CacheKey, std::shared_ptr<const Mesh>, CacheKeyHash> Cache;
+    }
+
+    Mesh Sphere(float radius, unsigned int segments, unsigned int rings) {
+        segments = std::max(segments, 3u);
+        rings = std::max(rings, 2u);
+
+        std::vector<ProfilePoint> profile;
+        AppendArc(profile, radius, -Pi / 2, Pi / 2, rings, 0.0f, 0.0f, 1.0f);
+
+        Mesh mesh;
+        Revolve(mesh, profile, segments);
+        return mesh;
+    }
+
+    Mesh Cylinder(float radius, float height, unsigned int segments) {
+        segments = std::max(segments, 3u);
+
+        Mesh mesh;
+        Revolve(mesh, {{radius, -height / 2, 1.0f, 0.0f, 0.0f}, {radius, height / 2, 1.0f, 0.0f, 1.0f}}, segments);
+        Cap(mesh, radius, -height / 2, false, segments);
+        Cap(mesh, radius, height / 2, true, segments);
+        return mesh;
+    }
+
+    Mesh Cone(float radius, float height, unsigned int segments) {
+        segments = std::max(segments, 3u);
+
+        // Normal of the slanted side
+        float length = std::sqrt(height * height + radius * radius);
+        float nr = height / length, ny = radius / length;
+
+        Mesh mesh;
+        Revolve(mesh, {{radius, -height / 2, nr, ny, 0.0f}, {0.0f, height / 2, nr, ny, 1.0f}}, segments);
+        Cap(mesh, radius, -height / 2, false, segments);
+        return mesh;
+    }
+
+    Mesh Torus(float radius, float tubeRadius, unsigned int segments, unsigned int sides) {
+        segments = std::max(segments, 3u);
+        sides = std::max(sides, 3u);
+
+        std::vector<ProfilePoint> profile;
+        for (unsigned int i = 0; i <= sides; i++) {
+            float angle = 2.0f * Pi * i / sides;
+            float cosine = std::cos(angle), sine = std::sin(angle);
+            profile.push_back({radius + tubeRadius * cosine, tubeRadius * sine, cosine, sine, (float)i / sides});
+        }
+
+        Mesh mesh;
+        Revolve(mesh, profile, segments);
+        return mesh;
+    }
+
+    Mesh Capsule(float radius, float height, unsigned int segments, unsigned int rings) {
+        segments = std::max(segments, 3u);
+        rings = std::max(rings, 1u);
+
+        // Texture coordinates follow the arc length of the profile
+        float total = Pi * radius + height;
+        float vCap = total > 0.0f ? (Pi * radius / 2) / total : 0.5f;
+
+        std::vector<ProfilePoint> profile;
+        AppendArc(profile, radius, -Pi / 2, 0.0f, rings, -height / 2, 0.0f, vCap);
+        AppendArc(profile, radius, 0.0f, Pi / 2, rings, height / 2, 1.0f - vCap, 1.0f);
+
+        Mesh mesh;
+        Revolve(mesh, profile, segments);
+        return mesh;
+    }
+
+
+
+    unsigned int LodSegments(int lod) {
+        lod = std::clamp(lod, 0, LodCount - 1);
+        return std::max(LodBaseSegments >> lod, 4u);
+    }
+
+    std::shared_ptr<const Mesh> GetMesh(const ShapeParams& params, int lod) {
+        CacheKey key = {params, std::clamp(lod, 0, LodCount - 1)};
+        {
+            std::lock_guard<std::mutex> lock(CacheMutex);
+            auto it = Cache.find(key);
+            if (it != Cache.end()) return it->second;
+        }
+
+        // Generate outside the lock; if another thread got there first its mesh is kept
+        unsigned int segments = LodSegments(key.lod);
+        std::shared_ptr<const Mesh> mesh;
+        switch (params.Type) {
+            case Shape::Sphere: mesh = std::make_shared<const Mesh>(Sphere(params.Radius, segments, segments / 2)); break;
+            case Shape::Cylinder: mesh = std::make_shared<const Mesh>(Cylinder(params.Radius, params.Height, segments)); break;
+            case Shape::Cone: mesh = std::make_shared<const Mesh>(Cone(params.Radius, params.Height, segments)); break;
+            case Shape::Torus: mesh = std::make_shared<const Mesh>(Torus(params.Radius, params.TubeRadius, segments, segments / 2)); break;
+            case Shape::Capsule: mesh = std::make_shared<const Mesh>(Capsule(params.Radius, params.Height, segments, segments / 4)); break;
+        }
+
+        std::lock_guard<std::mutex> lock(CacheMutex);
+        return Cache.emplace(key, mesh).first->second;
+    }
+
+    int SelectLod(float boundingRadius, float distance, float fovY, float viewportHeight, float pixelsPerSegment) {
+        if (distance <= boundingRadius) return 0;
+
+        // Projected circumference in pixels
+        float projectedRadius = boundingRadius / (distance * std::tan(fovY / 2)) * viewportHeight / 2;
+        float needed = 2.0f * Pi * projectedRadius / pixelsPerSegment;
+
+        int lod = 0;
+        while (lod + 1 < LodCount && (float)LodSegments(lod + 1) >= needed) lod++;
+        return lod;
+    }
+
+    void ClearCache() {
+        std::lock_guard<std::mutex> lock(CacheMutex);
+        Cache.clear();
+    }
+};
+};
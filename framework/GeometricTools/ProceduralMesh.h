@@ -0,0 +1,86 @@
+#ifndef PROCEDURALMESH_H_
+#define PROCEDURALMESH_H_
+
+#include <memory>
+#include "Mesh.h"
+
+namespace Framework {
+
+  // Parametric solids with normals and texture coordinates.
+  //
+  // All shapes are centered at the origin with their axis along +Y, and wound counter-clockwise
+  // seen from outside. Texture seams get duplicated vertices.
+  namespace ProceduralMesh {
+
+    /**
+     *  UV sphere.
+     *
+     *  @param segments Subdivisions around the axis (at least 3)
+     *  @param rings Subdivisions from pole to pole (at least 2)
+     */
+    Mesh Sphere(float radius, unsigned int segments, unsigned int rings);
+
+    /**
+     *  Closed cylinder from y = -height/2 to y = height/2.
+     */
+    Mesh Cylinder(float radius, float height, unsigned int segments);
+
+    /**
+     *  Closed cone with its base at y = -height/2 and its apex at y = height/2.
+     */
+    Mesh Cone(float radius, float height, unsigned int segments);
+
+    /**
+     *  Torus around the Y axis.
+     *
+     *  @param segments Subdivisions around the Y axis
+     *  @param sides Subdivisions around the tube
+     */
+    Mesh Torus(float radius, float tubeRadius, unsigned int segments, unsigned int sides);
+
+    /**
+     *  Cylinder of the given height capped with hemispheres (total height: height + 2 * radius).
+     *
+     *  @param rings Subdivisions of each hemisphere from pole to equator (at least 1)
+     */
+    Mesh Capsule(float radius, float height, unsigned int segments, unsigned int rings);
+
+
+    // Cached meshes with levels of detail.
+    //
+    // Level 0 has LodBaseSegments subdivisions around the axis, and every further level halves
+    // them. Each shape is generated once per parameter set and level; later requests return the
+    // cached mesh. Safe to call from several threads.
+
+    enum class Shape { Sphere, Cylinder, Cone, Torus, Capsule };
+
+    struct ShapeParams {
+      Shape Type = Shape::Sphere;
+      float Radius = 0.5f;
+      float Height = 1.0f;          // Cylinder, cone, capsule
+      float TubeRadius = 0.25f;     // Torus
+    };
+
+    constexpr unsigned int LodBaseSegments = 64;
+    constexpr int LodCount = 4;
+
+    // Subdivisions around the axis at a level of detail.
+    unsigned int LodSegments(int lod);
+
+    std::shared_ptr<const Mesh> GetMesh(const ShapeParams& params, int lod);
+
+    /**
+     *  Level of detail for a shape of the given bounding radius seen at 'distance' by a
+     *  perspective camera (vertical field of view 'fovY' in radians, 'viewportHeight' pixels).
+     *
+     *  Picks the coarsest level whose edges are still at most about 'pixelsPerSegment' long on
+     *  screen.
+     */
+    int SelectLod(float boundingRadius, float distance, float fovY, float viewportHeight, float pixelsPerSegment = 8.0f);
+
+    // Drop all cached meshes (meshes still in use stay alive).
+    void ClearCache();
+  };
+};
+
+#endif // PROCEDURALMESH_H_
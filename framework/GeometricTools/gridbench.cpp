@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "GridMesh.h"
+
+// GridMesh benchmark: generation time and peak memory of a large grid with colors and texture
+// coordinates, once with 16-bit index chunks and once with a single 32-bit index chunk.
+//
+//   gridbench [rows] [cols]           both index paths, each in its own process
+//   gridbench [rows] [cols] 16|32     one index path
+//
+// Peak memory only ever grows within a process, which is why the two paths run separately.
+
+using namespace Framework;
+
+namespace {
+    // Peak resident set size of this process, in MB
+    double PeakMemoryMB() {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+        return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        return usage.ru_maxrss / (1024.0 * 1024.0);     // Bytes
+#else
+        return usage.ru_maxrss / 1024.0;                // Kilobytes
+#endif
+#endif
+    }
+
+    int Run(unsigned int rows, unsigned int cols, bool wide) {
+        const double before = PeakMemoryMB();
+
+        const auto start = std::chrono::steady_clock::now();
+        // One chunk of all rows needs 32-bit indices; 0 picks the largest 16-bit chunks
+        GridMesh mesh(rows, cols, true, true, wide ? rows : 0);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const size_t bytes = mesh.GetVertices().size() * sizeof(float) + mesh.GetIndices16().size() * sizeof(uint16_t)
+                           + mesh.GetIndices32().size() * sizeof(uint32_t);
+        const double peak = PeakMemoryMB();
+        printf("%6s %9zu %12.3f %12.1f %12.1f %12.1f\n", wide ? "32-bit" : "16-bit", mesh.GetChunks().size(), seconds * 1000.0,
+               bytes / (1024.0 * 1024.0), peak, peak - before);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int rows = argc > 1 ? atoi(argv[1]) : 1000;
+    const int cols = argc > 2 ? atoi(argv[2]) : 1000;
+    const char* mode = argc > 3 ? argv[3] : nullptr;
+    if (rows < 1 || cols < 1 || (mode && strcmp(mode, "16") && strcmp(mode, "32"))) {
+        printf("usage: gridbench [rows] [cols] [16|32]\n");
+        return 1;
+    }
+
+    if (mode) return Run(rows, cols, !strcmp(mode, "32"));
+
+    printf("%d x %d tiles, colors and texture coordinates\n\n", rows, cols);
+    printf("%6s %9s %12s %12s %12s %12s\n", "index", "chunks", "time (ms)", "mesh (MB)", "peak (MB)", "growth (MB)");
+    fflush(stdout);
+    int failed = 0;
+    for (const char* path : {"16", "32"}) {
+        const std::string command = "\"" + std::string(argv[0]) + "\" " + std::to_string(rows) + " " + std::to_string(cols) + " " + path;
+        failed |= std::system(command.c_str());
+    }
+    return failed ? 1 : 0;
+}
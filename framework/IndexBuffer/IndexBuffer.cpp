@@ -3,9 +3,10 @@
 #include "IndexBuffer.h"
 
 namespace Framework {
-    IndexBuffer::IndexBuffer(GLuint *indices, GLsizei count) {
+    IndexBuffer::IndexBuffer(const GLuint *indices, GLsizei count) {
 
         Count = count; // Store count
+        Type = GL_UNSIGNED_INT;
 
         glGenBuffers(1, &IndexBufferID); // Create EBO
 
@@ -15,6 +16,19 @@ namespace Framework {
         Unbind();
     }
 
+    IndexBuffer::IndexBuffer(const GLushort *indices, GLsizei count) {
+
+        Count = count; // Store count
+        Type = GL_UNSIGNED_SHORT;
+
+        glGenBuffers(1, &IndexBufferID); // Create EBO
+
+        // Send data to EBO (GPU)
+        Bind();
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, Count * sizeof(GLushort), indices, GL_STATIC_DRAW);
+        Unbind();
+    }
+
     IndexBuffer::~IndexBuffer() {
         glDeleteBuffers(1, &IndexBufferID); // Delete buffer
     }
@@ -10,7 +10,9 @@ namespace Framework {
     // Constructor. Initializes the class with a data buffer and its size.
     // Note: The buffer will be bound upon construction, and the size is
     // specified in the number of elements, not bytes.
-    IndexBuffer(GLuint *indices, GLsizei count);
+    IndexBuffer(const GLuint *indices, GLsizei count);
+    // Same, with 16-bit indices (for meshes with at most 65536 vertices).
+    IndexBuffer(const GLushort *indices, GLsizei count);
     ~IndexBuffer();
 
     // Bind the vertex buffer.
@@ -22,9 +24,13 @@ namespace Framework {
     // Get the number of elements.
     inline GLuint GetCount() const { return Count; }
 
+    // Get the index type (GL_UNSIGNED_INT or GL_UNSIGNED_SHORT).
+    inline GLenum GetType() const { return Type; }
+
   private:
     GLuint IndexBufferID;
     GLuint Count;
+    GLenum Type;
   };
 };
 
@@ -0,0 +1,61 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Framework {
+
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& path) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+        FileHandle = file;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) return;
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) return;
+        MappingHandle = mapping;
+
+        Data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (Data) Size = static_cast<size_t>(size.QuadPart);
+    }
+
+    MappedFile::~MappedFile() {
+        if (Data) UnmapViewOfFile(Data);
+        if (MappingHandle) CloseHandle(MappingHandle);
+        if (FileHandle) CloseHandle(FileHandle);
+    }
+#else
+    MappedFile::MappedFile(const std::string& path) {
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) return;
+
+        struct stat status;
+        if (fstat(file, &status) == 0 && status.st_size > 0) {
+            void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED) {
+                Data = static_cast<const uint8_t*>(data);
+                Size = static_cast<size_t>(status.st_size);
+            }
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        close(file);
+    }
+
+    MappedFile::~MappedFile() {
+        if (Data) munmap(const_cast<uint8_t*>(Data), Size);
+    }
+#endif
+};
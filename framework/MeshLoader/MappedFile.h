@@ -0,0 +1,36 @@
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Framework {
+
+  // Read-only memory mapping of a whole file. Pages are read in by the OS on first access,
+  // so mapping a large file is cheap until its data is actually used.
+  class MappedFile {
+  public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False if the file could not be opened or mapped. Empty files are never mapped.
+    bool IsOpen() const { return Data != nullptr; }
+
+    const uint8_t* GetData() const { return Data; }
+    size_t GetSize() const { return Size; }
+
+  private:
+    const uint8_t* Data = nullptr;
+    size_t Size = 0;
+#ifdef _WIN32
+    void* FileHandle = nullptr;
+    void* MappingHandle = nullptr;
+#endif
+  };
+};
+
+#endif // MAPPEDFILE_H_
@@ -0,0 +1,324 @@
+#include "MeshLoader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "MappedFile.h"
+#include "MeshAttributes.h"
+#include "MeshOptimizer.h"
+#include "ObjParser.h"
+#include "ThreadPool.h"
+
+namespace Framework {
+namespace MeshLoader {
+
+    namespace {
+        // Cache file: header, attributes, then the vertex and index data at 16-byte aligned
+        // offsets. Native byte order; the cache is rebuilt whenever CacheVersion changes.
+        constexpr char CacheMagic[8] = {'F', 'W', 'M', 'E', 'S', 'H', 0, 0};
+        constexpr uint32_t CacheVersion = 1;
+        constexpr uint32_t MaxAttributes = 8;
+
+        struct CacheHeader {
+            char Magic[8];
+            uint32_t Version;
+            uint32_t Flags;                 // Options that change the data (CacheFlagPacked)
+            uint64_t SourceHash;
+            uint64_t SourceSize;
+            uint64_t VertexCount;
+            uint64_t IndexCount;
+            uint64_t VertexOffset;
+            uint64_t IndexOffset;
+            uint32_t Stride;
+            uint32_t IndexType;
+            uint32_t AttributeCount;
+            uint32_t Reserved;
+        };
+
+        struct CacheAttribute {
+            uint32_t Type;                  // ShaderDataType
+            uint32_t Normalized;
+            char Name[24];
+        };
+
+        static_assert(sizeof(CacheHeader) == 80, "CacheHeader must not have padding");
+        static_assert(sizeof(CacheAttribute) == 32, "CacheAttribute must not have padding");
+
+        constexpr uint32_t CacheFlagPacked = 1;
+
+        inline uint64_t AlignUp(uint64_t value) { return (value + 15) & ~uint64_t(15); }
+
+        // 64-bit hash of the source file, eight bytes at a time
+        uint64_t HashBytes(const uint8_t* data, size_t size) {
+            uint64_t hash = 0x9e3779b97f4a7c15ull ^ size;
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+                hash ^= hash >> 32;
+            }
+            uint64_t tail = 0;
+            std::memcpy(&tail, data + i, size - i);
+            hash = (hash ^ tail) * 0xc4ceb9fe1a85ec53ull;
+            return hash ^ (hash >> 29);
+        }
+
+        BufferLayout MakeLayout(const CacheAttribute* attributes, uint32_t count) {
+            std::vector<BufferAttribute> layout;
+            for (uint32_t i = 0; i < count; i++) {
+                layout.emplace_back((ShaderDataType)attributes[i].Type, attributes[i].Name, (GLboolean)attributes[i].Normalized);
+            }
+            return BufferLayout(layout);
+        }
+
+        // Mesh data built from the OBJ
+        struct BuiltMesh {
+            std::vector<uint8_t> Vertices;
+            std::vector<uint8_t> Indices;
+            std::vector<CacheAttribute> Attributes;
+            uint32_t Stride;
+            size_t VertexCount, IndexCount;
+            GLenum IndexType;
+        };
+
+        CacheAttribute Attribute(ShaderDataType type, const char* name) {
+            CacheAttribute attribute = {static_cast<uint32_t>(type), 0, {}};
+            std::strncpy(attribute.Name, name, sizeof(attribute.Name) - 1);
+            return attribute;
+        }
+
+        void Build(Mesh& mesh, bool pack, BuiltMesh& built) {
+            MeshOptimizer::OptimizeVertexCache(mesh.Indices.data(), mesh.Indices.size(), mesh.GetVertexCount());
+            MeshOptimizer::OptimizeVertexFetch(mesh);
+            mesh.Tangents.clear();
+
+            built.VertexCount = mesh.GetVertexCount();
+            built.IndexCount = mesh.Indices.size();
+
+            built.Attributes = {Attribute(ShaderDataType::Float3, "a_Position")};
+            if (pack) {
+                if (!mesh.Normals.empty()) built.Attributes.push_back(Attribute(ShaderDataType::Int2_10_10_10_Rev, "a_Normal"));
+                if (!mesh.TexCoords.empty()) built.Attributes.push_back(Attribute(ShaderDataType::Half2, "a_TexCoord"));
+                MeshOptimizer::QuantizedMesh quantized = MeshOptimizer::Quantize(mesh);
+                built.Vertices = std::move(quantized.Vertices);
+                built.Stride = static_cast<uint32_t>(quantized.Stride);
+            } else {
+                if (!mesh.Normals.empty()) built.Attributes.push_back(Attribute(ShaderDataType::Float3, "a_Normal"));
+                if (!mesh.TexCoords.empty()) built.Attributes.push_back(Attribute(ShaderDataType::Float2, "a_TexCoord"));
+                std::vector<float> interleaved = mesh.Interleave();
+                built.Vertices.resize(interleaved.size() * sizeof(float));
+                std::memcpy(built.Vertices.data(), interleaved.data(), built.Vertices.size());
+                built.Stride = static_cast<uint32_t>(mesh.GetStride() * sizeof(float));
+            }
+
+            if (built.VertexCount <= 65536) {
+                built.IndexType = GL_UNSIGNED_SHORT;
+                built.Indices.resize(built.IndexCount * sizeof(GLushort));
+                GLushort* out = reinterpret_cast<GLushort*>(built.Indices.data());
+                for (size_t i = 0; i < built.IndexCount; i++) out[i] = static_cast<GLushort>(mesh.Indices[i]);
+            } else {
+                built.IndexType = GL_UNSIGNED_INT;
+                built.Indices.resize(built.IndexCount * sizeof(GLuint));
+                std::memcpy(built.Indices.data(), mesh.Indices.data(), built.Indices.size());
+            }
+        }
+
+        // Written to a temporary file first, so a cache file is either complete or absent
+        bool WriteCache(const std::string& cachePath, const BuiltMesh& built, uint64_t sourceHash, uint64_t sourceSize, uint32_t flags) {
+            CacheHeader header = {};
+            std::memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+            header.Version = CacheVersion;
+            header.Flags = flags;
+            header.SourceHash = sourceHash;
+            header.SourceSize = sourceSize;
+            header.VertexCount = built.VertexCount;
+            header.IndexCount = built.IndexCount;
+            header.Stride = built.Stride;
+            header.IndexType = built.IndexType;
+            header.AttributeCount = static_cast<uint32_t>(built.Attributes.size());
+            header.VertexOffset = AlignUp(sizeof(CacheHeader) + built.Attributes.size() * sizeof(CacheAttribute));
+            header.IndexOffset = AlignUp(header.VertexOffset + built.Vertices.size());
+
+            std::string temporaryPath = cachePath + ".tmp";
+            {
+                std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+                if (!file) return false;
+
+                const char padding[16] = {};
+                auto pad = [&file, &padding](uint64_t offset) { file.write(padding, offset - (uint64_t)file.tellp()); };
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                file.write(reinterpret_cast<const char*>(built.Attributes.data()), built.Attributes.size() * sizeof(CacheAttribute));
+                pad(header.VertexOffset);
+                file.write(reinterpret_cast<const char*>(built.Vertices.data()), built.Vertices.size());
+                pad(header.IndexOffset);
+                file.write(reinterpret_cast<const char*>(built.Indices.data()), built.Indices.size());
+                if (!file) {
+                    file.close();
+                    std::remove(temporaryPath.c_str());
+                    return false;
+                }
+            }
+
+            std::remove(cachePath.c_str()); // rename() does not replace files on Windows
+            return std::rename(temporaryPath.c_str(), cachePath.c_str()) == 0;
+        }
+
+        // Fills 'data' from a mapped cache file if it is valid and matches the source
+        bool ReadCache(const std::shared_ptr<MappedFile>& cache, uint64_t sourceHash, uint64_t sourceSize, uint32_t flags, MeshData& data) {
+            if (!cache->IsOpen() || cache->GetSize() < sizeof(CacheHeader)) return false;
+
+            CacheHeader header;
+            std::memcpy(&header, cache->GetData(), sizeof(header));
+            if (std::memcmp(header.Magic, CacheMagic, sizeof(CacheMagic)) != 0 || header.Version != CacheVersion
+                || header.Flags != flags || header.SourceHash != sourceHash || header.SourceSize != sourceSize
+                || header.AttributeCount == 0 || header.AttributeCount > MaxAttributes) {
+                return false;
+            }
+
+            size_t indexSize = header.IndexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+            if (header.VertexOffset + header.VertexCount * header.Stride > header.IndexOffset
+                || header.IndexOffset + header.IndexCount * indexSize > cache->GetSize()) {
+                return false;
+            }
+
+            CacheAttribute attributes[MaxAttributes];
+            std::memcpy(attributes, cache->GetData() + sizeof(CacheHeader), header.AttributeCount * sizeof(CacheAttribute));
+            for (uint32_t i = 0; i < header.AttributeCount; i++) attributes[i].Name[sizeof(attributes[i].Name) - 1] = 0;
+
+            data.Layout = MakeLayout(attributes, header.AttributeCount);
+            if ((uint32_t)data.Layout.GetStride() != header.Stride) return false;
+            data.Vertices = cache->GetData() + header.VertexOffset;
+            data.VertexCount = header.VertexCount;
+            data.Indices = cache->GetData() + header.IndexOffset;
+            data.IndexCount = header.IndexCount;
+            data.IndexType = header.IndexType;
+            data.FromCache = true;
+            data.Storage = cache;
+            return true;
+        }
+    }
+
+    bool LoadOBJ(const std::string& path, Mesh& mesh) {
+        ObjData obj;
+        if (!ParseOBJ(path, obj)) return false;
+
+        // Normals and texture coordinates are only kept if every corner has them
+        const size_t corners = obj.Indices.size();
+        if (corners == 0) return false;
+        bool normals = !obj.Normals.empty(), texCoords = !obj.TexCoords.empty();
+        for (const ObjIndex& index : obj.Indices) {
+            normals = normals && index.Normal >= 0;
+            texCoords = texCoords && index.TexCoord >= 0;
+        }
+
+        // One vertex per corner, then welded
+        const size_t stride = 3 + (normals ? 3 : 0) + (texCoords ? 2 : 0);
+        std::vector<float> vertices(corners * stride);
+        ThreadPool::GetShared().ParallelFor(0, corners, 1 << 16, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                const ObjIndex& index = obj.Indices[i];
+                float* vertex = &vertices[i * stride];
+                vertex = std::copy_n(&obj.Positions[3 * index.Position], 3, vertex);
+                if (normals) vertex = std::copy_n(&obj.Normals[3 * index.Normal], 3, vertex);
+                if (texCoords) std::copy_n(&obj.TexCoords[2 * index.TexCoord], 2, vertex);
+            }
+        });
+        MeshOptimizer::WeldedVertices welded = MeshOptimizer::Weld(vertices.data(), corners, stride);
+
+        const size_t count = welded.Vertices.size() / stride;
+        mesh = Mesh();
+        mesh.Positions.resize(count);
+        if (normals) mesh.Normals.resize(count);
+        if (texCoords) mesh.TexCoords.resize(count);
+        for (size_t v = 0; v < count; v++) {
+            const float* vertex = &welded.Vertices[v * stride];
+            mesh.Positions[v] = {vertex[0], vertex[1], vertex[2]};
+            vertex += 3;
+            if (normals) {
+                mesh.Normals[v] = {vertex[0], vertex[1], vertex[2]};
+                vertex += 3;
+            }
+            if (texCoords) mesh.TexCoords[v] = {vertex[0], vertex[1]};
+        }
+        mesh.Indices = std::move(welded.Indices);
+
+        if (!normals) MeshAttributes::ComputeNormals(mesh);
+        return true;
+    }
+
+    std::string GetCachePath(const std::string& path, const Options& options) {
+        size_t slash = path.find_last_of("/\\");
+        if (options.CacheDirectory.empty()) return path + ".fwmesh";
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        char last = options.CacheDirectory.back();
+        return options.CacheDirectory + (last == '/' || last == '\\' ? "" : "/") + name + ".fwmesh";
+    }
+
+    bool LoadData(const std::string& path, MeshData& data, const Options& options) {
+        data = MeshData();
+        const uint32_t flags = options.PackVertices ? CacheFlagPacked : 0;
+
+        // The cache is keyed by the source's contents, so the source is always read (but not parsed)
+        uint64_t sourceHash = 0, sourceSize = 0;
+        std::string cachePath = GetCachePath(path, options);
+        if (options.UseCache) {
+            MappedFile source(path);
+            if (!source.IsOpen()) {
+                std::cerr << "Failed to open " << path << std::endl;
+                return false;
+            }
+            sourceHash = HashBytes(source.GetData(), source.GetSize());
+            sourceSize = source.GetSize();
+
+            auto cache = std::make_shared<MappedFile>(cachePath);
+            if (ReadCache(cache, sourceHash, sourceSize, flags, data)) return true;
+        }
+
+        Mesh mesh;
+        if (!LoadOBJ(path, mesh)) return false;
+
+        auto built = std::make_shared<BuiltMesh>();
+        Build(mesh, options.PackVertices, *built);
+        if (options.UseCache && !WriteCache(cachePath, *built, sourceHash, sourceSize, flags)) {
+            std::cerr << "Failed to write the mesh cache " << cachePath << std::endl;
+        }
+
+        data.Layout = MakeLayout(built->Attributes.data(), static_cast<uint32_t>(built->Attributes.size()));
+        data.Vertices = built->Vertices.data();
+        data.VertexCount = built->VertexCount;
+        data.Indices = built->Indices.data();
+        data.IndexCount = built->IndexCount;
+        data.IndexType = built->IndexType;
+        data.Storage = built;
+        return true;
+    }
+
+    std::shared_ptr<VertexArray> Upload(const MeshData& data) {
+        if (!data.Vertices || !data.Indices) return nullptr;
+
+        auto vertexBuffer = std::make_shared<VertexBuffer>(data.Vertices, (GLsizei)(data.VertexCount * data.Layout.GetStride()));
+        vertexBuffer->SetLayout(data.Layout);
+
+        std::shared_ptr<IndexBuffer> indexBuffer;
+        if (data.IndexType == GL_UNSIGNED_SHORT) {
+            indexBuffer = std::make_shared<IndexBuffer>(static_cast<const GLushort*>(data.Indices), (GLsizei)data.IndexCount);
+        } else {
+            indexBuffer = std::make_shared<IndexBuffer>(static_cast<const GLuint*>(data.Indices), (GLsizei)data.IndexCount);
+        }
+
+        auto vertexArray = std::make_shared<VertexArray>();
+        vertexArray->AddVertexBuffer(vertexBuffer);
+        vertexArray->SetIndexBuffer(indexBuffer);
+        return vertexArray;
+    }
+
+    std::shared_ptr<VertexArray> Load(const std::string& path, const Options& options) {
+        MeshData data;
+        if (!LoadData(path, data, options)) return nullptr;
+        return Upload(data);
+    }
+};
+};
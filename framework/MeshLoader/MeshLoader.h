@@ -0,0 +1,73 @@
+#ifndef MESHLOADER_H_
+#define MESHLOADER_H_
+
+#include <glad/glad.h>
+
+#include <memory>
+#include <string>
+#include "BufferLayout.h"
+#include "Mesh.h"
+#include "VertexArray.h"
+
+namespace Framework {
+
+  // OBJ loading into indexed VertexArrays, with a binary cache.
+  //
+  // The first load of a model parses the OBJ (ParseOBJ, in parallel), welds its vertices, optimizes the
+  // index order and packs the vertices (MeshOptimizer), then writes the result to a cache file
+  // next to the model (or in Options::CacheDirectory). The cache holds the OBJ's hash, so later
+  // loads only hash the OBJ, map the cache into memory and upload from the mapping. A changed
+  // OBJ, different options or a different cache version simply rebuild the cache.
+  //
+  // Vertex attributes are, in this order and only when the OBJ has them (normals are
+  // generated if it has none):
+  //
+  //   location 0  a_Position   Float3
+  //   location 1  a_Normal     Float3, or Int2_10_10_10_Rev when packed
+  //   location 2  a_TexCoord   Float2, or Half2 when packed
+  namespace MeshLoader {
+
+    struct Options {
+      bool UseCache = true;
+      std::string CacheDirectory;         // Empty: the model's directory
+      bool PackVertices = true;           // Packed normals and texture coordinates (32 -> 20 bytes per vertex)
+    };
+
+    // Vertex and index data ready for upload. The pointers refer either to a memory-mapped
+    // cache file or to buffers owned by Storage, which keeps them alive.
+    struct MeshData {
+      BufferLayout Layout;
+      const void* Vertices = nullptr;
+      size_t VertexCount = 0;
+      const void* Indices = nullptr;
+      size_t IndexCount = 0;
+      GLenum IndexType = GL_UNSIGNED_INT; // GL_UNSIGNED_SHORT when there are at most 65536 vertices
+      bool FromCache = false;
+      std::shared_ptr<const void> Storage;
+    };
+
+    /**
+     *  Parse an OBJ file (all of its shapes) into an indexed mesh with welded vertices.
+     *
+     *  @returns false if the file could not be read or has no triangles
+     */
+    bool LoadOBJ(const std::string& path, Mesh& mesh);
+
+    /**
+     *  Load the mesh data from the cache, or from the OBJ (writing the cache). Does not use
+     *  OpenGL, so it can run on any thread.
+     */
+    bool LoadData(const std::string& path, MeshData& data, const Options& options = Options());
+
+    // Create the buffers (OpenGL thread).
+    std::shared_ptr<VertexArray> Upload(const MeshData& data);
+
+    // LoadData and Upload. Returns nullptr on failure.
+    std::shared_ptr<VertexArray> Load(const std::string& path, const Options& options = Options());
+
+    // Path of the model's cache file.
+    std::string GetCachePath(const std::string& path, const Options& options = Options());
+  };
+};
+
+#endif // MESHLOADER_H_
@@ -0,0 +1,359 @@
+#include "ObjParser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+// Floating-point from_chars is missing from some standard libraries (libc++), which then do
+// not define __cpp_lib_to_chars
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#if defined(__cpp_lib_to_chars) || (defined(_MSC_VER) && _MSC_VER >= 1924)
+#define OBJPARSER_FROM_CHARS
+#endif
+
+namespace Framework {
+namespace MeshLoader {
+
+    namespace {
+        // Bytes per chunk. Each chunk is parsed by one task, so this is the parallel grain.
+        constexpr size_t ChunkSize = 1 << 20;
+
+        // Relative face indices that refer to the vertices of earlier chunks can only be resolved
+        // once the chunks' vertex counts are known. Until then they are stored as the index into
+        // the chunk's own vertices (negative when the vertex is in an earlier chunk) minus this
+        // bias, which keeps them apart from absolute indices (>= 0) and missing ones (-1).
+        constexpr int RelativeBias = 1 << 30;
+
+        struct Chunk {
+            const char* Begin;
+            const char* End;
+            std::vector<float> Positions, Normals, TexCoords;
+            std::vector<ObjIndex> Corners;      // Of all faces, in order
+            std::vector<uint32_t> FaceSizes;
+            std::vector<ObjIndex> Triangles;
+            bool Valid = true;
+        };
+
+        inline bool IsSpace(char c) { return c == ' ' || c == '\t'; }
+        inline bool IsTokenEnd(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        inline const char* SkipSpaces(const char* p, const char* end) {
+            while (p < end && IsSpace(*p)) p++;
+            return p;
+        }
+
+        // Next whitespace-separated number of the line, or 'fallback' if it is missing or invalid
+        inline float ParseFloat(const char*& p, const char* end, float fallback) {
+            p = SkipSpaces(p, end);
+            const char* tokenEnd = p;
+            while (tokenEnd < end && !IsTokenEnd(*tokenEnd)) tokenEnd++;
+
+            const char* first = p;
+            p = tokenEnd;
+            if (first < tokenEnd && *first == '+') first++; // from_chars does not take a leading '+'
+            if (first == tokenEnd) return fallback;
+
+            float value = fallback;
+#ifdef OBJPARSER_FROM_CHARS
+            if (std::from_chars(first, tokenEnd, value).ec != std::errc()) return fallback;
+#else
+            // strtof needs a terminated string; the mapping is not
+            char buffer[64];
+            size_t length = std::min<size_t>(tokenEnd - first, sizeof(buffer) - 1);
+            std::memcpy(buffer, first, length);
+            buffer[length] = 0;
+            char* parsed;
+            value = std::strtof(buffer, &parsed);
+            if (parsed == buffer) return fallback;
+#endif
+            return value;
+        }
+
+        inline int ParseInt(const char*& p, const char* end) {
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+            int value = 0;
+            while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+            return negative ? -value : value;
+        }
+
+        // OBJ index (1-based, or negative relative to 'count') to the chunk encoding. False for 0.
+        inline bool FixIndex(int index, size_t count, int& result) {
+            if (index > 0) result = index - 1;
+            else if (index < 0) result = static_cast<int>(count) + index - RelativeBias;
+            else return false;
+            return true;
+        }
+
+        // v/vt/vn, v//vn, v/vt or v
+        bool ParseCorner(const char*& p, const char* end, const Chunk& chunk, ObjIndex& corner) {
+            corner = {-1, -1, -1};
+            if (!FixIndex(ParseInt(p, end), chunk.Positions.size() / 3, corner.Position)) return false;
+            if (p >= end || *p != '/') return true;
+            p++;
+            if (p < end && *p != '/') {
+                if (!FixIndex(ParseInt(p, end), chunk.TexCoords.size() / 2, corner.TexCoord)) return false;
+            }
+            if (p >= end || *p != '/') return true;
+            p++;
+            return FixIndex(ParseInt(p, end), chunk.Normals.size() / 3, corner.Normal);
+        }
+
+        void ParseChunk(Chunk& chunk) {
+            std::vector<ObjIndex> face;
+            const char* line = chunk.Begin;
+            while (line < chunk.End) {
+                const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', chunk.End - line));
+                if (!lineEnd) lineEnd = chunk.End;
+
+                const char* p = SkipSpaces(line, lineEnd);
+                const size_t length = lineEnd - p;
+                line = lineEnd + 1;
+                if (length < 2 || p[0] == '#') continue;
+
+                if (p[0] == 'v' && IsSpace(p[1])) {
+                    p += 2;
+                    for (int i = 0; i < 3; i++) chunk.Positions.push_back(ParseFloat(p, lineEnd, 0.0f));
+                } else if (p[0] == 'v' && p[1] == 'n' && length > 2 && IsSpace(p[2])) {
+                    p += 3;
+                    for (int i = 0; i < 3; i++) chunk.Normals.push_back(ParseFloat(p, lineEnd, 0.0f));
+                } else if (p[0] == 'v' && p[1] == 't' && length > 2 && IsSpace(p[2])) {
+                    p += 3;
+                    for (int i = 0; i < 2; i++) chunk.TexCoords.push_back(ParseFloat(p, lineEnd, 0.0f));
+                } else if (p[0] == 'f' && IsSpace(p[1])) {
+                    p = SkipSpaces(p + 2, lineEnd);
+                    face.clear();
+                    while (p < lineEnd && *p != '\r') {
+                        ObjIndex corner;
+                        if (!ParseCorner(p, lineEnd, chunk, corner)) {
+                            chunk.Valid = false;
+                            return;
+                        }
+                        face.push_back(corner);
+                        while (p < lineEnd && IsTokenEnd(*p)) p++;
+                    }
+                    if (face.size() >= 3) {
+                        chunk.Corners.insert(chunk.Corners.end(), face.begin(), face.end());
+                        chunk.FaceSizes.push_back(static_cast<uint32_t>(face.size()));
+                    }
+                }
+            }
+        }
+
+        // Chunk encoding to the final index; false if out of range
+        inline bool ResolveIndex(int& index, size_t base, size_t count) {
+            if (index == -1) return true;
+            long long resolved = index >= 0 ? index : static_cast<long long>(base) + index + RelativeBias;
+            if (resolved < 0 || resolved >= static_cast<long long>(count)) return false;
+            index = static_cast<int>(resolved);
+            return true;
+        }
+
+        // Crossing test of pnpoly (W. Randolph Franklin) for a triangle
+        inline bool InsideTriangle(const float* x, const float* y, float px, float py) {
+            bool inside = false;
+            for (int i = 0, j = 2; i < 3; j = i++) {
+                if ((y[i] > py) != (y[j] > py) && px < (x[j] - x[i]) * (py - y[i]) / (y[j] - y[i]) + x[i]) inside = !inside;
+            }
+            return inside;
+        }
+
+        // Ear clipping in the plane of the two axes that the face spans best. This follows
+        // tinyobjloader's triangulation step by step (same float operations), so that non-convex
+        // faces are split into the same triangles as before.
+        void Triangulate(const ObjIndex* face, size_t count, const std::vector<float>& positions,
+                         std::vector<ObjIndex>& remaining, std::vector<ObjIndex>& triangles) {
+            if (count == 3) {
+                triangles.insert(triangles.end(), face, face + 3);
+                return;
+            }
+            auto coordinate = [&positions](const ObjIndex& corner, size_t axis) { return positions[3 * corner.Position + axis]; };
+
+            // Drop the axis of the largest normal component of the first non-degenerate corner
+            size_t axes[2] = {1, 2};
+            for (size_t k = 0; k < count; k++) {
+                const ObjIndex& i0 = face[k];
+                const ObjIndex& i1 = face[(k + 1) % count];
+                const ObjIndex& i2 = face[(k + 2) % count];
+                float e0x = coordinate(i1, 0) - coordinate(i0, 0), e0y = coordinate(i1, 1) - coordinate(i0, 1), e0z = coordinate(i1, 2) - coordinate(i0, 2);
+                float e1x = coordinate(i2, 0) - coordinate(i1, 0), e1y = coordinate(i2, 1) - coordinate(i1, 1), e1z = coordinate(i2, 2) - coordinate(i1, 2);
+                float cx = std::fabs(e0y * e1z - e0z * e1y);
+                float cy = std::fabs(e0z * e1x - e0x * e1z);
+                float cz = std::fabs(e0x * e1y - e0y * e1x);
+                const float epsilon = std::numeric_limits<float>::epsilon();
+                if (cx > epsilon || cy > epsilon || cz > epsilon) {
+                    if (!(cx > cy && cx > cz)) {
+                        axes[0] = 0;
+                        if (cz > cx && cz > cy) axes[1] = 1;
+                    }
+                    break;
+                }
+            }
+
+            float area = 0.0f;
+            for (size_t k = 0; k < count; k++) {
+                const ObjIndex& i0 = face[k];
+                const ObjIndex& i1 = face[(k + 1) % count];
+                area += (coordinate(i0, axes[0]) * coordinate(i1, axes[1]) - coordinate(i0, axes[1]) * coordinate(i1, axes[0])) * 0.5f;
+            }
+
+            // Clip ears until a triangle is left, giving up after a full round without one
+            remaining.assign(face, face + count);
+            size_t guess = 0, iterationsLeft = count, previousCount = count;
+            while (remaining.size() > 3 && iterationsLeft > 0) {
+                const size_t n = remaining.size();
+                if (guess >= n) guess -= n;
+                if (previousCount != n) {
+                    previousCount = n;
+                    iterationsLeft = n;
+                } else {
+                    iterationsLeft--;
+                }
+
+                ObjIndex ear[3];
+                float x[3], y[3];
+                for (size_t k = 0; k < 3; k++) {
+                    ear[k] = remaining[(guess + k) % n];
+                    x[k] = coordinate(ear[k], axes[0]);
+                    y[k] = coordinate(ear[k], axes[1]);
+                }
+                float cross = (x[1] - x[0]) * (y[2] - y[1]) - (y[1] - y[0]) * (x[2] - x[1]);
+                if (cross * area < 0.0f) {
+                    guess++;
+                    continue;
+                }
+
+                bool overlap = false;
+                for (size_t other = 3; other < n && !overlap; other++) {
+                    const ObjIndex& corner = remaining[(guess + other) % n];
+                    overlap = InsideTriangle(x, y, coordinate(corner, axes[0]), coordinate(corner, axes[1]));
+                }
+                if (overlap) {
+                    guess++;
+                    continue;
+                }
+
+                triangles.insert(triangles.end(), ear, ear + 3);
+                remaining.erase(remaining.begin() + (guess + 1) % n);
+            }
+            if (remaining.size() == 3) triangles.insert(triangles.end(), remaining.begin(), remaining.end());
+        }
+    }
+
+    bool ParseOBJ(const std::string& path, ObjData& data) {
+        return ParseOBJ(path, data, ThreadPool::GetShared());
+    }
+
+    bool ParseOBJ(const std::string& path, ObjData& data, ThreadPool& pool) {
+        data = ObjData();
+        MappedFile file(path);
+        if (!file.IsOpen()) {
+            std::cerr << "Failed to open " << path << std::endl;
+            return false;
+        }
+
+        // Split at the first line break after every ChunkSize bytes
+        const char* begin = reinterpret_cast<const char*>(file.GetData());
+        const char* end = begin + file.GetSize();
+        std::vector<Chunk> chunks;
+        for (const char* p = begin; p < end;) {
+            const char* next = p + std::min<size_t>(ChunkSize, end - p);
+            if (next < end) {
+                next = static_cast<const char*>(std::memchr(next, '\n', end - next));
+                next = next ? next + 1 : end;
+            }
+            chunks.push_back(Chunk());
+            chunks.back().Begin = p;
+            chunks.back().End = next;
+            p = next;
+        }
+
+        pool.ParallelFor(0, chunks.size(), 1, [&chunks](size_t first, size_t last) {
+            for (size_t c = first; c < last; c++) ParseChunk(chunks[c]);
+        });
+
+        // Offsets of each chunk's vertex data in the merged arrays
+        const size_t chunkCount = chunks.size();
+        std::vector<size_t> positionBase(chunkCount + 1, 0), normalBase(chunkCount + 1, 0), texCoordBase(chunkCount + 1, 0);
+        for (size_t c = 0; c < chunkCount; c++) {
+            if (!chunks[c].Valid) {
+                std::cerr << "Failed to parse " << path << ": invalid face index" << std::endl;
+                return false;
+            }
+            positionBase[c + 1] = positionBase[c] + chunks[c].Positions.size();
+            normalBase[c + 1] = normalBase[c] + chunks[c].Normals.size();
+            texCoordBase[c + 1] = texCoordBase[c] + chunks[c].TexCoords.size();
+        }
+
+        data.Positions.resize(positionBase.back());
+        data.Normals.resize(normalBase.back());
+        data.TexCoords.resize(texCoordBase.back());
+        pool.ParallelFor(0, chunkCount, 1, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; c++) {
+                Chunk& chunk = chunks[c];
+                std::copy(chunk.Positions.begin(), chunk.Positions.end(), data.Positions.begin() + positionBase[c]);
+                std::copy(chunk.Normals.begin(), chunk.Normals.end(), data.Normals.begin() + normalBase[c]);
+                std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), data.TexCoords.begin() + texCoordBase[c]);
+                chunk.Positions = std::vector<float>();
+                chunk.Normals = std::vector<float>();
+                chunk.TexCoords = std::vector<float>();
+            }
+        });
+
+        // Resolve the indices and triangulate; faces may use positions of any chunk
+        std::atomic<bool> valid{true};
+        pool.ParallelFor(0, chunkCount, 1, [&](size_t first, size_t last) {
+            std::vector<ObjIndex> remaining;
+            for (size_t c = first; c < last; c++) {
+                Chunk& chunk = chunks[c];
+                bool chunkValid = true;
+                for (ObjIndex& corner : chunk.Corners) {
+                    chunkValid &= ResolveIndex(corner.Position, positionBase[c] / 3, data.Positions.size() / 3);
+                    chunkValid &= ResolveIndex(corner.TexCoord, texCoordBase[c] / 2, data.TexCoords.size() / 2);
+                    chunkValid &= ResolveIndex(corner.Normal, normalBase[c] / 3, data.Normals.size() / 3);
+                }
+                if (!chunkValid) {
+                    valid = false;
+                    continue;
+                }
+
+                if (chunk.Corners.size() == 3 * chunk.FaceSizes.size()) {
+                    chunk.Triangles.swap(chunk.Corners);
+                } else {
+                    const ObjIndex* face = chunk.Corners.data();
+                    for (uint32_t size : chunk.FaceSizes) {
+                        Triangulate(face, size, data.Positions, remaining, chunk.Triangles);
+                        face += size;
+                    }
+                    chunk.Corners = std::vector<ObjIndex>();
+                }
+            }
+        });
+        if (!valid) {
+            std::cerr << "Failed to parse " << path << ": face index out of range" << std::endl;
+            data = ObjData();
+            return false;
+        }
+
+        std::vector<size_t> indexBase(chunkCount + 1, 0);
+        for (size_t c = 0; c < chunkCount; c++) indexBase[c + 1] = indexBase[c] + chunks[c].Triangles.size();
+        data.Indices.resize(indexBase.back());
+        pool.ParallelFor(0, chunkCount, 1, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; c++) {
+                std::copy(chunks[c].Triangles.begin(), chunks[c].Triangles.end(), data.Indices.begin() + indexBase[c]);
+                chunks[c].Triangles = std::vector<ObjIndex>();
+            }
+        });
+        return true;
+    }
+};
+};
@@ -0,0 +1,43 @@
+#ifndef OBJPARSER_H_
+#define OBJPARSER_H_
+
+#include <string>
+#include <vector>
+
+namespace Framework {
+
+  class ThreadPool;
+
+  namespace MeshLoader {
+
+    // Zero-based attribute indices of one triangle corner, -1 when the corner has none
+    struct ObjIndex {
+      int Position;
+      int TexCoord;
+      int Normal;
+    };
+
+    // Geometry of an OBJ file, with every face triangulated the way tinyobjloader does it.
+    // Groups, objects and materials are ignored, so the faces of all shapes are in file order.
+    struct ObjData {
+      std::vector<float> Positions;       // x, y, z
+      std::vector<float> Normals;         // x, y, z
+      std::vector<float> TexCoords;       // u, v
+      std::vector<ObjIndex> Indices;      // Three per triangle
+    };
+
+    /**
+     *  Parse the v, vn, vt and f records of an OBJ file.
+     *
+     *  The file is memory-mapped and split at line boundaries into chunks that are parsed in
+     *  parallel on 'pool'; negative (relative) face indices are resolved when the chunks are
+     *  merged, so the result does not depend on the thread count.
+     *
+     *  @returns false if the file could not be read or a face refers to a missing vertex
+     */
+    bool ParseOBJ(const std::string& path, ObjData& data);
+    bool ParseOBJ(const std::string& path, ObjData& data, ThreadPool& pool);
+  };
+};
+
+#endif // OBJPARSER_H_
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "MeshLoader.h"
+
+// MeshLoader benchmark: LoadData of the teacup and of a generated UV sphere of about a million
+// triangles, cold (parsing the OBJ and writing the cache) and warm (from the memory-mapped
+// cache). Both must return the same layout, vertex and index bytes. The times include reading
+// every byte of the result, since a warm load only maps the cache.
+//
+//   loadbench [sphere segments] [runs]
+
+using namespace Framework;
+
+namespace {
+    double Milliseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    size_t VertexBytes(const MeshLoader::MeshData& data) { return data.VertexCount * data.Layout.GetStride(); }
+    size_t IndexBytes(const MeshLoader::MeshData& data) {
+        return data.IndexCount * (data.IndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t));
+    }
+
+    // Reads every byte, so lazily mapped pages count towards the load
+    uint32_t Touch(const MeshLoader::MeshData& data) {
+        uint32_t sum = 0;
+        const unsigned char* vertices = static_cast<const unsigned char*>(data.Vertices);
+        for (size_t i = 0; i < VertexBytes(data); i++) sum += vertices[i];
+        const unsigned char* indices = static_cast<const unsigned char*>(data.Indices);
+        for (size_t i = 0; i < IndexBytes(data); i++) sum += indices[i];
+        return sum;
+    }
+
+    bool SameLayout(const BufferLayout& a, const BufferLayout& b) {
+        if (a.GetStride() != b.GetStride() || a.GetAttributes().size() != b.GetAttributes().size()) return false;
+        for (size_t i = 0; i < a.GetAttributes().size(); i++) {
+            const BufferAttribute& x = a.GetAttributes()[i];
+            const BufferAttribute& y = b.GetAttributes()[i];
+            if (x.Type != y.Type || x.Offset != y.Offset || x.Normalized != y.Normalized) return false;
+        }
+        return true;
+    }
+
+    // A UV sphere with normals and texture coordinates: 2 * segments * (segments / 2) triangles
+    bool WriteSphere(const std::string& path, int segments) {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        const int rings = segments / 2;
+        for (int r = 0; r <= rings; r++) {
+            const float theta = 3.14159265f * r / rings;
+            for (int s = 0; s <= segments; s++) {
+                const float phi = 6.28318531f * s / segments;
+                const float x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = std::sin(theta) * std::sin(phi);
+                fprintf(file, "v %f %f %f\nvn %f %f %f\nvt %f %f\n", x, y, z, x, y, z, static_cast<float>(s) / segments,
+                        static_cast<float>(r) / rings);
+            }
+        }
+        for (int r = 0; r < rings; r++) {
+            for (int s = 0; s < segments; s++) {
+                const int a = r * (segments + 1) + s + 1, b = a + segments + 1;
+                fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, a + 1, a + 1, a + 1);
+                fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a + 1, a + 1, a + 1, b, b, b, b + 1, b + 1, b + 1);
+            }
+        }
+        return fclose(file) == 0;
+    }
+
+    // Returns false if the cold and warm loads differ or fail
+    bool Run(const std::string& name, const std::string& path, int runs) {
+        MeshLoader::Options options;
+        options.CacheDirectory = ".";
+        const std::string cachePath = MeshLoader::GetCachePath(path, options);
+
+        double coldMs = 1e30, warmMs = 1e30;
+        MeshLoader::MeshData cold, warm;
+        uint32_t coldSum = 0, warmSum = 0;
+        for (int run = 0; run < runs; run++) {
+            std::remove(cachePath.c_str());
+            auto start = std::chrono::steady_clock::now();
+            if (!MeshLoader::LoadData(path, cold, options) || cold.FromCache) {
+                printf("%s: cold load failed\n", name.c_str());
+                return false;
+            }
+            coldSum = Touch(cold);
+            coldMs = std::min(coldMs, Milliseconds(start));
+
+            start = std::chrono::steady_clock::now();
+            if (!MeshLoader::LoadData(path, warm, options) || !warm.FromCache) {
+                printf("%s: warm load did not use the cache\n", name.c_str());
+                return false;
+            }
+            warmSum = Touch(warm);
+            warmMs = std::min(warmMs, Milliseconds(start));
+        }
+
+        const bool same = SameLayout(cold.Layout, warm.Layout) && cold.IndexType == warm.IndexType
+                       && cold.VertexCount == warm.VertexCount && cold.IndexCount == warm.IndexCount && coldSum == warmSum
+                       && std::memcmp(cold.Vertices, warm.Vertices, VertexBytes(cold)) == 0
+                       && std::memcmp(cold.Indices, warm.Indices, IndexBytes(cold)) == 0;
+        printf("%-8s %9zu %9zu %6d %12.1f %12.1f %8.1fx  %s\n", name.c_str(), cold.IndexCount / 3, cold.VertexCount,
+               cold.Layout.GetStride(), coldMs, warmMs, coldMs / warmMs, same ? "identical" : "DIFFER");
+
+        // The mapping must go before the file
+        cold = MeshLoader::MeshData();
+        warm = MeshLoader::MeshData();
+        std::remove(cachePath.c_str());
+        return same;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int segments = argc > 1 ? atoi(argv[1]) : 1000;
+    const int runs = argc > 2 ? atoi(argv[2]) : 3;
+    if (segments < 4 || runs < 1) {
+        printf("usage: loadbench [sphere segments >= 4] [runs]\n");
+        return 1;
+    }
+
+    const std::string sphere = "loadbench_sphere.obj";
+    if (!WriteSphere(sphere, segments)) {
+        printf("could not write %s\n", sphere.c_str());
+        return 1;
+    }
+
+    printf("best of %d runs, cache in the working directory\n\n", runs);
+    printf("%-8s %9s %9s %6s %12s %12s %9s\n", "model", "triangles", "vertices", "stride", "cold (ms)", "warm (ms)", "speedup");
+    bool same = Run("teacup", std::string(MODELS_DIR) + "/teacup.obj", runs);
+    same = Run("sphere", sphere, runs) && same;
+    std::remove(sphere.c_str());
+
+    return same ? 0 : 1;
+}
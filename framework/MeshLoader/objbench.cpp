@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <tiny_obj_loader.h>
+
+#include "ObjParser.h"
+#include "ThreadPool.h"
+
+// OBJ parser check and benchmark: ParseOBJ must give the same attributes (bit for bit) and the
+// same triangulated corners as tinyobj::LoadObj, on the teacup and on a generated file, with
+// every thread count. The generated file has CRLF line endings, comments and groups, and
+// polygons of 3 to 9 corners, many of them non-convex, whose corners refer back with relative
+// (negative) indices, some to vertices more than a chunk (1 MiB) earlier.
+//
+//   objbench [polygons] [max threads] [obj...]
+
+using namespace Framework;
+
+namespace {
+    double Milliseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Writes the generated file; returns false if it could not be written
+    bool WriteGenerated(const std::string& path, int polygons) {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+
+        uint64_t state = 99;
+        auto random = [&state]() {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<uint32_t>(state >> 33);
+        };
+        auto unit = [&]() { return random() / static_cast<float>(1u << 31) - 1.0f; };
+
+        struct Polygon {
+            long FirstVertex;       // One-based, as in the file
+            int Corners;
+        };
+        std::vector<Polygon> written;
+        long vertices = 0;
+
+        fprintf(file, "# objbench: CRLF, relative indices, non-convex polygons\r\n");
+        for (int i = 0; i < polygons; i++) {
+            if (i % 1000 == 0) fprintf(file, "\r\no part%d\r\ng group%d\r\n", i / 1000, i % 3000);
+
+            // A star-shaped polygon in a random plane: every other corner pulled in makes it
+            // non-convex from five corners on
+            const int corners = 3 + static_cast<int>(random() % 7);
+            const float cx = unit() * 100.0f, cy = unit() * 100.0f, cz = unit() * 100.0f;
+            const float tilt = unit();
+            for (int c = 0; c < corners; c++) {
+                const float angle = 6.2831853f * c / corners;
+                const float radius = (c % 2 && corners > 4) ? 0.3f + 0.2f * (unit() + 1.0f) : 1.0f;
+                const float x = cx + radius * std::cos(angle), y = cy + radius * std::sin(angle), z = cz + tilt * radius * std::cos(angle);
+                if (random() % 4 == 0) {
+                    fprintf(file, "v %.9g %.9g %.9g\r\n", x, y, z);
+                } else {
+                    fprintf(file, "v  %f\t%f %e\r\n", x, y, z);
+                }
+                fprintf(file, "vt %.6f %.6f\r\n", (std::cos(angle) + 1.0f) / 2.0f, (std::sin(angle) + 1.0f) / 2.0f);
+                fprintf(file, "vn 0 %.7g 1\r\n", -tilt);
+            }
+            vertices += corners;
+            written.push_back({vertices - corners + 1, corners});
+
+            // The face of this polygon, or now and then again one written long before
+            const Polygon& polygon = (random() % 8 == 0) ? written[random() % written.size()] : written.back();
+            const bool relative = random() % 2 == 0;
+            fprintf(file, "f");
+            for (int c = 0; c < polygon.Corners; c++) {
+                const long index = relative ? polygon.FirstVertex + c - vertices - 1 : polygon.FirstVertex + c;
+                if (random() % 3 == 0) {
+                    fprintf(file, " %ld//%ld", index, index);
+                } else {
+                    fprintf(file, " %ld/%ld/%ld", index, index, index);
+                }
+            }
+            fprintf(file, "\r\n");
+        }
+        return fclose(file) == 0;
+    }
+
+    // Number of differing floats, or -1 if the sizes differ
+    long Compare(const std::vector<float>& a, const std::vector<float>& b) {
+        if (a.size() != b.size()) return -1;
+        long differ = 0;
+        for (size_t i = 0; i < a.size(); i++) differ += std::memcmp(&a[i], &b[i], sizeof(float)) != 0;
+        return differ;
+    }
+
+    bool Same(const MeshLoader::ObjData& a, const MeshLoader::ObjData& b) {
+        return Compare(a.Positions, b.Positions) == 0 && Compare(a.Normals, b.Normals) == 0 && Compare(a.TexCoords, b.TexCoords) == 0
+            && a.Indices.size() == b.Indices.size()
+            && std::memcmp(a.Indices.data(), b.Indices.data(), a.Indices.size() * sizeof(MeshLoader::ObjIndex)) == 0;
+    }
+
+    // Returns false on any difference
+    bool Run(const std::string& path, const std::vector<unsigned int>& threadCounts) {
+        // Reference
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warning, error;
+        const size_t slash = path.find_last_of("/\\");
+        const std::string directory = slash == std::string::npos ? "./" : path.substr(0, slash + 1);
+        auto start = std::chrono::steady_clock::now();
+        const bool loaded = tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &error, path.c_str(), directory.c_str());
+        const double tinyobjMs = Milliseconds(start);
+        if (!loaded) {
+            printf("%s: tinyobjloader failed: %s\n", path.c_str(), error.c_str());
+            return false;
+        }
+        std::vector<tinyobj::index_t> corners;
+        for (const tinyobj::shape_t& shape : shapes) corners.insert(corners.end(), shape.mesh.indices.begin(), shape.mesh.indices.end());
+
+        printf("%s\n  tinyobjloader            %9.1f ms\n", path.c_str(), tinyobjMs);
+
+        bool same = true;
+        MeshLoader::ObjData first;
+        for (unsigned int threads : threadCounts) {
+            ThreadPool pool(threads);
+            MeshLoader::ObjData data;
+            start = std::chrono::steady_clock::now();
+            const bool parsed = MeshLoader::ParseOBJ(path, data, pool);
+            const double ms = Milliseconds(start);
+
+            long cornersDiffer = corners.size() == data.Indices.size() ? 0 : -1;
+            for (size_t i = 0; cornersDiffer >= 0 && i < corners.size(); i++) {
+                const MeshLoader::ObjIndex& index = data.Indices[i];
+                cornersDiffer += corners[i].vertex_index != index.Position || corners[i].texcoord_index != index.TexCoord
+                              || corners[i].normal_index != index.Normal;
+            }
+            const long positions = Compare(attrib.vertices, data.Positions);
+            const long normals = Compare(attrib.normals, data.Normals);
+            const long texCoords = Compare(attrib.texcoords, data.TexCoords);
+            const bool matches = parsed && positions == 0 && normals == 0 && texCoords == 0 && cornersDiffer == 0;
+            const bool stable = threads == threadCounts.front() || Same(first, data);
+            if (threads == threadCounts.front()) first = std::move(data);
+
+            printf("  ParseOBJ, %2u thread%s     %9.1f ms  %5.2fx", threads, threads == 1 ? " " : "s", ms, tinyobjMs / ms);
+            if (matches && stable) {
+                printf("  identical\n");
+            } else {
+                printf("  DIFFERS: positions %ld, normals %ld, texcoords %ld, corners %ld%s\n", positions, normals, texCoords,
+                       cornersDiffer, stable ? "" : ", output depends on the thread count");
+            }
+            same = same && matches && stable;
+        }
+        printf("  %zu positions, %zu triangles\n\n", attrib.vertices.size() / 3, corners.size() / 3);
+        return same;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int polygons = argc > 1 ? atoi(argv[1]) : 40000;
+    const unsigned int maxThreads = argc > 2 ? static_cast<unsigned int>(atoi(argv[2])) : std::max(1u, std::thread::hardware_concurrency());
+    if (polygons < 1 || maxThreads < 1) {
+        printf("usage: objbench [polygons] [max threads] [obj...]\n");
+        return 1;
+    }
+
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    std::vector<std::string> paths;
+    for (int i = 3; i < argc; i++) paths.push_back(argv[i]);
+    if (paths.empty()) paths.push_back(std::string(MODELS_DIR) + "/teacup.obj");
+
+    const std::string generated = "objbench_generated.obj";
+    if (!WriteGenerated(generated, polygons)) {
+        printf("could not write %s\n", generated.c_str());
+        return 1;
+    }
+    paths.push_back(generated);
+
+    printf("%u hardware threads\n\n", std::thread::hardware_concurrency());
+    bool same = true;
+    for (const std::string& path : paths) same = Run(path, threadCounts) && same;
+    std::remove(generated.c_str());
+
+    return same ? 0 : 1;
+}
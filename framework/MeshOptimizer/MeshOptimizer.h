@@ -0,0 +1,239 @@
+#ifndef MESHOPTIMIZER_H_
+#define MESHOPTIMIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+
+namespace Framework {
+
+  // Processing passes for indexed triangle meshes, meant to run before the data is put in a
+  // VertexBuffer/IndexBuffer (either offline or at load time).
+  namespace MeshOptimizer {
+
+    // Welding
+    //
+    // Vertices are merged when all their components are equal. With an epsilon, components are
+    // first snapped to a grid of that spacing, so values closer than the epsilon usually merge;
+    // values on either side of a grid line stay apart, which keeps welding linear in time.
+
+    struct WeldOptions {
+      float PositionEpsilon = 0.0f;     // For the first PositionComponents floats of a vertex
+      float AttributeEpsilon = 0.0f;    // For the remaining floats (normals, texture coordinates, ...)
+      unsigned int PositionComponents = 3;
+    };
+
+    struct WeldedVertices {
+      std::vector<float> Vertices;      // Unique vertices, 'stride' floats each
+      std::vector<uint32_t> Indices;    // One per input vertex
+    };
+
+    /**
+     *  Map each of 'count' vertices ('stride' floats each) to the index of its unique vertex.
+     *  Unique vertices are numbered in order of first appearance.
+     *
+     *  @returns Number of unique vertices
+     */
+    size_t WeldRemap(const float* vertices, size_t count, size_t stride, std::vector<uint32_t>& remap,
+                     const WeldOptions& options = WeldOptions());
+
+    /**
+     *  Turn an unindexed vertex list (three vertices per triangle) into unique vertices plus an
+     *  index buffer. A merged vertex keeps the values of its first occurrence.
+     */
+    WeldedVertices Weld(const float* vertices, size_t count, size_t stride, const WeldOptions& options = WeldOptions());
+
+    /**
+     *  Merge the mesh's equal vertices (comparing all attribute streams) and rewrite its indices.
+     *
+     *  @returns Number of vertices removed
+     */
+    size_t Weld(Mesh& mesh, const WeldOptions& options = WeldOptions());
+
+
+    // Index and vertex order
+    //
+    // The passes are meant to run in this order: OptimizeVertexCache, OptimizeOverdraw, then
+    // OptimizeVertexFetch (Optimize() runs all three on a Mesh). The first two only reorder
+    // whole triangles and keep the vertex order within each triangle, so winding and the
+    // provoking vertex are unchanged.
+
+    struct VertexCacheStatistics {
+      size_t VerticesTransformed;   // Cache misses
+      float Acmr;                   // Average cache miss ratio: misses per triangle (0.5 at best for grids)
+      float Atvr;                   // Average transform to vertex ratio: misses per used vertex (1 at best)
+    };
+
+    /**
+     *  Simulate a FIFO post-transform vertex cache of 'cacheSize' entries over the index list.
+     */
+    VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                             unsigned int cacheSize = 16);
+
+    /**
+     *  Reorder triangles for vertex cache locality (Tom Forsyth's linear-speed algorithm, which
+     *  does well across cache sizes and replacement policies).
+     */
+    void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 32);
+
+    /**
+     *  Reorder clusters of a cache-optimized index list so triangles facing outwards are drawn
+     *  first, which reduces overdraw for most viewpoints. Clusters are split where it raises the
+     *  ACMR by at most 'threshold' (1.05: 5%).
+     */
+    void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+                          float threshold = 1.05f, unsigned int cacheSize = 16);
+
+    /**
+     *  Number vertices in order of first use (unused ones get ~0u), for sequential vertex fetch.
+     *
+     *  @returns Number of used vertices
+     */
+    size_t OptimizeVertexFetchRemap(const uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap);
+
+    /**
+     *  Reorder interleaved vertices ('stride' floats each) in order of first use, drop unused
+     *  ones and rewrite the indices.
+     *
+     *  @returns Number of vertices kept
+     */
+    size_t OptimizeVertexFetch(std::vector<float>& vertices, size_t stride, uint32_t* indices, size_t indexCount);
+    void OptimizeVertexFetch(Mesh& mesh);
+
+    // All of the above, in order.
+    void Optimize(Mesh& mesh);
+
+
+    // Simplification
+    //
+    // Edge collapses ordered by quadric error (Garland & Heckbert). Vertices only ever move onto
+    // one of their neighbours, so no new vertices are made and every level can share the
+    // original vertex buffer. Open borders and attribute seams (vertices with equal positions
+    // but different normals or texture coordinates) only collapse along themselves, seams on
+    // both sides at once, so they keep their shape and the texture mapping stays intact.
+
+    struct SimplifyOptions {
+      float TargetError = 0.01f;        // Largest deviation allowed, relative to the mesh's extent
+      bool LockBorder = false;          // Keep open borders in place (e.g. for meshes stitched to others)
+    };
+
+    /**
+     *  Simplify the triangle list towards 'targetIndexCount' indices, stopping earlier when no
+     *  collapse stays within the error limit.
+     *
+     *  @param resultError If given, receives the largest deviation, relative to the mesh's extent
+     *  @returns Number of indices written to 'destination'
+     */
+    size_t Simplify(const uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+                    size_t targetIndexCount, std::vector<uint32_t>& destination,
+                    const SimplifyOptions& options = SimplifyOptions(), float* resultError = nullptr);
+
+    struct LodLevel {
+      std::vector<uint32_t> Indices;    // Into the source mesh's vertices
+      float Error;                      // Deviation from the source mesh, in model space units
+    };
+
+    /**
+     *  Build a chain of levels with the given fractions of the mesh's triangles, each simplified
+     *  from the previous one and optimized for the vertex cache. Levels that the error limit
+     *  keeps from shrinking are left out, so the chain may be shorter than 'ratios'.
+     */
+    std::vector<LodLevel> GenerateLods(const Mesh& mesh, const std::vector<float>& ratios = {1.0f, 0.5f, 0.25f, 0.125f},
+                                       const SimplifyOptions& options = SimplifyOptions());
+
+    /**
+     *  Coarsest level whose error projects to at most 'maxPixelError' pixels at 'distance' from
+     *  the camera. 'scale' is the model's scale in world space.
+     */
+    int SelectLod(const std::vector<LodLevel>& lods, float distance, float fovY, float viewportHeight,
+                  float maxPixelError = 1.0f, float scale = 1.0f);
+
+
+    // Quantization
+    //
+    // Encoders for the packed ShaderDataTypes (ShadersDataTypes.h). Snorm values follow the
+    // OpenGL 4.2+ rules: n bits hold [-(2^(n-1) - 1), 2^(n-1) - 1], read as [-1, 1].
+
+    uint16_t QuantizeHalf(float value);                         // Round to nearest even; out of range: Inf
+    float DequantizeHalf(uint16_t value);
+    uint32_t QuantizeSnorm8x4(const glm::vec4& value);          // ShaderDataType::Snorm8x4
+    glm::vec4 DequantizeSnorm8x4(uint32_t packed);
+    uint32_t QuantizeUnorm8x4(const glm::vec4& value);          // ShaderDataType::Unorm8x4
+    glm::vec4 DequantizeUnorm8x4(uint32_t packed);
+    uint32_t QuantizeInt2_10_10_10_Rev(const glm::vec4& value); // ShaderDataType::Int2_10_10_10_Rev
+    glm::vec4 DequantizeInt2_10_10_10_Rev(uint32_t packed);
+
+    struct QuantizeOptions {
+      bool HalfPositions = false;       // Half4 positions: only for meshes of modest size near the origin
+    };
+
+    // Packed interleaved vertices, with the streams the mesh has, in this order:
+    //
+    //   position   Float3 (or Half4, w = 1)    12 (8) bytes
+    //   normal     Int2_10_10_10_Rev (w = 0)    4 bytes
+    //   tex coord  Half2                        4 bytes
+    //   tangent    Int2_10_10_10_Rev            4 bytes, w = handedness
+    //
+    // A full vertex takes 24 bytes instead of 48. Normals and tangents come out slightly
+    // shorter or longer than 1, so the shader should normalize them. The errors are the
+    // largest absolute difference of any component after decoding.
+    struct QuantizedMesh {
+      std::vector<uint8_t> Vertices;
+      size_t Stride = 0;                // Bytes per vertex
+      float PositionError = 0.0f;
+      float NormalError = 0.0f;         // At most 1/1022
+      float TexCoordError = 0.0f;       // At most 2^-12 for coordinates in [0, 1]
+      float TangentError = 0.0f;
+    };
+
+    QuantizedMesh Quantize(const Mesh& mesh, const QuantizeOptions& options = QuantizeOptions());
+
+
+    // Meshlets
+    //
+    // Small clusters of neighbouring triangles, each with its own list of at most 255 vertices,
+    // so that a dense mesh can be culled piece by piece (ClusterCuller) instead of as a whole.
+
+    struct Meshlet {
+      uint32_t VertexOffset;            // Into MeshletData::Vertices
+      uint32_t TriangleOffset;          // Into MeshletData::Triangles, in triangles
+      uint32_t VertexCount;
+      uint32_t TriangleCount;
+    };
+
+    // Bounding sphere and normal cone of a meshlet, laid out like a std430 struct of three vec4s.
+    // All of its triangles face away from a camera at c when
+    //
+    //   dot(normalize(ConeApex - c), ConeAxis) >= ConeCutoff
+    //
+    // ConeCutoff is 1 (never culled) when the normals spread over a hemisphere or more.
+    struct MeshletBounds {
+      glm::vec3 Center;
+      float Radius;
+      glm::vec3 ConeApex;
+      float Padding;
+      glm::vec3 ConeAxis;
+      float ConeCutoff;                 // Sine of the normals' largest angle to the axis
+    };
+
+    struct MeshletData {
+      std::vector<Meshlet> Meshlets;
+      std::vector<uint32_t> Vertices;   // Mesh vertex indices of all meshlets
+      std::vector<uint8_t> Triangles;   // Three indices into the meshlet's vertices per triangle
+      std::vector<MeshletBounds> Bounds; // One per meshlet
+    };
+
+    /**
+     *  Split a triangle list into meshlets of at most 'maxVertices' vertices and 'maxTriangles'
+     *  triangles (64 and 124 suit both culling and mesh shaders). Meshlets grow across shared
+     *  edges, so a cache-optimized index list (OptimizeVertexCache) gives the best clusters.
+     */
+    MeshletData BuildMeshlets(const uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+                              unsigned int maxVertices = 64, unsigned int maxTriangles = 124);
+
+    MeshletBounds ComputeMeshletBounds(const MeshletData& data, const Meshlet& meshlet, const glm::vec3* positions);
+  };
+};
+
+#endif // MESHOPTIMIZER_H_
@@ -0,0 +1,182 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Framework {
+namespace MeshOptimizer {
+
+    namespace {
+        constexpr uint8_t NotInMeshlet = 0xff;
+
+        // Triangles around each vertex, as compressed sparse rows
+        struct VertexTriangles {
+            std::vector<uint32_t> offsets, triangles;
+
+            VertexTriangles(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+                : offsets(vertexCount + 1, 0), triangles(indexCount) {
+                for (size_t i = 0; i < indexCount; i++) offsets[indices[i] + 1]++;
+                for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+                std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indexCount; i++) triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        };
+    }
+
+    MeshletData BuildMeshlets(const uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+                              unsigned int maxVertices, unsigned int maxTriangles) {
+        maxVertices = std::min(std::max(maxVertices, 3u), 255u);
+        maxTriangles = std::min(std::max(maxTriangles, 1u), 512u);
+
+        MeshletData data;
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0) return data;
+
+        VertexTriangles adjacency(indices, triangleCount * 3, vertexCount);
+        std::vector<uint32_t> liveTriangles(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint8_t> local(vertexCount, NotInMeshlet);
+
+        Meshlet meshlet = {0, 0, 0, 0};
+        glm::vec3 centroidSum(0.0f);
+
+        auto newVertexCount = [&](size_t t) {
+            const uint32_t* triangle = &indices[3 * t];
+            return (local[triangle[0]] == NotInMeshlet) + (local[triangle[1]] == NotInMeshlet) + (local[triangle[2]] == NotInMeshlet);
+        };
+
+        auto finish = [&]() {
+            for (uint32_t i = 0; i < meshlet.VertexCount; i++) local[data.Vertices[meshlet.VertexOffset + i]] = NotInMeshlet;
+            data.Meshlets.push_back(meshlet);
+            meshlet = {static_cast<uint32_t>(data.Vertices.size()), static_cast<uint32_t>(data.Triangles.size() / 3), 0, 0};
+            centroidSum = glm::vec3(0.0f);
+        };
+
+        auto add = [&](size_t t) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[3 * t + k];
+                if (local[v] == NotInMeshlet) {
+                    local[v] = static_cast<uint8_t>(meshlet.VertexCount++);
+                    data.Vertices.push_back(v);
+                    centroidSum += positions[v];
+                }
+                data.Triangles.push_back(local[v]);
+                liveTriangles[v]--;
+            }
+            meshlet.TriangleCount++;
+            emitted[t] = true;
+        };
+
+        // Grow each meshlet from its border: the next triangle is the one adjacent to the meshlet
+        // that adds the fewest vertices, then the one closest to its centroid. Only vertices with
+        // triangles left can border on new triangles, so the search stays short.
+        size_t cursor = 0;
+        for (size_t added = 0; added < triangleCount; added++) {
+            size_t best = triangleCount;
+            int bestNew = 4;
+            float bestDistance = std::numeric_limits<float>::max();
+            const glm::vec3 centroid = meshlet.VertexCount > 0 ? centroidSum / float(meshlet.VertexCount) : glm::vec3(0.0f);
+            for (uint32_t i = 0; i < meshlet.VertexCount && bestNew > 0; i++) {
+                uint32_t v = data.Vertices[meshlet.VertexOffset + i];
+                if (liveTriangles[v] == 0) continue;
+                for (uint32_t j = adjacency.offsets[v]; j < adjacency.offsets[v + 1]; j++) {
+                    uint32_t t = adjacency.triangles[j];
+                    if (emitted[t]) continue;
+                    int extra = newVertexCount(t);
+                    if (extra > bestNew) continue;
+                    const uint32_t* triangle = &indices[3 * t];
+                    glm::vec3 offset = (positions[triangle[0]] + positions[triangle[1]] + positions[triangle[2]]) / 3.0f - centroid;
+                    float distance = glm::dot(offset, offset);
+                    if (extra < bestNew || distance < bestDistance) {
+                        best = t;
+                        bestNew = extra;
+                        bestDistance = distance;
+                    }
+                }
+            }
+
+            // Nothing adjacent: continue with the next triangle in input order, which is close to
+            // the previous ones in a cache-optimized index list
+            if (best == triangleCount) {
+                while (emitted[cursor]) cursor++;
+                best = cursor;
+                bestNew = newVertexCount(best);
+            }
+
+            if (meshlet.VertexCount + bestNew > maxVertices || meshlet.TriangleCount + 1 > maxTriangles) {
+                finish();
+            }
+            add(best);
+        }
+        if (meshlet.TriangleCount > 0) finish();
+
+        data.Bounds.reserve(data.Meshlets.size());
+        for (const Meshlet& m : data.Meshlets) data.Bounds.push_back(ComputeMeshletBounds(data, m, positions));
+        return data;
+    }
+
+    MeshletBounds ComputeMeshletBounds(const MeshletData& data, const Meshlet& meshlet, const glm::vec3* positions) {
+        MeshletBounds bounds = {};
+
+        // Sphere around the box's center
+        glm::vec3 min(std::numeric_limits<float>::max()), max(-std::numeric_limits<float>::max());
+        for (uint32_t i = 0; i < meshlet.VertexCount; i++) {
+            const glm::vec3& p = positions[data.Vertices[meshlet.VertexOffset + i]];
+            min = glm::min(min, p);
+            max = glm::max(max, p);
+        }
+        bounds.Center = (min + max) * 0.5f;
+        for (uint32_t i = 0; i < meshlet.VertexCount; i++) {
+            bounds.Radius = std::max(bounds.Radius, glm::length(positions[data.Vertices[meshlet.VertexOffset + i]] - bounds.Center));
+        }
+
+        // Normal cone: the axis is the average triangle normal, the spread its smallest dot
+        // product with any of them
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> corners;
+        normals.reserve(meshlet.TriangleCount);
+        corners.reserve(meshlet.TriangleCount);
+        glm::vec3 axis(0.0f);
+        for (uint32_t t = 0; t < meshlet.TriangleCount; t++) {
+            const uint8_t* triangle = &data.Triangles[3 * (meshlet.TriangleOffset + t)];
+            const glm::vec3& p0 = positions[data.Vertices[meshlet.VertexOffset + triangle[0]]];
+            const glm::vec3& p1 = positions[data.Vertices[meshlet.VertexOffset + triangle[1]]];
+            const glm::vec3& p2 = positions[data.Vertices[meshlet.VertexOffset + triangle[2]]];
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float length = glm::length(normal);
+            if (length == 0.0f) continue; // Degenerate triangles are never visible
+            normals.push_back(normal / length);
+            corners.push_back(p0);
+            axis += normal / length;
+        }
+
+        bounds.ConeAxis = glm::vec3(0.0f);
+        bounds.ConeCutoff = 1.0f;
+        bounds.ConeApex = bounds.Center;
+        float axisLength = glm::length(axis);
+        if (normals.empty() || axisLength == 0.0f) return bounds;
+        axis /= axisLength;
+
+        float minDot = 1.0f;
+        for (const glm::vec3& normal : normals) minDot = std::min(minDot, glm::dot(normal, axis));
+
+        // Normals spreading over a hemisphere or more: some triangle faces every viewpoint
+        if (minDot <= 0.0f) return bounds;
+
+        // Apex behind every triangle's plane, so a camera behind the cone through it is behind
+        // all of them. t solves dot(Center - axis * t - p0, normal) = 0 for each triangle.
+        float maxT = 0.0f;
+        for (size_t i = 0; i < normals.size(); i++) {
+            float t = glm::dot(bounds.Center - corners[i], normals[i]) / glm::dot(axis, normals[i]);
+            maxT = std::max(maxT, t);
+        }
+
+        bounds.ConeAxis = axis;
+        bounds.ConeApex = bounds.Center - axis * maxT;
+        bounds.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+        return bounds;
+    }
+};
+};
@@ -0,0 +1,159 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Framework {
+namespace MeshOptimizer {
+
+    namespace {
+        inline int QuantizeSnorm(float value, int bits) {
+            const float scale = (float)((1 << (bits - 1)) - 1);
+            return (int)std::lround(std::clamp(value, -1.0f, 1.0f) * scale);
+        }
+
+        inline float DequantizeSnorm(int value, int bits) {
+            const float scale = (float)((1 << (bits - 1)) - 1);
+            return std::max(value / scale, -1.0f);
+        }
+
+        // Sign extension of a 'bits' wide field
+        inline int SignedField(uint32_t packed, int shift, int bits) {
+            int value = (int)((packed >> shift) & ((1u << bits) - 1));
+            return value >= (1 << (bits - 1)) ? value - (1 << bits) : value;
+        }
+
+        template<typename T>
+        inline void Write(uint8_t*& out, const T& value) {
+            std::memcpy(out, &value, sizeof(T));
+            out += sizeof(T);
+        }
+
+        inline float MaxError(const glm::vec4& a, const glm::vec4& b) {
+            glm::vec4 d = glm::abs(a - b);
+            return std::max({d.x, d.y, d.z, d.w});
+        }
+    }
+
+    uint16_t QuantizeHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t magnitude = bits & 0x7fffffff;
+
+        if (magnitude >= 0x7f800000) return (uint16_t)(sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0)); // Inf, NaN
+        if (magnitude >= 0x477ff000) return (uint16_t)(sign | 0x7c00);  // Rounds above 65504: Inf
+        if (magnitude < 0x38800000) {
+            // Below 2^-14: subnormal, in steps of 2^-24 (rounds to nearest even)
+            float f;
+            std::memcpy(&f, &magnitude, sizeof(f));
+            return (uint16_t)(sign | (uint32_t)std::nearbyint(f * 16777216.0f));
+        }
+
+        // Rebias the exponent (127 -> 15) and round the mantissa to 10 bits, to nearest even
+        uint32_t half = (magnitude - 0x38000000) >> 13;
+        uint32_t rest = magnitude & 0x1fff;
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;
+        return (uint16_t)(sign | half);
+    }
+
+    float DequantizeHalf(uint16_t value) {
+        uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+        uint32_t exponent = (value >> 10) & 0x1f;
+        uint32_t mantissa = value & 0x3ff;
+
+        if (exponent == 0) {
+            float f = mantissa * (1.0f / 16777216.0f);
+            return sign ? -f : f;
+        }
+        uint32_t bits = sign | (exponent == 31 ? 0x7f800000 : (exponent + 112) << 23) | (mantissa << 13);
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    uint32_t QuantizeSnorm8x4(const glm::vec4& value) {
+        uint32_t packed = 0;
+        for (int i = 0; i < 4; i++) packed |= (uint32_t)(QuantizeSnorm(value[i], 8) & 0xff) << (8 * i);
+        return packed;
+    }
+
+    glm::vec4 DequantizeSnorm8x4(uint32_t packed) {
+        glm::vec4 value;
+        for (int i = 0; i < 4; i++) value[i] = DequantizeSnorm(SignedField(packed, 8 * i, 8), 8);
+        return value;
+    }
+
+    uint32_t QuantizeUnorm8x4(const glm::vec4& value) {
+        uint32_t packed = 0;
+        for (int i = 0; i < 4; i++) packed |= (uint32_t)std::lround(std::clamp(value[i], 0.0f, 1.0f) * 255.0f) << (8 * i);
+        return packed;
+    }
+
+    glm::vec4 DequantizeUnorm8x4(uint32_t packed) {
+        glm::vec4 value;
+        for (int i = 0; i < 4; i++) value[i] = ((packed >> (8 * i)) & 0xff) / 255.0f;
+        return value;
+    }
+
+    uint32_t QuantizeInt2_10_10_10_Rev(const glm::vec4& value) {
+        return (uint32_t)(QuantizeSnorm(value.x, 10) & 0x3ff)
+             | (uint32_t)(QuantizeSnorm(value.y, 10) & 0x3ff) << 10
+             | (uint32_t)(QuantizeSnorm(value.z, 10) & 0x3ff) << 20
+             | (uint32_t)(QuantizeSnorm(value.w, 2) & 0x3) << 30;
+    }
+
+    glm::vec4 DequantizeInt2_10_10_10_Rev(uint32_t packed) {
+        return {DequantizeSnorm(SignedField(packed, 0, 10), 10), DequantizeSnorm(SignedField(packed, 10, 10), 10),
+                DequantizeSnorm(SignedField(packed, 20, 10), 10), DequantizeSnorm(SignedField(packed, 30, 2), 2)};
+    }
+
+    QuantizedMesh Quantize(const Mesh& mesh, const QuantizeOptions& options) {
+        QuantizedMesh result;
+        const size_t count = mesh.GetVertexCount();
+        const bool normals = !mesh.Normals.empty();
+        const bool texCoords = !mesh.TexCoords.empty();
+        const bool tangents = !mesh.Tangents.empty();
+
+        result.Stride = (options.HalfPositions ? 8 : 12) + (normals ? 4 : 0) + (texCoords ? 4 : 0) + (tangents ? 4 : 0);
+        result.Vertices.resize(count * result.Stride);
+
+        uint8_t* out = result.Vertices.data();
+        for (size_t v = 0; v < count; v++) {
+            const glm::vec3& position = mesh.Positions[v];
+            if (options.HalfPositions) {
+                uint16_t half[4] = {QuantizeHalf(position.x), QuantizeHalf(position.y), QuantizeHalf(position.z), QuantizeHalf(1.0f)};
+                Write(out, half);
+                glm::vec4 decoded(DequantizeHalf(half[0]), DequantizeHalf(half[1]), DequantizeHalf(half[2]), 1.0f);
+                result.PositionError = std::max(result.PositionError, MaxError(decoded, glm::vec4(position, 1.0f)));
+            } else {
+                Write(out, position);
+            }
+
+            if (normals) {
+                uint32_t packed = QuantizeInt2_10_10_10_Rev(glm::vec4(mesh.Normals[v], 0.0f));
+                Write(out, packed);
+                result.NormalError = std::max(result.NormalError, MaxError(DequantizeInt2_10_10_10_Rev(packed), glm::vec4(mesh.Normals[v], 0.0f)));
+            }
+
+            if (texCoords) {
+                const glm::vec2& uv = mesh.TexCoords[v];
+                uint16_t half[2] = {QuantizeHalf(uv.x), QuantizeHalf(uv.y)};
+                Write(out, half);
+                glm::vec4 decoded(DequantizeHalf(half[0]), DequantizeHalf(half[1]), 0.0f, 0.0f);
+                result.TexCoordError = std::max(result.TexCoordError, MaxError(decoded, glm::vec4(uv, 0.0f, 0.0f)));
+            }
+
+            if (tangents) {
+                // w only holds the handedness, which is exact in 2 bits
+                glm::vec4 tangent(glm::vec3(mesh.Tangents[v]), mesh.Tangents[v].w < 0.0f ? -1.0f : 1.0f);
+                uint32_t packed = QuantizeInt2_10_10_10_Rev(tangent);
+                Write(out, packed);
+                result.TangentError = std::max(result.TangentError, MaxError(DequantizeInt2_10_10_10_Rev(packed), tangent));
+            }
+        }
+        return result;
+    }
+};
+};
@@ -0,0 +1,360 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Framework {
+namespace MeshOptimizer {
+
+    namespace {
+        // Sum of squared distances to weighted planes: error(p) = p'Ap + 2b'p + c
+        struct Quadric {
+            double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+            double b0 = 0, b1 = 0, b2 = 0;
+            double c = 0;
+            double weight = 0;
+
+            void AddPlane(const glm::dvec3& n, double d, double w) {
+                a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+                a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+                b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+                c += w * d * d;
+                weight += w;
+            }
+
+            Quadric& operator+=(const Quadric& q) {
+                a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+                b0 += q.b0; b1 += q.b1; b2 += q.b2;
+                c += q.c;
+                weight += q.weight;
+                return *this;
+            }
+
+            // Mean squared distance of p to the planes
+            double Error(const glm::vec3& p) const {
+                double x = p.x, y = p.y, z = p.z;
+                double e = a00 * x * x + a11 * y * y + a22 * z * z + 2 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                         + 2 * (b0 * x + b1 * y + b2 * z) + c;
+                return weight > 0 ? std::max(e, 0.0) / weight : 0.0;
+            }
+        };
+
+        // Border and seam edges are kept in place by planes through them, perpendicular to the
+        // triangle, weighted more than the surface itself
+        constexpr double EdgeWeight = 10.0;
+
+        enum class VertexKind : uint8_t {
+            Manifold,   // Interior vertex, free to move to any neighbour
+            Border,     // On an open border, slides along it
+            Seam,       // One of two vertices on an attribute seam, slides along it with its twin
+            Locked      // Anything else (corners, seam/border junctions, non-manifold)
+        };
+
+        struct Collapse {
+            uint32_t from, to;
+            float error;
+        };
+
+        // Compressed sparse row lists: the items of vertex v are items[offsets[v] .. offsets[v + 1])
+        struct Adjacency {
+            std::vector<uint32_t> offsets, items;
+
+            template<typename Each>
+            void Build(size_t vertexCount, const std::vector<uint32_t>& indices, Each each) {
+                offsets.assign(vertexCount + 1, 0);
+                for (size_t i = 0; i < indices.size(); i++) offsets[indices[i] + 1]++;
+                for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+                items.resize(indices.size());
+                std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indices.size(); i++) items[cursor[indices[i]]++] = each(i);
+            }
+
+            const uint32_t* begin(uint32_t v) const { return items.data() + offsets[v]; }
+            const uint32_t* end(uint32_t v) const { return items.data() + offsets[v + 1]; }
+            bool Contains(uint32_t v, uint32_t item) const { return std::find(begin(v), end(v), item) != end(v); }
+        };
+
+        bool Flips(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& moved) {
+            // Triangle (a, b, c) with a moved: reject flipped or collapsed normals
+            glm::vec3 before = glm::cross(b - a, c - a);
+            glm::vec3 after = glm::cross(b - moved, c - moved);
+            return glm::dot(before, after) <= 0.0f;
+        }
+    }
+
+    size_t Simplify(const uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+                    size_t targetIndexCount, std::vector<uint32_t>& destination, const SimplifyOptions& options,
+                    float* resultError) {
+        destination.assign(indices, indices + indexCount - indexCount % 3);
+        if (resultError) *resultError = 0.0f;
+        if (destination.empty() || vertexCount == 0) return destination.size();
+
+        // Vertices sharing a position: 'canonical' is the first of them, 'wedge' links them in a cycle
+        std::vector<uint32_t> positionIds;
+        size_t positionCount = WeldRemap(reinterpret_cast<const float*>(positions), vertexCount, 3, positionIds);
+        std::vector<uint32_t> firstOfId(positionCount, ~0u), lastOfId(positionCount, ~0u), wedgeCount(positionCount, 0);
+        std::vector<uint32_t> canonical(vertexCount), wedge(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            uint32_t id = positionIds[v];
+            if (firstOfId[id] == ~0u) {
+                firstOfId[id] = v;
+                wedge[v] = v;
+            } else {
+                wedge[v] = wedge[lastOfId[id]];
+                wedge[lastOfId[id]] = v;
+            }
+            lastOfId[id] = v;
+            canonical[v] = firstOfId[id];
+            wedgeCount[id]++;
+        }
+
+        // Extent for the relative error
+        glm::vec3 lower = positions[0], upper = positions[0];
+        for (size_t v = 1; v < vertexCount; v++) {
+            lower = glm::min(lower, positions[v]);
+            upper = glm::max(upper, positions[v]);
+        }
+        const float extent = std::max({upper.x - lower.x, upper.y - lower.y, upper.z - lower.z, 1e-20f});
+        const double errorLimit = (double)options.TargetError * extent * ((double)options.TargetError * extent);
+
+        // Open edges: half-edges a->b without b->a. 'loop' and 'loopBack' follow them forwards and backwards.
+        std::vector<uint32_t> loop(vertexCount), loopBack(vertexCount);
+        std::vector<uint32_t> canonicalIndices(destination.size());
+        Adjacency outgoing, canonicalOutgoing, triangles;
+        auto findOpenEdges = [&]() {
+            outgoing.Build(vertexCount, destination, [&](size_t i) { return destination[i - i % 3 + (i + 1) % 3]; });
+            std::fill(loop.begin(), loop.end(), ~0u);
+            std::fill(loopBack.begin(), loopBack.end(), ~0u);
+            for (size_t i = 0; i < destination.size(); i++) {
+                uint32_t a = destination[i], b = destination[i - i % 3 + (i + 1) % 3];
+                if (!outgoing.Contains(b, a)) {
+                    loop[a] = loop[a] == ~0u ? b : a;       // More than one: marked with a self loop
+                    loopBack[b] = loopBack[b] == ~0u ? a : b;
+                }
+            }
+        };
+
+        // Classify vertices on the input topology
+        findOpenEdges();
+        for (size_t i = 0; i < destination.size(); i++) canonicalIndices[i] = canonical[destination[i]];
+        canonicalOutgoing.Build(vertexCount, canonicalIndices, [&](size_t i) { return canonicalIndices[i - i % 3 + (i + 1) % 3]; });
+        std::vector<bool> positionOpen(vertexCount, false);
+        for (size_t i = 0; i < canonicalIndices.size(); i++) {
+            uint32_t a = canonicalIndices[i], b = canonicalIndices[i - i % 3 + (i + 1) % 3];
+            if (!canonicalOutgoing.Contains(b, a)) positionOpen[a] = positionOpen[b] = true;
+        }
+
+        auto simpleLoop = [&](uint32_t v) { return loop[v] != ~0u && loop[v] != v && loopBack[v] != ~0u && loopBack[v] != v; };
+        std::vector<VertexKind> kind(vertexCount, VertexKind::Locked);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            uint32_t wedges = wedgeCount[positionIds[v]];
+            bool open = loop[v] != ~0u || loopBack[v] != ~0u;
+            if (wedges == 1 && !open) {
+                kind[v] = VertexKind::Manifold;
+            } else if (wedges == 1 && simpleLoop(v) && positionOpen[v]) {
+                kind[v] = VertexKind::Border;
+            } else if (wedges == 2 && simpleLoop(v) && simpleLoop(wedge[v]) && !positionOpen[canonical[v]]) {
+                kind[v] = VertexKind::Seam;
+            }
+            if (kind[v] == VertexKind::Border && options.LockBorder) kind[v] = VertexKind::Locked;
+        }
+
+        // Quadrics per position: triangle planes weighted by area, plus the border and seam edges
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t t = 0; t < destination.size(); t += 3) {
+            glm::dvec3 p[3] = {positions[destination[t]], positions[destination[t + 1]], positions[destination[t + 2]]};
+            glm::dvec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+            double area = glm::length(normal);
+            if (area == 0.0) continue;
+            normal /= area;
+            for (int k = 0; k < 3; k++) quadrics[canonical[destination[t + k]]].AddPlane(normal, -glm::dot(normal, p[0]), area);
+
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = destination[t + k], b = destination[t + (k + 1) % 3];
+                if (loop[a] != b && loopBack[b] != a) continue;
+                glm::dvec3 edge = p[(k + 1) % 3] - p[k];
+                double length = glm::length(edge);
+                if (length == 0.0) continue;
+                glm::dvec3 side = glm::normalize(glm::cross(edge, normal));
+                double d = -glm::dot(side, p[k]);
+                quadrics[canonical[a]].AddPlane(side, d, length * length * EdgeWeight);
+                quadrics[canonical[b]].AddPlane(side, d, length * length * EdgeWeight);
+            }
+        }
+
+        // Passes of independent edge collapses, cheapest first
+        std::vector<Collapse> collapses;
+        std::vector<uint32_t> collapseRemap(vertexCount);
+        std::vector<bool> locked(vertexCount);
+        std::vector<uint32_t> fromRing, toRing;
+        double largestError = 0.0;
+        while (destination.size() > targetIndexCount) {
+            findOpenEdges();
+            triangles.Build(vertexCount, destination, [](size_t i) { return static_cast<uint32_t>(i / 3); });
+
+            // The seam twin that moves with 'from', or ~0u when the collapse is not allowed
+            auto twin = [&](uint32_t from, uint32_t to) -> uint32_t {
+                uint32_t other = wedge[from];
+                uint32_t otherTo = to == loop[from] ? loopBack[other] : to == loopBack[from] ? loop[other] : ~0u;
+                return otherTo != ~0u && canonical[otherTo] == canonical[to] ? otherTo : ~0u;
+            };
+            auto allowed = [&](uint32_t from, uint32_t to) {
+                switch (kind[from]) {
+                    case VertexKind::Manifold:
+                        return true;
+                    case VertexKind::Border:
+                        return (to == loop[from] || to == loopBack[from]) && (kind[to] == VertexKind::Border || kind[to] == VertexKind::Locked);
+                    case VertexKind::Seam:
+                        return (kind[to] == VertexKind::Seam || kind[to] == VertexKind::Locked) && twin(from, to) != ~0u;
+                    default:
+                        return false;
+                }
+            };
+
+            collapses.clear();
+            for (size_t i = 0; i < destination.size(); i++) {
+                uint32_t from = destination[i], to = destination[i - i % 3 + (i + 1) % 3];
+                for (int direction = 0; direction < 2; direction++, std::swap(from, to)) {
+                    if (canonical[from] == canonical[to] || !allowed(from, to)) continue;
+                    Quadric q = quadrics[canonical[from]];
+                    q += quadrics[canonical[to]];
+                    double error = q.Error(positions[to]);
+                    if (error <= errorLimit) collapses.push_back({from, to, (float)error});
+                }
+            }
+            if (collapses.empty()) break;
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+            // Collapses in one pass must not touch each other's triangles
+            for (uint32_t v = 0; v < vertexCount; v++) collapseRemap[v] = v;
+            std::fill(locked.begin(), locked.end(), false);
+            size_t triangleCount = destination.size() / 3;
+            const size_t targetTriangles = targetIndexCount / 3;
+            size_t applied = 0;
+            for (const Collapse& collapse : collapses) {
+                if (triangleCount <= targetTriangles) break;
+
+                uint32_t moved[2] = {collapse.from, ~0u}, target[2] = {collapse.to, ~0u};
+                if (kind[collapse.from] == VertexKind::Seam) {
+                    moved[1] = wedge[collapse.from];
+                    target[1] = twin(collapse.from, collapse.to);
+                }
+                if (locked[canonical[collapse.from]] || locked[canonical[collapse.to]]) continue;
+
+                // Reject collapses that flip a remaining triangle
+                bool valid = true;
+                size_t removed = 0;
+                for (int side = 0; side < 2 && valid && moved[side] != ~0u; side++) {
+                    for (const uint32_t* t = triangles.begin(moved[side]); t != triangles.end(moved[side]); t++) {
+                        const uint32_t* triangle = &destination[3 * *t];
+                        if (std::find(triangle, triangle + 3, target[side]) != triangle + 3) {
+                            removed++;
+                            continue;
+                        }
+                        int k = (int)(std::find(triangle, triangle + 3, moved[side]) - triangle);
+                        if (Flips(positions[triangle[k]], positions[triangle[(k + 1) % 3]], positions[triangle[(k + 2) % 3]], positions[target[side]])) {
+                            valid = false;
+                            break;
+                        }
+                    }
+                }
+                if (!valid) continue;
+
+                // Link condition: the edge's endpoints may only share the neighbours opposite to it,
+                // otherwise the collapse pinches the surface into a non-manifold edge
+                auto ring = [&](const uint32_t* vertices, std::vector<uint32_t>& out) {
+                    out.clear();
+                    for (int side = 0; side < 2 && vertices[side] != ~0u; side++) {
+                        for (const uint32_t* t = triangles.begin(vertices[side]); t != triangles.end(vertices[side]); t++) {
+                            for (int k = 0; k < 3; k++) out.push_back(canonical[destination[3 * *t + k]]);
+                        }
+                    }
+                    std::sort(out.begin(), out.end());
+                    out.erase(std::unique(out.begin(), out.end()), out.end());
+                };
+                ring(moved, fromRing);
+                ring(target, toRing);
+                size_t shared = 0;
+                for (uint32_t v : fromRing) {
+                    shared += v != canonical[collapse.from] && v != canonical[collapse.to] && std::binary_search(toRing.begin(), toRing.end(), v);
+                }
+                if (shared > removed) continue;
+
+                for (int side = 0; side < 2 && moved[side] != ~0u; side++) {
+                    collapseRemap[moved[side]] = target[side];
+                    for (const uint32_t* t = triangles.begin(moved[side]); t != triangles.end(moved[side]); t++) {
+                        for (int k = 0; k < 3; k++) locked[canonical[destination[3 * *t + k]]] = true;
+                    }
+                }
+                quadrics[canonical[collapse.to]] += quadrics[canonical[collapse.from]];
+                largestError = std::max(largestError, (double)collapse.error);
+                triangleCount -= std::min(removed, triangleCount);
+                applied++;
+            }
+            if (applied == 0) break;
+
+            // Apply the pass and drop the collapsed triangles
+            size_t write = 0;
+            for (size_t t = 0; t < destination.size(); t += 3) {
+                uint32_t a = collapseRemap[destination[t]], b = collapseRemap[destination[t + 1]], c = collapseRemap[destination[t + 2]];
+                if (canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[a] == canonical[c]) continue;
+                destination[write++] = a;
+                destination[write++] = b;
+                destination[write++] = c;
+            }
+            destination.resize(write);
+        }
+
+        if (resultError) *resultError = (float)(std::sqrt(largestError) / extent);
+        return destination.size();
+    }
+
+    std::vector<LodLevel> GenerateLods(const Mesh& mesh, const std::vector<float>& ratios, const SimplifyOptions& options) {
+        std::vector<LodLevel> lods;
+        const size_t indexCount = mesh.Indices.size() - mesh.Indices.size() % 3;
+        if (indexCount == 0) return lods;
+
+        // Model space size, to turn the relative error back into a distance
+        glm::vec3 lower = mesh.Positions[0], upper = mesh.Positions[0];
+        for (const auto& p : mesh.Positions) {
+            lower = glm::min(lower, p);
+            upper = glm::max(upper, p);
+        }
+        const float extent = std::max({upper.x - lower.x, upper.y - lower.y, upper.z - lower.z});
+
+        // Each level is simplified from the previous one, so its error adds up
+        LodLevel current = {std::vector<uint32_t>(mesh.Indices.begin(), mesh.Indices.begin() + indexCount), 0.0f};
+        for (float ratio : ratios) {
+            size_t target = (size_t)(indexCount / 3 * std::clamp(ratio, 0.0f, 1.0f)) * 3;
+            if (target < current.Indices.size()) {
+                LodLevel next;
+                float error = 0.0f;
+                Simplify(current.Indices.data(), current.Indices.size(), mesh.Positions.data(), mesh.GetVertexCount(),
+                         target, next.Indices, options, &error);
+                next.Error = current.Error + error * extent;
+
+                // Stop when the error limit keeps the level from getting meaningfully smaller
+                if (!lods.empty() && next.Indices.size() > current.Indices.size() * 9 / 10) break;
+                current = std::move(next);
+            }
+            if (!lods.empty() && lods.back().Indices.size() == current.Indices.size()) continue;
+            lods.push_back(current);
+        }
+
+        for (auto& lod : lods) OptimizeVertexCache(lod.Indices.data(), lod.Indices.size(), mesh.GetVertexCount());
+        return lods;
+    }
+
+    int SelectLod(const std::vector<LodLevel>& lods, float distance, float fovY, float viewportHeight,
+                  float maxPixelError, float scale) {
+        if (lods.empty() || distance <= 0.0f) return 0;
+
+        // Pixels per world unit at this distance
+        float pixels = viewportHeight / (2.0f * distance * std::tan(fovY / 2));
+
+        int lod = 0;
+        while (lod + 1 < (int)lods.size() && lods[lod + 1].Error * scale * pixels <= maxPixelError) lod++;
+        return lod;
+    }
+};
+};
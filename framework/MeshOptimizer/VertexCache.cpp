@@ -0,0 +1,337 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Framework {
+namespace MeshOptimizer {
+
+    namespace {
+        // Tom Forsyth's "Linear-Speed Vertex Cache Optimisation" scoring, for an LRU cache
+        constexpr unsigned int MaxCacheSize = 64;
+        constexpr float CacheDecayPower = 1.5f;
+        constexpr float LastTriangleScore = 0.75f;
+        constexpr float ValenceBoostScale = 2.0f;
+        constexpr float ValenceBoostPower = 0.5f;
+
+        float VertexScore(int cachePosition, uint32_t remainingTriangles, unsigned int cacheSize) {
+            if (remainingTriangles == 0) return -1.0f; // No triangles left: never picked again
+
+            float score = 0.0f;
+            if (cachePosition >= 0) {
+                if (cachePosition < 3) {
+                    // Used by the last triangle: a fixed score, so the next triangle is not
+                    // biased towards any of its edges
+                    score = LastTriangleScore;
+                } else {
+                    float scale = 1.0f / (cacheSize - 3);
+                    score = std::pow(1.0f - (cachePosition - 3) * scale, CacheDecayPower);
+                }
+            }
+
+            // Prefer vertices with few triangles left, so they are finished off
+            score += ValenceBoostScale * std::pow((float)remainingTriangles, -ValenceBoostPower);
+            return score;
+        }
+
+        // Triangles using each vertex, in compressed sparse row form
+        void BuildTriangleAdjacency(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                    std::vector<uint32_t>& offsets, std::vector<uint32_t>& triangles) {
+            offsets.assign(vertexCount + 1, 0);
+            for (size_t i = 0; i < indexCount; i++) offsets[indices[i] + 1]++;
+            for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            triangles.resize(indexCount);
+            for (size_t i = 0; i < indexCount; i++) triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // Misses of a FIFO cache over indices [first, last) starting from an empty cache.
+        // 'stamps' holds one entry per vertex and 'time' must be larger than any entry in it.
+        size_t CountMisses(const uint32_t* indices, size_t first, size_t last, unsigned int cacheSize,
+                           std::vector<size_t>& stamps, size_t& time) {
+            size_t misses = 0;
+            time += cacheSize + 1; // Everything previously cached has expired
+            for (size_t i = first; i < last; i++) {
+                uint32_t v = indices[i];
+                if (time - stamps[v] > cacheSize) {
+                    stamps[v] = time++;
+                    misses++;
+                }
+            }
+            return misses;
+        }
+    }
+
+    VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize) {
+        VertexCacheStatistics statistics = {0, 0.0f, 0.0f};
+        if (indexCount == 0 || vertexCount == 0) return statistics;
+
+        // FIFO: a vertex is cached while fewer than cacheSize misses happened since it was loaded
+        std::vector<size_t> stamps(vertexCount, 0);
+        size_t time = cacheSize + 1;
+        for (size_t i = 0; i < indexCount; i++) {
+            uint32_t v = indices[i];
+            if (time - stamps[v] > cacheSize) {
+                stamps[v] = time++;
+                statistics.VerticesTransformed++;
+            }
+        }
+
+        // Only vertices that are used count towards the ATVR
+        std::vector<bool> used(vertexCount, false);
+        size_t usedCount = 0;
+        for (size_t i = 0; i < indexCount; i++) {
+            if (!used[indices[i]]) { used[indices[i]] = true; usedCount++; }
+        }
+
+        statistics.Acmr = (float)statistics.VerticesTransformed / (indexCount / 3);
+        statistics.Atvr = (float)statistics.VerticesTransformed / usedCount;
+        return statistics;
+    }
+
+    void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize) {
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0) return;
+        cacheSize = std::clamp(cacheSize, 4u, MaxCacheSize);
+
+        std::vector<uint32_t> offsets, adjacency;
+        BuildTriangleAdjacency(indices, indexCount, vertexCount, offsets, adjacency);
+
+        std::vector<uint32_t> remaining(vertexCount);
+        std::vector<float> vertexScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) {
+            remaining[v] = offsets[v + 1] - offsets[v];
+            vertexScore[v] = VertexScore(-1, remaining[v], cacheSize);
+        }
+
+        std::vector<float> triangleScore(triangleCount);
+        for (size_t t = 0; t < triangleCount; t++) {
+            triangleScore[t] = vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]] + vertexScore[indices[3 * t + 2]];
+        }
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> output;
+        output.reserve(indexCount);
+
+        // LRU cache, with room for the three vertices pushed in by each triangle
+        uint32_t cache[MaxCacheSize + 3];
+        uint32_t newCache[MaxCacheSize + 3];
+        unsigned int cacheCount = 0;
+
+        size_t inputCursor = 0; // Fallback when no cached vertex has triangles left
+        size_t best = 0;
+        for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+            if (best == triangleCount) {
+                while (inputCursor < triangleCount && emitted[inputCursor]) inputCursor++;
+                best = inputCursor;
+            }
+
+            const uint32_t* triangle = indices + 3 * best;
+            output.insert(output.end(), triangle, triangle + 3);
+            emitted[best] = true;
+
+            // Remove the triangle from its vertices' adjacency lists
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = triangle[k];
+                uint32_t* begin = &adjacency[offsets[v]];
+                uint32_t* end = begin + remaining[v];
+                *std::find(begin, end, (uint32_t)best) = *(end - 1);
+                remaining[v]--;
+            }
+
+            // Move the triangle's vertices to the front of the cache
+            unsigned int newCount = 0;
+            for (int k = 0; k < 3; k++) {
+                if (std::find(newCache, newCache + newCount, triangle[k]) == newCache + newCount) {
+                    newCache[newCount++] = triangle[k];
+                }
+            }
+            for (unsigned int i = 0; i < cacheCount; i++) {
+                uint32_t v = cache[i];
+                if (std::find(newCache, newCache + newCount, v) == newCache + newCount) newCache[newCount++] = v;
+            }
+
+            // Rescore the cached vertices (and those that just dropped out) and their triangles
+            for (unsigned int i = 0; i < newCount; i++) {
+                uint32_t v = newCache[i];
+                int position = i < cacheSize ? (int)i : -1;
+                float delta = VertexScore(position, remaining[v], cacheSize) - vertexScore[v];
+                vertexScore[v] += delta;
+                for (uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; j++) triangleScore[adjacency[j]] += delta;
+            }
+
+            cacheCount = std::min(newCount, cacheSize);
+            std::copy(newCache, newCache + cacheCount, cache);
+
+            // Next triangle: the best one using a cached vertex
+            best = triangleCount;
+            float bestScore = -1.0f;
+            for (unsigned int i = 0; i < cacheCount; i++) {
+                uint32_t v = cache[i];
+                for (uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; j++) {
+                    uint32_t t = adjacency[j];
+                    if (triangleScore[t] > bestScore) {
+                        bestScore = triangleScore[t];
+                        best = t;
+                    }
+                }
+            }
+        }
+
+        std::copy(output.begin(), output.end(), indices);
+    }
+
+    void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+                          float threshold, unsigned int cacheSize) {
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0) return;
+
+        // Split into clusters: at hard boundaries (triangles whose vertices all miss the cache,
+        // so reordering there costs nothing), and at soft boundaries where the cluster's own
+        // ACMR, starting from an empty cache, stays within 'threshold' of the whole cluster's
+        std::vector<size_t> stamps(vertexCount, 0);
+        size_t time = cacheSize + 1;
+
+        std::vector<size_t> hard = {0};
+        for (size_t t = 0; t < triangleCount; t++) {
+            size_t misses = 0;
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[3 * t + k];
+                if (time - stamps[v] > cacheSize) {
+                    stamps[v] = time++;
+                    misses++;
+                }
+            }
+            if (misses == 3 && t > 0) hard.push_back(t);
+        }
+        hard.push_back(triangleCount);
+
+        std::vector<size_t> clusters;
+        for (size_t h = 0; h + 1 < hard.size(); h++) {
+            size_t start = hard[h], end = hard[h + 1];
+            float clusterAcmr = (float)CountMisses(indices, 3 * start, 3 * end, cacheSize, stamps, time) / (end - start);
+
+            clusters.push_back(start);
+            time += cacheSize + 1;
+            size_t misses = 0;
+            size_t clusterStart = start;
+            for (size_t t = start; t < end; t++) {
+                for (int k = 0; k < 3; k++) {
+                    uint32_t v = indices[3 * t + k];
+                    if (time - stamps[v] > cacheSize) {
+                        stamps[v] = time++;
+                        misses++;
+                    }
+                }
+                size_t count = t + 1 - clusterStart;
+                if (t + 1 < end && count >= 16 && misses <= threshold * clusterAcmr * count) {
+                    clusters.push_back(t + 1);
+                    clusterStart = t + 1;
+                    misses = 0;
+                    time += cacheSize + 1;
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // Mesh center
+        glm::vec3 center(0.0f);
+        float totalArea = 0.0f;
+        for (size_t t = 0; t < triangleCount; t++) {
+            const glm::vec3& a = positions[indices[3 * t]];
+            const glm::vec3& b = positions[indices[3 * t + 1]];
+            const glm::vec3& c = positions[indices[3 * t + 2]];
+            float area = glm::length(glm::cross(b - a, c - a));
+            center += (a + b + c) * (area / 3.0f);
+            totalArea += area;
+        }
+        if (totalArea > 0.0f) center /= totalArea;
+
+        // Clusters facing away from the center (likely occluders) go first
+        const size_t clusterCount = clusters.size() - 1;
+        std::vector<float> sortKey(clusterCount);
+        for (size_t i = 0; i < clusterCount; i++) {
+            glm::vec3 centroid(0.0f), normal(0.0f);
+            float area = 0.0f;
+            for (size_t t = clusters[i]; t < clusters[i + 1]; t++) {
+                const glm::vec3& a = positions[indices[3 * t]];
+                const glm::vec3& b = positions[indices[3 * t + 1]];
+                const glm::vec3& c = positions[indices[3 * t + 2]];
+                glm::vec3 n = glm::cross(b - a, c - a);
+                float triangleArea = glm::length(n);
+                centroid += (a + b + c) * (triangleArea / 3.0f);
+                normal += n;
+                area += triangleArea;
+            }
+            if (area > 0.0f) centroid /= area;
+            float length = glm::length(normal);
+            sortKey[i] = length > 0.0f ? glm::dot(centroid - center, normal / length) : 0.0f;
+        }
+
+        std::vector<size_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&sortKey](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+        std::vector<uint32_t> output;
+        output.reserve(indexCount);
+        for (size_t i : order) {
+            output.insert(output.end(), indices + 3 * clusters[i], indices + 3 * clusters[i + 1]);
+        }
+        std::copy(output.begin(), output.end(), indices);
+    }
+
+    size_t OptimizeVertexFetchRemap(const uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap) {
+        const uint32_t unused = ~0u;
+        remap.assign(vertexCount, unused);
+
+        uint32_t next = 0;
+        for (size_t i = 0; i < indexCount; i++) {
+            if (remap[indices[i]] == unused) remap[indices[i]] = next++;
+        }
+        return next;
+    }
+
+    size_t OptimizeVertexFetch(std::vector<float>& vertices, size_t stride, uint32_t* indices, size_t indexCount) {
+        std::vector<uint32_t> remap;
+        size_t used = OptimizeVertexFetchRemap(indices, indexCount, vertices.size() / stride, remap);
+
+        std::vector<float> reordered(used * stride);
+        for (size_t v = 0; v < remap.size(); v++) {
+            if (remap[v] == ~0u) continue;
+            std::copy(&vertices[v * stride], &vertices[v * stride] + stride, &reordered[remap[v] * stride]);
+        }
+        for (size_t i = 0; i < indexCount; i++) indices[i] = remap[indices[i]];
+
+        vertices.swap(reordered);
+        return used;
+    }
+
+    void OptimizeVertexFetch(Mesh& mesh) {
+        std::vector<uint32_t> remap;
+        size_t used = OptimizeVertexFetchRemap(mesh.Indices.data(), mesh.Indices.size(), mesh.GetVertexCount(), remap);
+
+        auto reorder = [&remap, used](auto& stream) {
+            if (stream.empty()) return;
+            std::remove_reference_t<decltype(stream)> reordered(used);
+            for (size_t v = 0; v < remap.size(); v++) {
+                if (remap[v] != ~0u) reordered[remap[v]] = stream[v];
+            }
+            stream.swap(reordered);
+        };
+        reorder(mesh.Positions);
+        reorder(mesh.Normals);
+        reorder(mesh.TexCoords);
+        reorder(mesh.Tangents);
+
+        for (auto& index : mesh.Indices) index = remap[index];
+    }
+
+    void Optimize(Mesh& mesh) {
+        OptimizeVertexCache(mesh.Indices.data(), mesh.Indices.size(), mesh.GetVertexCount());
+        OptimizeOverdraw(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.GetVertexCount());
+        OptimizeVertexFetch(mesh);
+    }
+};
+};
@@ -0,0 +1,126 @@
+#include "MeshOptimizer.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace Framework {
+namespace MeshOptimizer {
+
+    namespace {
+        // Key of one vertex component: the float's bits (with -0 folded into +0), or its
+        // grid cell when snapping to an epsilon
+        inline uint64_t ComponentKey(float value, float epsilon) {
+            if (epsilon > 0.0f) {
+                return static_cast<uint64_t>(std::llround(static_cast<double>(value) / epsilon));
+            }
+            if (value == 0.0f) value = 0.0f;
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        struct VertexKeys {
+            const float* vertices;
+            size_t stride;
+            float positionEpsilon, attributeEpsilon;
+            size_t positionComponents;
+
+            inline uint64_t Key(size_t vertex, size_t component) const {
+                float epsilon = component < positionComponents ? positionEpsilon : attributeEpsilon;
+                return ComponentKey(vertices[vertex * stride + component], epsilon);
+            }
+
+            uint64_t Hash(size_t vertex) const {
+                uint64_t hash = 0xcbf29ce484222325ull;
+                for (size_t c = 0; c < stride; c++) {
+                    hash ^= Key(vertex, c);
+                    hash *= 0x100000001b3ull;
+                    hash ^= hash >> 29;
+                }
+                return hash;
+            }
+
+            bool Equal(size_t a, size_t b) const {
+                for (size_t c = 0; c < stride; c++) {
+                    if (Key(a, c) != Key(b, c)) return false;
+                }
+                return true;
+            }
+        };
+    }
+
+    size_t WeldRemap(const float* vertices, size_t count, size_t stride, std::vector<uint32_t>& remap, const WeldOptions& options) {
+        remap.resize(count);
+        if (count == 0) return 0;
+
+        VertexKeys keys = {vertices, stride, options.PositionEpsilon, options.AttributeEpsilon, options.PositionComponents};
+
+        // Open addressing table of first occurrences, at most half full
+        size_t capacity = 1;
+        while (capacity < count * 2) capacity <<= 1;
+        const uint32_t empty = ~0u;
+        std::vector<uint32_t> table(capacity, empty);
+
+        size_t unique = 0;
+        for (size_t v = 0; v < count; v++) {
+            size_t slot = keys.Hash(v) & (capacity - 1);
+            while (table[slot] != empty && !keys.Equal(table[slot], v)) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+
+            if (table[slot] == empty) {
+                table[slot] = static_cast<uint32_t>(v);
+                remap[v] = static_cast<uint32_t>(unique++);
+            } else {
+                remap[v] = remap[table[slot]];
+            }
+        }
+        return unique;
+    }
+
+    WeldedVertices Weld(const float* vertices, size_t count, size_t stride, const WeldOptions& options) {
+        WeldedVertices result;
+        size_t unique = WeldRemap(vertices, count, stride, result.Indices, options);
+
+        // Unique vertices are numbered in order of first appearance, so a vertex is new exactly
+        // when its index is the next one
+        result.Vertices.resize(unique * stride);
+        size_t next = 0;
+        for (size_t v = 0; v < count; v++) {
+            if (result.Indices[v] == next) {
+                std::memcpy(&result.Vertices[next * stride], &vertices[v * stride], stride * sizeof(float));
+                next++;
+            }
+        }
+        return result;
+    }
+
+    size_t Weld(Mesh& mesh, const WeldOptions& options) {
+        const size_t count = mesh.GetVertexCount();
+        const size_t stride = mesh.GetStride();
+        std::vector<float> vertices = mesh.Interleave();
+
+        std::vector<uint32_t> remap;
+        size_t unique = WeldRemap(vertices.data(), count, stride, remap, options);
+        if (unique == count) return 0;
+
+        // Compact every stream in place (a vertex never moves up)
+        size_t next = 0;
+        for (size_t v = 0; v < count; v++) {
+            if (remap[v] != next) continue;
+            mesh.Positions[next] = mesh.Positions[v];
+            if (!mesh.Normals.empty()) mesh.Normals[next] = mesh.Normals[v];
+            if (!mesh.TexCoords.empty()) mesh.TexCoords[next] = mesh.TexCoords[v];
+            if (!mesh.Tangents.empty()) mesh.Tangents[next] = mesh.Tangents[v];
+            next++;
+        }
+        mesh.Positions.resize(unique);
+        if (!mesh.Normals.empty()) mesh.Normals.resize(unique);
+        if (!mesh.TexCoords.empty()) mesh.TexCoords.resize(unique);
+        if (!mesh.Tangents.empty()) mesh.Tangents.resize(unique);
+
+        for (auto& index : mesh.Indices) index = remap[index];
+        return count - unique;
+    }
+};
+};
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "GeometricTools.h"
+#include "MeshLoader.h"
+#include "MeshOptimizer.h"
+
+// Vertex cache benchmark: ACMR and ATVR (FIFO-16 simulation) of the board's chunk grids and of a
+// model, as generated, after OptimizeVertexCache and after OptimizeOverdraw. Both passes only
+// reorder whole triangles, so the triangle set must come out unchanged.
+//
+//   meshbench [obj]
+
+using namespace Framework;
+
+namespace {
+    // The triangles with their vertex order, sorted, for comparing triangle sets
+    std::vector<std::array<uint32_t, 3>> Triangles(const std::vector<uint32_t>& indices) {
+        std::vector<std::array<uint32_t, 3>> triangles(indices.size() / 3);
+        for (size_t i = 0; i < triangles.size(); i++) triangles[i] = {indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]};
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // Returns false if a pass changed the triangle set
+    bool Run(const std::string& name, const std::vector<glm::vec3>& positions, std::vector<uint32_t> indices) {
+        const auto original = Triangles(indices);
+        const auto before = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), positions.size());
+
+        auto start = std::chrono::steady_clock::now();
+        MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), positions.size());
+        const double cacheMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const auto cache = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), positions.size());
+        bool same = Triangles(indices) == original;
+
+        start = std::chrono::steady_clock::now();
+        MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), positions.data(), positions.size());
+        const double overdrawMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const auto overdraw = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), positions.size());
+        same = same && Triangles(indices) == original;
+
+        printf("%-10s %9zu   %5.3f %5.3f %5.3f   %5.3f %5.3f %5.3f   %8.2f %8.2f %s\n", name.c_str(), indices.size() / 3,
+               before.Acmr, cache.Acmr, overdraw.Acmr, before.Atvr, cache.Atvr, overdraw.Atvr, cacheMs, overdrawMs,
+               same ? "" : "TRIANGLES CHANGED");
+        return same;
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string model = argc > 1 ? argv[1] : std::string(MODELS_DIR) + "/teacup.obj";
+
+    printf("%-10s %9s   %-17s   %-17s   %17s\n", "", "", "ACMR", "ATVR", "time (ms)");
+    printf("%-10s %9s   %5s %5s %5s   %5s %5s %5s   %8s %8s\n", "mesh", "triangles", "input", "cache", "+over",
+           "input", "cache", "+over", "cache", "overdraw");
+
+    // The board's chunks: 8x8 is the default board, chunks are at most 255 squares wide
+    bool same = true;
+    for (unsigned int size : {8u, 64u, 255u}) {
+        const std::vector<float> grid = GeometricTools::UnitGridGeometry2D(size, size);
+        std::vector<glm::vec3> positions(grid.size() / 2);
+        for (size_t i = 0; i < positions.size(); i++) positions[i] = glm::vec3(grid[2 * i], grid[2 * i + 1], 0.0f);
+        const auto topology = GeometricTools::UnitGridTopologyTriangles(size, size);
+        same &= Run("grid " + std::to_string(size), positions, std::vector<uint32_t>(topology.begin(), topology.end()));
+    }
+
+    Mesh mesh;
+    if (!MeshLoader::LoadOBJ(model, mesh)) {
+        printf("could not load %s\n", model.c_str());
+        return 1;
+    }
+    const size_t slash = model.find_last_of("/\\");
+    std::string name = model.substr(slash == std::string::npos ? 0 : slash + 1);
+    name = name.substr(0, name.find_last_of('.'));
+    same &= Run(name, mesh.Positions, mesh.Indices);
+
+    // Texture seams split vertices that share a position; welded on positions alone, as a depth
+    // or shadow pass would draw it, the model shows what the passes do for shared vertices
+    Mesh positionsOnly;
+    positionsOnly.Positions = mesh.Positions;
+    positionsOnly.Indices = mesh.Indices;
+    MeshOptimizer::Weld(positionsOnly);
+    same &= Run(name + " pos", positionsOnly.Positions, positionsOnly.Indices);
+
+    return same ? 0 : 1;
+}
@@ -23,7 +23,14 @@ namespace Framework {
 
         inline void DrawIndex(const std::shared_ptr<VertexArray>& vao, GLenum primitive)
         {
-            glDrawElements(primitive, vao->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, nullptr);
+            const auto& indexBuffer = vao->GetIndexBuffer();
+            glDrawElements(primitive, indexBuffer->GetCount(), indexBuffer->GetType(), nullptr);
+        }
+
+        inline void DrawIndexInstanced(const std::shared_ptr<VertexArray>& vao, GLenum primitive, GLsizei instanceCount)
+        {
+            const auto& indexBuffer = vao->GetIndexBuffer();
+            glDrawElementsInstanced(primitive, indexBuffer->GetCount(), indexBuffer->GetType(), nullptr, instanceCount);
         }
 
         inline void SetClearColor(glm::vec4 color)
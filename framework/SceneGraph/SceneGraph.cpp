@@ -0,0 +1,215 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+
+namespace Framework {
+
+    namespace {
+        template<typename T>
+        void Permute(std::vector<T>& values, const std::vector<uint32_t>& order) {
+            std::vector<T> permuted;
+            permuted.reserve(order.size());
+            for (uint32_t index : order) permuted.push_back(values[index]);
+            values.swap(permuted);
+        }
+
+        // T * R * S
+        inline glm::mat4 LocalMatrix(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+            glm::mat4 matrix = glm::mat4_cast(rotation);
+            matrix[0] *= scale.x;
+            matrix[1] *= scale.y;
+            matrix[2] *= scale.z;
+            matrix[3] = glm::vec4(translation, 1.0f);
+            return matrix;
+        }
+    }
+
+    SceneGraph::NodeId SceneGraph::CreateNode(NodeId parent) {
+        NodeId id;
+        if (!FreeIds.empty()) {
+            id = FreeIds.back();
+            FreeIds.pop_back();
+        } else {
+            id = static_cast<NodeId>(Slots.size());
+            Slots.push_back(Removed);
+        }
+
+        const uint32_t parentIndex = parent == NoNode ? NoNode : Slots[parent];
+        const uint32_t depth = parent == NoNode ? 0 : Depths[parentIndex] + 1;
+        if (!Depths.empty() && depth < Depths.back()) NeedsSort = true;
+
+        const uint32_t index = static_cast<uint32_t>(Ids.size());
+        Slots[id] = index;
+        Ids.push_back(id);
+        Parents.push_back(parentIndex);
+        Depths.push_back(depth);
+        Translations.push_back(glm::vec3(0.0f));
+        Rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        Scales.push_back(glm::vec3(1.0f));
+        WorldMatrices.push_back(glm::mat4(1.0f));
+        Dirty.push_back(0);
+        WorldChanged.push_back(0);
+        MarkDirty(index);
+        return id;
+    }
+
+    void SceneGraph::DestroyNode(NodeId node) {
+        // Descendants are found in one pass, which needs parents before children
+        if (NeedsSort) Sort();
+
+        const uint32_t first = Slots[node];
+        std::vector<uint8_t> removed(Ids.size() - first, 0);
+        removed[0] = 1;
+        for (uint32_t i = first + 1; i < Ids.size(); i++) {
+            uint32_t parent = Parents[i];
+            removed[i - first] = parent != NoNode && parent >= first && removed[parent - first];
+        }
+
+        // The entries are dropped by the next Sort()
+        for (uint32_t i = first; i < Ids.size(); i++) {
+            if (!removed[i - first]) continue;
+            Slots[Ids[i]] = Removed;
+            FreeIds.push_back(Ids[i]);
+            Ids[i] = NoNode;
+        }
+        NeedsSort = true;
+    }
+
+    bool SceneGraph::IsValid(NodeId node) const {
+        return node < Slots.size() && Slots[node] != Removed;
+    }
+
+    void SceneGraph::SetParent(NodeId node, NodeId parent) {
+        const uint32_t index = Slots[node];
+        const uint32_t parentIndex = parent == NoNode ? NoNode : Slots[parent];
+
+        // A node cannot move into its own subtree
+        for (uint32_t ancestor = parentIndex; ancestor != NoNode; ancestor = Parents[ancestor]) {
+            if (ancestor == index) return;
+        }
+
+        Parents[index] = parentIndex;
+        NeedsSort = true;
+        MarkDirty(index);
+    }
+
+    SceneGraph::NodeId SceneGraph::GetParent(NodeId node) const {
+        uint32_t parent = Parents[Slots[node]];
+        return parent == NoNode ? NoNode : Ids[parent];
+    }
+
+    void SceneGraph::SetTranslation(NodeId node, const glm::vec3& translation) {
+        const uint32_t index = Slots[node];
+        Translations[index] = translation;
+        MarkDirty(index);
+    }
+
+    void SceneGraph::SetRotation(NodeId node, const glm::quat& rotation) {
+        const uint32_t index = Slots[node];
+        Rotations[index] = rotation;
+        MarkDirty(index);
+    }
+
+    void SceneGraph::SetScale(NodeId node, const glm::vec3& scale) {
+        const uint32_t index = Slots[node];
+        Scales[index] = scale;
+        MarkDirty(index);
+    }
+
+    void SceneGraph::SetTransform(NodeId node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+        const uint32_t index = Slots[node];
+        Translations[index] = translation;
+        Rotations[index] = rotation;
+        Scales[index] = scale;
+        MarkDirty(index);
+    }
+
+    void SceneGraph::MarkDirty(uint32_t index) {
+        Dirty[index] = 1;
+        FirstDirty = std::min<size_t>(FirstDirty, index);
+    }
+
+    void SceneGraph::Sort() {
+        const uint32_t count = static_cast<uint32_t>(Ids.size());
+
+        // Depths from the parent links, which may have changed
+        std::vector<uint32_t> chain;
+        std::vector<uint32_t> depths(count, Removed);
+        uint32_t maxDepth = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            if (Ids[i] == NoNode) continue;
+            uint32_t node = i;
+            while (node != NoNode && depths[node] == Removed) {
+                chain.push_back(node);
+                node = Parents[node];
+            }
+            uint32_t depth = node == NoNode ? 0 : depths[node] + 1;
+            while (!chain.empty()) {
+                depths[chain.back()] = depth++;
+                chain.pop_back();
+            }
+            maxDepth = std::max(maxDepth, depths[i]);
+        }
+
+        // Counting sort by depth, keeping the current order within a level
+        std::vector<uint32_t> levelStart(maxDepth + 2, 0);
+        for (uint32_t i = 0; i < count; i++) {
+            if (Ids[i] != NoNode) levelStart[depths[i] + 1]++;
+        }
+        for (uint32_t d = 0; d <= maxDepth; d++) levelStart[d + 1] += levelStart[d];
+        std::vector<uint32_t> order(levelStart.back());
+        std::vector<uint32_t> newIndex(count, NoNode);
+        for (uint32_t i = 0; i < count; i++) {
+            if (Ids[i] == NoNode) continue;
+            newIndex[i] = levelStart[depths[i]]++;
+            order[newIndex[i]] = i;
+        }
+
+        std::vector<uint32_t> parents;
+        parents.reserve(order.size());
+        for (uint32_t i : order) parents.push_back(Parents[i] == NoNode ? NoNode : newIndex[Parents[i]]);
+        Parents.swap(parents);
+        Depths = depths;
+        Permute(Depths, order);
+        Permute(Ids, order);
+        Permute(Translations, order);
+        Permute(Rotations, order);
+        Permute(Scales, order);
+        Permute(WorldMatrices, order);
+        Permute(Dirty, order);
+        Permute(WorldChanged, order);
+
+        for (uint32_t i = 0; i < Ids.size(); i++) Slots[Ids[i]] = i;
+        FirstDirty = std::find(Dirty.begin(), Dirty.end(), 1) - Dirty.begin();
+        ChangedBegin = 0;
+        NeedsSort = false;
+    }
+
+    void SceneGraph::Update() {
+        if (NeedsSort) Sort();
+
+        const size_t count = Ids.size();
+        const size_t first = std::min(FirstDirty, count);
+
+        // Flags from the last update that this one does not overwrite
+        for (size_t i = ChangedBegin; i < first; i++) WorldChanged[i] = 0;
+
+        // Parents come first, so a single pass sees a parent's new matrix before its children
+        for (size_t i = first; i < count; i++) {
+            const uint32_t parent = Parents[i];
+            const bool parentChanged = parent != NoNode && parent >= first && WorldChanged[parent];
+            if (!Dirty[i] && !parentChanged) {
+                WorldChanged[i] = 0;
+                continue;
+            }
+
+            glm::mat4 local = LocalMatrix(Translations[i], Rotations[i], Scales[i]);
+            WorldMatrices[i] = parent == NoNode ? local : WorldMatrices[parent] * local;
+            Dirty[i] = 0;
+            WorldChanged[i] = 1;
+        }
+
+        ChangedBegin = first;
+        FirstDirty = count;
+    }
+};
@@ -0,0 +1,83 @@
+#ifndef SCENEGRAPH_H_
+#define SCENEGRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Framework {
+
+  // Transform hierarchy. Each node has a local translation, rotation and scale relative to its
+  // parent; Update() turns them into world matrices.
+  //
+  // Nodes live in flat arrays sorted by depth, so every parent comes before its children and
+  // Update() is a single pass over the arrays. Changing a node only marks it dirty; the pass
+  // starts at the first dirty node and recomputes the world matrices of dirty nodes and their
+  // descendants only.
+  //
+  // Node ids stay valid until the node is destroyed, after which they may be reused.
+  class SceneGraph {
+  public:
+    using NodeId = uint32_t;
+    static constexpr NodeId NoNode = ~0u;
+
+    // New node with an identity transform, as a child of 'parent' (or a root).
+    NodeId CreateNode(NodeId parent = NoNode);
+    // Destroy the node and all of its descendants.
+    void DestroyNode(NodeId node);
+    bool IsValid(NodeId node) const;
+
+    // Move the node (with its subtree) under another parent, keeping its local transform.
+    void SetParent(NodeId node, NodeId parent);
+    NodeId GetParent(NodeId node) const;
+
+    // Local transform
+    void SetTranslation(NodeId node, const glm::vec3& translation);
+    void SetRotation(NodeId node, const glm::quat& rotation);
+    void SetScale(NodeId node, const glm::vec3& scale);
+    void SetTransform(NodeId node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+    inline const glm::vec3& GetTranslation(NodeId node) const { return Translations[Slots[node]]; }
+    inline const glm::quat& GetRotation(NodeId node) const { return Rotations[Slots[node]]; }
+    inline const glm::vec3& GetScale(NodeId node) const { return Scales[Slots[node]]; }
+
+    // Recompute the world matrices of changed nodes and their descendants.
+    void Update();
+
+    // World matrix as of the last Update().
+    inline const glm::mat4& GetWorldMatrix(NodeId node) const { return WorldMatrices[Slots[node]]; }
+    // True if the node's world matrix changed in the last Update().
+    inline bool IsWorldChanged(NodeId node) const { return WorldChanged[Slots[node]] != 0; }
+
+    inline size_t GetNodeCount() const { return Ids.size(); }
+
+  private:
+    void MarkDirty(uint32_t index);
+    void Sort();
+
+  private:
+    static constexpr uint32_t Removed = ~0u;
+
+    // By id
+    std::vector<uint32_t> Slots;            // Index in the arrays below, Removed if free
+    std::vector<NodeId> FreeIds;
+
+    // By index, sorted by depth
+    std::vector<NodeId> Ids;
+    std::vector<uint32_t> Parents;          // Index of the parent, NoNode for roots
+    std::vector<uint32_t> Depths;
+    std::vector<glm::vec3> Translations;
+    std::vector<glm::quat> Rotations;
+    std::vector<glm::vec3> Scales;
+    std::vector<glm::mat4> WorldMatrices;
+    std::vector<uint8_t> Dirty;             // Local transform or parent changed
+    std::vector<uint8_t> WorldChanged;
+
+    size_t FirstDirty = 0;                  // No dirty nodes before this index
+    size_t ChangedBegin = 0;                // WorldChanged is 0 before this index
+    bool NeedsSort = false;                 // Nodes were reparented or destroyed
+  };
+};
+
+#endif // SCENEGRAPH_H_
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "SceneGraph.h"
+
+// Scene graph check and benchmark.
+//
+// The check runs random creates, edits, reparents and destroys, and after every Update() compares
+// each world matrix to a recursive reference computed from the parent links. The benchmark times
+// one frame of a large random tree with a fraction of the nodes changing, against recomputing
+// every node, once through a tree of heap nodes and once through flat arrays.
+//
+//   scenebench [nodes] [percent changed] [frames]
+
+using namespace Framework;
+
+namespace {
+    // Same generator on every run
+    struct Random {
+        uint64_t State;
+        explicit Random(uint64_t seed) : State(seed) {}
+        uint32_t Next() {
+            State = State * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<uint32_t>(State >> 33);
+        }
+        uint32_t Below(uint32_t count) { return Next() % count; }
+        float Unit() { return Next() / static_cast<float>(1u << 31) * 2.0f - 1.0f; }
+        glm::quat Rotation() { return glm::normalize(glm::quat(Unit(), Unit(), Unit(), Unit() + 2.0f)); }
+    };
+
+    // T * R * S, as SceneGraph computes it
+    glm::mat4 LocalMatrix(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+        glm::mat4 matrix = glm::mat4_cast(rotation);
+        matrix[0] *= scale.x;
+        matrix[1] *= scale.y;
+        matrix[2] *= scale.z;
+        matrix[3] = glm::vec4(translation, 1.0f);
+        return matrix;
+    }
+
+    double Milliseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Check
+
+    struct ReferenceNode {
+        SceneGraph::NodeId Parent;
+        glm::vec3 Translation;
+        glm::quat Rotation;
+        glm::vec3 Scale;
+    };
+    using Reference = std::map<SceneGraph::NodeId, ReferenceNode>;
+
+    glm::mat4 ReferenceWorld(const Reference& reference, SceneGraph::NodeId id) {
+        const ReferenceNode& node = reference.at(id);
+        glm::mat4 local = LocalMatrix(node.Translation, node.Rotation, node.Scale);
+        return node.Parent == SceneGraph::NoNode ? local : ReferenceWorld(reference, node.Parent) * local;
+    }
+
+    bool IsAncestor(const Reference& reference, SceneGraph::NodeId ancestor, SceneGraph::NodeId node) {
+        for (; node != SceneGraph::NoNode; node = reference.at(node).Parent) {
+            if (node == ancestor) return true;
+        }
+        return false;
+    }
+
+    SceneGraph::NodeId RandomNode(const Reference& reference, Random& random) {
+        auto it = reference.begin();
+        std::advance(it, random.Below(static_cast<uint32_t>(reference.size())));
+        return it->first;
+    }
+
+    // Returns the number of mismatching matrices
+    size_t Check(int steps) {
+        Random random(7);
+        SceneGraph graph;
+        Reference reference;
+        size_t mismatches = 0, compared = 0;
+
+        for (int step = 0; step < steps; step++) {
+            const uint32_t action = reference.empty() ? 0 : random.Below(10);
+            if (action < 4) {
+                // Create, under a random node or as a root
+                const SceneGraph::NodeId parent = reference.empty() || random.Below(8) == 0 ? SceneGraph::NoNode : RandomNode(reference, random);
+                const SceneGraph::NodeId id = graph.CreateNode(parent);
+                reference[id] = {parent, glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f)};
+            } else if (action < 7) {
+                const SceneGraph::NodeId id = RandomNode(reference, random);
+                ReferenceNode& node = reference[id];
+                node.Translation = glm::vec3(random.Unit(), random.Unit(), random.Unit());
+                node.Rotation = random.Rotation();
+                node.Scale = glm::vec3(1.0f + 0.5f * random.Unit());
+                graph.SetTransform(id, node.Translation, node.Rotation, node.Scale);
+            } else if (action < 9) {
+                // Reparent; moves into the node's own subtree are refused
+                const SceneGraph::NodeId id = RandomNode(reference, random);
+                const SceneGraph::NodeId parent = random.Below(4) == 0 ? SceneGraph::NoNode : RandomNode(reference, random);
+                graph.SetParent(id, parent);
+                if (!IsAncestor(reference, id, parent)) reference[id].Parent = parent;
+            } else {
+                // Destroy with the subtree
+                const SceneGraph::NodeId id = RandomNode(reference, random);
+                graph.DestroyNode(id);
+                std::vector<SceneGraph::NodeId> removed;
+                for (const auto& entry : reference) {
+                    if (IsAncestor(reference, id, entry.first)) removed.push_back(entry.first);
+                }
+                for (SceneGraph::NodeId node : removed) reference.erase(node);
+            }
+
+            if (step % 8 != 7) continue;
+            graph.Update();
+            if (graph.GetNodeCount() != reference.size()) mismatches++;
+            for (const auto& entry : reference) {
+                compared++;
+                if (!graph.IsValid(entry.first) || graph.GetParent(entry.first) != entry.second.Parent
+                    || graph.GetWorldMatrix(entry.first) != ReferenceWorld(reference, entry.first)) {
+                    mismatches++;
+                }
+            }
+        }
+
+        printf("check: %d steps, %zu matrices compared, %zu mismatches\n\n", steps, compared, mismatches);
+        return mismatches;
+    }
+
+    // Benchmark
+
+    struct HeapNode {
+        glm::vec3 Translation = glm::vec3(0.0f);
+        glm::quat Rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 Scale = glm::vec3(1.0f);
+        glm::mat4 World;
+        std::vector<HeapNode*> Children;
+    };
+
+    void UpdateRecursive(HeapNode* node, const glm::mat4& parentWorld) {
+        node->World = parentWorld * LocalMatrix(node->Translation, node->Rotation, node->Scale);
+        for (HeapNode* child : node->Children) UpdateRecursive(child, node->World);
+    }
+}
+
+int main(int argc, char** argv) {
+    const int nodeCount = argc > 1 ? atoi(argv[1]) : 100000;
+    const double percent = argc > 2 ? atof(argv[2]) : 1.0;
+    const int frames = argc > 3 ? atoi(argv[3]) : 100;
+    if (nodeCount < 2 || percent <= 0.0 || percent > 100.0 || frames < 1) {
+        printf("usage: scenebench [nodes] [percent changed] [frames]\n");
+        return 1;
+    }
+
+    const size_t mismatches = Check(20000);
+
+    // A random tree: every node hangs under an earlier one, node 0 is the root
+    Random random(1);
+    std::vector<uint32_t> parents(nodeCount, SceneGraph::NoNode);
+    for (int i = 1; i < nodeCount; i++) parents[i] = random.Below(i);
+    const int changedPerFrame = std::max(1, static_cast<int>(nodeCount * percent / 100.0));
+
+    // The same changes for every variant
+    std::vector<uint32_t> changed(static_cast<size_t>(frames) * changedPerFrame);
+    std::vector<glm::quat> rotations(changed.size());
+    for (size_t i = 0; i < changed.size(); i++) {
+        changed[i] = random.Below(nodeCount);
+        rotations[i] = random.Rotation();
+    }
+
+    // Scene graph, dirty propagation
+    SceneGraph graph;
+    std::vector<SceneGraph::NodeId> ids(nodeCount);
+    for (int i = 0; i < nodeCount; i++) ids[i] = graph.CreateNode(i == 0 ? SceneGraph::NoNode : ids[parents[i]]);
+    graph.Update();
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int c = 0; c < changedPerFrame; c++) {
+            const size_t i = static_cast<size_t>(frame) * changedPerFrame + c;
+            graph.SetRotation(ids[changed[i]], rotations[i]);
+        }
+        graph.Update();
+    }
+    const double graphMs = Milliseconds(start) / frames;
+
+    // Heap nodes, full recompute
+    std::vector<std::unique_ptr<HeapNode>> heap;
+    for (int i = 0; i < nodeCount; i++) heap.push_back(std::make_unique<HeapNode>());
+    for (int i = 1; i < nodeCount; i++) heap[parents[i]]->Children.push_back(heap[i].get());
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int c = 0; c < changedPerFrame; c++) {
+            const size_t i = static_cast<size_t>(frame) * changedPerFrame + c;
+            heap[changed[i]]->Rotation = rotations[i];
+        }
+        UpdateRecursive(heap[0].get(), glm::mat4(1.0f));
+    }
+    const double heapMs = Milliseconds(start) / frames;
+
+    // Flat arrays (parents first), full recompute
+    std::vector<glm::vec3> translations(nodeCount, glm::vec3(0.0f)), scales(nodeCount, glm::vec3(1.0f));
+    std::vector<glm::quat> flatRotations(nodeCount, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    std::vector<glm::mat4> worlds(nodeCount);
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int c = 0; c < changedPerFrame; c++) {
+            const size_t i = static_cast<size_t>(frame) * changedPerFrame + c;
+            flatRotations[changed[i]] = rotations[i];
+        }
+        for (int i = 0; i < nodeCount; i++) {
+            const glm::mat4 local = LocalMatrix(translations[i], flatRotations[i], scales[i]);
+            worlds[i] = i == 0 ? local : worlds[parents[i]] * local;
+        }
+    }
+    const double flatMs = Milliseconds(start) / frames;
+
+    // All three must end with the same matrices
+    size_t differ = 0;
+    for (int i = 0; i < nodeCount; i++) {
+        differ += graph.GetWorldMatrix(ids[i]) != worlds[i] || heap[i]->World != worlds[i];
+    }
+
+    printf("%d nodes, %d changed per frame, %d frames\n", nodeCount, changedPerFrame, frames);
+    printf("  dirty propagation:            %8.3f ms/frame\n", graphMs);
+    printf("  full recompute, heap nodes:   %8.3f ms/frame\n", heapMs);
+    printf("  full recompute, flat arrays:  %8.3f ms/frame\n", flatMs);
+    printf("  final matrices differing:     %8zu\n", differ);
+
+    return mismatches == 0 && differ == 0 ? 0 : 1;
+}
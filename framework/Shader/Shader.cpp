@@ -33,6 +33,27 @@ namespace Framework {
         glDeleteShader(fragmentShader);
     }
 
+    Shader::Shader(const std::string &computeSrc) {
+
+        auto computeShader = CompileShader(GL_COMPUTE_SHADER, computeSrc);
+        if (computeShader == 0) {
+            std::cout << "Failed to compile compute shader! Exitting ...\n";
+            std::exit(1);
+        }
+
+        ShaderProgram = glCreateProgram();
+        glAttachShader(ShaderProgram, computeShader);
+
+        glLinkProgram(ShaderProgram);
+        GLint result;
+        glGetProgramiv(ShaderProgram, GL_LINK_STATUS, &result);
+        if (result == GL_FALSE) {
+            std::cout << "Linking of compute shader failed! Exitting...\n";
+            std::exit(1);
+        }
+        glDeleteShader(computeShader);
+    }
+
     Shader::~Shader() {
         glDeleteProgram(ShaderProgram); //deletes the specified shader program
     }
@@ -12,6 +12,8 @@ namespace Framework {
   {
   public:
     Shader(const std::string &vertexSrc, const std::string &fragmentSrc);
+    // Compute shader program (run it with glDispatchCompute while bound).
+    explicit Shader(const std::string &computeSrc);
     ~Shader();
 
     void Bind() const;
@@ -21,7 +21,15 @@ namespace Framework {
     Int2,
     Int3,
     Int4,
-    Bool
+    Bool,
+
+    // Packed types, read as floats by the shader. Each is 4 or 8 bytes however many
+    // components it has, e.g. a normal in Int2_10_10_10_Rev takes 4 bytes instead of 12.
+    Half2,              // 16-bit floats
+    Half4,
+    Snorm8x4,           // Signed normalized: [-127, 127] read as [-1, 1]
+    Unorm8x4,           // Unsigned normalized: [0, 255] read as [0, 1]
+    Int2_10_10_10_Rev   // Signed normalized x, y, z (10 bits) and w (2 bits), x in the low bits
   };
 
   // =============================================================================
@@ -42,6 +50,11 @@ namespace Framework {
       case ShaderDataType::Int3: return 4 * 3;
       case ShaderDataType::Int4: return 4 * 4;
       case ShaderDataType::Bool: return 1;
+      case ShaderDataType::Half2: return 2 * 2;
+      case ShaderDataType::Half4: return 2 * 4;
+      case ShaderDataType::Snorm8x4: return 4;
+      case ShaderDataType::Unorm8x4: return 4;
+      case ShaderDataType::Int2_10_10_10_Rev: return 4;
       case ShaderDataType::None: return 0;
     }
 
@@ -63,6 +76,11 @@ namespace Framework {
       case ShaderDataType::Int3: return GL_INT;
       case ShaderDataType::Int4: return GL_INT;
       case ShaderDataType::Bool: return GL_INT;
+      case ShaderDataType::Half2: return GL_HALF_FLOAT;
+      case ShaderDataType::Half4: return GL_HALF_FLOAT;
+      case ShaderDataType::Snorm8x4: return GL_BYTE;
+      case ShaderDataType::Unorm8x4: return GL_UNSIGNED_BYTE;
+      case ShaderDataType::Int2_10_10_10_Rev: return GL_INT_2_10_10_10_REV;
       case ShaderDataType::None: return GL_INT;
     }
 
@@ -84,11 +102,30 @@ namespace Framework {
       case ShaderDataType::Int3: return 3;
       case ShaderDataType::Int4: return 4;
       case ShaderDataType::Bool: return 1;
+      case ShaderDataType::Half2: return 2;
+      case ShaderDataType::Half4: return 4;
+      case ShaderDataType::Snorm8x4: return 4;
+      case ShaderDataType::Unorm8x4: return 4;
+      case ShaderDataType::Int2_10_10_10_Rev: return 4;
       case ShaderDataType::None: return 0;
     }
     
     return 0;
   }
+
+  // Integer values that must be mapped to [-1, 1] or [0, 1] for the shader
+  constexpr bool ShaderDataTypeIsNormalized(ShaderDataType type)
+  {
+    return type == ShaderDataType::Snorm8x4 || type == ShaderDataType::Unorm8x4
+        || type == ShaderDataType::Int2_10_10_10_Rev;
+  }
+
+  // Types read as integers (ivec) by the shader
+  constexpr bool ShaderDataTypeIsInteger(ShaderDataType type)
+  {
+    return type == ShaderDataType::Int || type == ShaderDataType::Int2
+        || type == ShaderDataType::Int3 || type == ShaderDataType::Int4;
+  }
 };
 
 #endif // SHADERSDATATYPES_H_
@@ -0,0 +1,529 @@
+// This is the MipmapGenerator.cpp
+#include "MipmapGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define MIPMAP_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define MIPMAP_AVX2
+#include <immintrin.h>
+#endif
+
+namespace Framework {
+  namespace MipmapGenerator {
+    namespace {
+
+      // One RGBA texel in linear light
+      struct alignas(16) Pixel
+      {
+        float c[4];
+      };
+
+      // Leaves new pixels uninitialized when an image grows: the filters write every pixel
+      template <class T>
+      struct UninitializedAllocator : std::allocator<T>
+      {
+        template <class U>
+        struct rebind
+        {
+          using other = UninitializedAllocator<U>;
+        };
+
+        UninitializedAllocator() = default;
+        template <class U>
+        UninitializedAllocator(const UninitializedAllocator<U>&) {}
+
+        template <class U>
+        void construct(U* p) { ::new (static_cast<void*>(p)) U; }
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+      };
+
+      using Image = std::vector<Pixel, UninitializedAllocator<Pixel>>;
+
+      // Conversion tables between bytes and linear floats. The two byte tables sit side by side,
+      // so one gather can take color from one and alpha from the other.
+      struct Tables
+      {
+        float toLinear[2][256];             // sRGB bytes, then plain bytes (i / 255)
+        unsigned char toSRGB[16384 + 3];    // Padded, so a 32-bit gather of the last entry stays inside
+      };
+
+      const Tables& GetTables()
+      {
+        static const Tables tables = []() {
+          Tables t = {};
+          for (int i = 0; i < 256; i++)
+            {
+            float s = i / 255.0f;
+            t.toLinear[0][i] = s <= 0.04045f ? s / 12.92f : std::pow((s + 0.055f) / 1.055f, 2.4f);
+            t.toLinear[1][i] = s;
+            }
+          for (int i = 0; i < 16384; i++)
+            {
+            float l = i / 16383.0f;
+            float s = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            t.toSRGB[i] = static_cast<unsigned char>(std::clamp(s, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+          return t;
+        }();
+        return tables;
+      }
+
+      // Kaiser windowed sinc for 2:1 reduction. Output texel x is centered between source
+      // texels 2x and 2x+1, so the six taps cover source texels 2x-2 .. 2x+3.
+      constexpr int KaiserTaps = 6;
+
+      const std::array<float, KaiserTaps>& KaiserWeights()
+      {
+        static const std::array<float, KaiserTaps> weights = []() {
+          const double pi = 3.14159265358979323846;
+          const double beta = 4.0, radius = 3.0;
+          auto besselI0 = [](double x) {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; k++)
+              {
+              term *= (x / (2.0 * k)) * (x / (2.0 * k));
+              sum += term;
+              }
+            return sum;
+          };
+
+          std::array<float, KaiserTaps> w;
+          double total = 0.0;
+          double raw[KaiserTaps];
+          for (int k = 0; k < KaiserTaps; k++)
+            {
+            double d = std::abs((k - 2) - 0.5); // Distance from the output center in source texels
+            double sinc = std::sin(pi * d / 2.0) / (pi * d / 2.0);
+            double window = besselI0(beta * std::sqrt(1.0 - (d / radius) * (d / radius))) / besselI0(beta);
+            raw[k] = sinc * window;
+            total += raw[k];
+            }
+          for (int k = 0; k < KaiserTaps; k++)
+            {
+            w[k] = static_cast<float>(raw[k] / total);
+            }
+          return w;
+        }();
+        return weights;
+      }
+
+      // The SIMD paths convert exactly as the scalar loop does: the same division by 255 and the
+      // same table entries when decoding, the same clamp, scale and truncation when encoding
+      template <bool Simd>
+      void Decode(const unsigned char* rgba, size_t count, ColorSpace colorSpace, Pixel* out)
+      {
+        // Pick the per-channel conversion up front so the loop is branch free
+        const auto& tables = GetTables();
+        const float* color = tables.toLinear[colorSpace == ColorSpace::sRGB ? 0 : 1];
+        const float* linear = tables.toLinear[1];
+        size_t i = 0;
+
+#ifdef MIPMAP_SSE2
+        if (Simd && colorSpace == ColorSpace::Linear)
+          {
+          // Four texels: bytes widened to 32-bit integers, converted and divided
+          const __m128i zero = _mm_setzero_si128();
+          const __m128 scale = _mm_set1_ps(255.0f);
+          for (; i + 4 <= count; i += 4)
+            {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 4));
+            __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            _mm_store_ps(out[i + 0].c, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+            _mm_store_ps(out[i + 1].c, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+            _mm_store_ps(out[i + 2].c, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+            _mm_store_ps(out[i + 3].c, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+            }
+          }
+#endif
+#ifdef MIPMAP_AVX2
+        if (Simd && colorSpace == ColorSpace::sRGB)
+          {
+          // Two texels per gather, alpha from the second table
+          const __m256i alpha = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+          for (; i + 2 <= count; i += 2)
+            {
+            __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rgba + i * 4)));
+            _mm256_storeu_ps(out[i].c, _mm256_i32gather_ps(tables.toLinear[0], _mm256_add_epi32(bytes, alpha), 4));
+            }
+          }
+#endif
+
+        for (; i < count; i++)
+          {
+          out[i].c[0] = color[rgba[i * 4 + 0]];
+          out[i].c[1] = color[rgba[i * 4 + 1]];
+          out[i].c[2] = color[rgba[i * 4 + 2]];
+          out[i].c[3] = linear[rgba[i * 4 + 3]];
+          }
+      }
+
+      // The rows of the level being filtered. Level 0 is decoded from its bytes as the filters
+      // ask for rows, into one of two row buffers, so the full-size image is never held in float.
+      template <bool Simd>
+      class Rows
+      {
+      public:
+        Rows(const unsigned char* rgba, int width, ColorSpace colorSpace)
+          : bytes(rgba), width(width), colorSpace(colorSpace), buffer(2 * static_cast<size_t>(width)) {}
+
+        void SetImage(const Image& level, int levelWidth)
+        {
+          bytes = nullptr;
+          image = &level;
+          width = levelWidth;
+        }
+
+        // Valid until the row after next is asked for
+        const Pixel* operator()(int y)
+        {
+          if (!bytes)
+            {
+            return &(*image)[static_cast<size_t>(y) * width];
+            }
+          Pixel* row = &buffer[(y & 1) * static_cast<size_t>(width)];
+          Decode<Simd>(bytes + static_cast<size_t>(y) * width * 4, width, colorSpace, row);
+          return row;
+        }
+
+      private:
+        const unsigned char* bytes;
+        const Image* image = nullptr;
+        int width;
+        ColorSpace colorSpace;
+        Image buffer;
+      };
+
+      template <bool Simd>
+      std::vector<unsigned char> Encode(const Image& image, ColorSpace colorSpace)
+      {
+        const auto& tables = GetTables();
+        const bool srgb = colorSpace == ColorSpace::sRGB;
+        std::vector<unsigned char> rgba(image.size() * 4);
+        size_t i = 0;
+
+#ifdef MIPMAP_SSE2
+        if (Simd)
+          {
+          // Four texels: clamped, scaled to bytes (or sRGB table indices), truncated, then
+          // packed to bytes with unsigned saturation
+          const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), half = _mm_set1_ps(0.5f);
+          const __m128 scale = srgb ? _mm_setr_ps(16383.0f, 16383.0f, 16383.0f, 255.0f) : _mm_set1_ps(255.0f);
+          for (; i + 4 <= image.size(); i += 4)
+            {
+            __m128i q[4];
+            for (int k = 0; k < 4; k++)
+              {
+              __m128 v = _mm_min_ps(_mm_max_ps(_mm_load_ps(image[i + k].c), zero), one);
+              q[k] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half));
+              }
+
+            if (srgb)
+              {
+#ifdef MIPMAP_AVX2
+              const __m256i low = _mm256_set1_epi32(0xff);
+              for (int k = 0; k < 4; k += 2)
+                {
+                __m256i index = _mm256_inserti128_si256(_mm256_castsi128_si256(q[k]), q[k + 1], 1);
+                __m256i encoded = _mm256_and_si256(
+                  _mm256_i32gather_epi32(reinterpret_cast<const int*>(tables.toSRGB), index, 1), low);
+                encoded = _mm256_blend_epi32(encoded, index, 0x88); // Alpha is already a byte
+                q[k] = _mm256_castsi256_si128(encoded);
+                q[k + 1] = _mm256_extracti128_si256(encoded, 1);
+                }
+#else
+              alignas(16) int index[16];
+              for (int k = 0; k < 4; k++)
+                {
+                _mm_store_si128(reinterpret_cast<__m128i*>(&index[k * 4]), q[k]);
+                }
+              for (int k = 0; k < 16; k++)
+                {
+                index[k] = k % 4 == 3 ? index[k] : tables.toSRGB[index[k]];
+                }
+              for (int k = 0; k < 4; k++)
+                {
+                q[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(&index[k * 4]));
+                }
+#endif
+              }
+
+            __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&rgba[i * 4]), bytes);
+            }
+          }
+#endif
+
+        for (; i < image.size(); i++)
+          {
+          const float* c = image[i].c;
+          unsigned char* out = &rgba[i * 4];
+          // Clamp, since the Kaiser filter can overshoot
+          for (int j = 0; j < 3; j++)
+            {
+            float v = std::clamp(c[j], 0.0f, 1.0f);
+            out[j] = srgb ? tables.toSRGB[static_cast<int>(v * 16383.0f + 0.5f)] : static_cast<unsigned char>(v * 255.0f + 0.5f);
+            }
+          out[3] = static_cast<unsigned char>(std::clamp(c[3], 0.0f, 1.0f) * 255.0f + 0.5f);
+          }
+        return rgba;
+      }
+
+      // All code paths add in the same order ((a + b) + (c + d)), so they agree bit for bit
+      template <bool Simd>
+      void BoxDownsample(Rows<Simd>& src, int width, int height, Image& dst, int w, int h)
+      {
+        for (int y = 0; y < h; y++)
+          {
+          const Pixel* row0 = src(std::min(2 * y, height - 1));
+          const Pixel* row1 = src(std::min(2 * y + 1, height - 1));
+          Pixel* out = &dst[y * w];
+          int x = 0;
+
+#ifdef MIPMAP_AVX2
+          if (Simd)
+            {
+            const __m256 quarter = _mm256_set1_ps(0.25f);
+            for (; x + 1 < w && 2 * x + 3 < width; x += 2)
+              {
+              __m256 a = _mm256_add_ps(_mm256_loadu_ps(row0[2 * x].c), _mm256_loadu_ps(row1[2 * x].c));
+              __m256 b = _mm256_add_ps(_mm256_loadu_ps(row0[2 * x + 2].c), _mm256_loadu_ps(row1[2 * x + 2].c));
+              __m256 sum = _mm256_add_ps(_mm256_permute2f128_ps(a, b, 0x20), _mm256_permute2f128_ps(a, b, 0x31));
+              _mm256_storeu_ps(out[x].c, _mm256_mul_ps(sum, quarter));
+              }
+            }
+#endif
+
+          for (; x < w; x++)
+            {
+            int x0 = std::min(2 * x, width - 1);
+            int x1 = std::min(2 * x + 1, width - 1);
+#ifdef MIPMAP_SSE2
+            if (Simd)
+              {
+              __m128 a = _mm_add_ps(_mm_load_ps(row0[x0].c), _mm_load_ps(row1[x0].c));
+              __m128 b = _mm_add_ps(_mm_load_ps(row0[x1].c), _mm_load_ps(row1[x1].c));
+              _mm_store_ps(out[x].c, _mm_mul_ps(_mm_add_ps(a, b), _mm_set1_ps(0.25f)));
+              continue;
+              }
+#endif
+            for (int c = 0; c < 4; c++)
+              {
+              out[x].c[c] = ((row0[x0].c[c] + row1[x0].c[c]) + (row0[x1].c[c] + row1[x1].c[c])) * 0.25f;
+              }
+            }
+          }
+      }
+
+      // Horizontal pass: src (width x height) -> dst (w x height)
+      template <bool Simd>
+      void KaiserHorizontal(Rows<Simd>& src, int width, int height, Image& dst, int w)
+      {
+        const auto& weights = KaiserWeights();
+        for (int y = 0; y < height; y++)
+          {
+          const Pixel* row = src(y);
+          Pixel* out = &dst[y * w];
+          int x = 0;
+
+#ifdef MIPMAP_AVX2
+          if (Simd)
+            {
+            for (; x + 1 < w; x += 2)
+              {
+              __m256 acc = _mm256_setzero_ps();
+              for (int k = 0; k < KaiserTaps; k++)
+                {
+                int i0 = std::clamp(2 * x - 2 + k, 0, width - 1);
+                int i1 = std::clamp(2 * x + k, 0, width - 1);
+                __m256 p = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(row[i0].c)), _mm_load_ps(row[i1].c), 1);
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(p, _mm256_set1_ps(weights[k])));
+                }
+              _mm256_storeu_ps(out[x].c, acc);
+              }
+            }
+#endif
+
+          for (; x < w; x++)
+            {
+#ifdef MIPMAP_SSE2
+            if (Simd)
+              {
+              __m128 acc = _mm_setzero_ps();
+              for (int k = 0; k < KaiserTaps; k++)
+                {
+                int i = std::clamp(2 * x - 2 + k, 0, width - 1);
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(row[i].c), _mm_set1_ps(weights[k])));
+                }
+              _mm_store_ps(out[x].c, acc);
+              continue;
+              }
+#endif
+            Pixel acc = {{0.0f, 0.0f, 0.0f, 0.0f}};
+            for (int k = 0; k < KaiserTaps; k++)
+              {
+              int i = std::clamp(2 * x - 2 + k, 0, width - 1);
+              for (int c = 0; c < 4; c++)
+                {
+                acc.c[c] = acc.c[c] + row[i].c[c] * weights[k];
+                }
+              }
+            out[x] = acc;
+            }
+          }
+      }
+
+      // Vertical pass: src (w x height) -> dst (w x h)
+      template <bool Simd>
+      void KaiserVertical(const Image& src, int w, int height, Image& dst, int h)
+      {
+        const auto& weights = KaiserWeights();
+        for (int y = 0; y < h; y++)
+          {
+          const Pixel* rows[KaiserTaps];
+          for (int k = 0; k < KaiserTaps; k++)
+            {
+            rows[k] = &src[std::clamp(2 * y - 2 + k, 0, height - 1) * w];
+            }
+          Pixel* out = &dst[y * w];
+          int x = 0;
+
+#ifdef MIPMAP_AVX2
+          if (Simd)
+            {
+            for (; x + 1 < w; x += 2)
+              {
+              __m256 acc = _mm256_setzero_ps();
+              for (int k = 0; k < KaiserTaps; k++)
+                {
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(rows[k][x].c), _mm256_set1_ps(weights[k])));
+                }
+              _mm256_storeu_ps(out[x].c, acc);
+              }
+            }
+#endif
+
+          for (; x < w; x++)
+            {
+#ifdef MIPMAP_SSE2
+            if (Simd)
+              {
+              __m128 acc = _mm_setzero_ps();
+              for (int k = 0; k < KaiserTaps; k++)
+                {
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(rows[k][x].c), _mm_set1_ps(weights[k])));
+                }
+              _mm_store_ps(out[x].c, acc);
+              continue;
+              }
+#endif
+            Pixel acc = {{0.0f, 0.0f, 0.0f, 0.0f}};
+            for (int k = 0; k < KaiserTaps; k++)
+              {
+              for (int c = 0; c < 4; c++)
+                {
+                acc.c[c] = acc.c[c] + rows[k][x].c[c] * weights[k];
+                }
+              }
+            out[x] = acc;
+            }
+          }
+      }
+
+      template <bool Simd>
+      MipChain Build(const unsigned char* rgba, int width, int height, Filter filter, ColorSpace colorSpace)
+      {
+        MipChain chain;
+        if (!rgba || width <= 0 || height <= 0)
+          {
+          return chain;
+          }
+
+        chain.reserve(LevelCount(width, height));
+        chain.emplace_back(rgba, rgba + static_cast<size_t>(width) * height * 4);
+
+        // Every level is filtered from the previous one in linear float, so rounding
+        // errors do not accumulate down the chain
+        Rows<Simd> rows(rgba, width, colorSpace);
+        Image current, next, temp;
+
+        while (width > 1 || height > 1)
+          {
+          int w = std::max(1, width / 2);
+          int h = std::max(1, height / 2);
+          next.resize(static_cast<size_t>(w) * h);
+
+          if (filter == Filter::Kaiser)
+            {
+            // A dimension which is already 1 is not filtered
+            if (width > 1)
+              {
+              temp.resize(static_cast<size_t>(w) * height);
+              KaiserHorizontal<Simd>(rows, width, height, temp, w);
+              }
+            else
+              {
+              temp.resize(height);
+              for (int y = 0; y < height; y++)
+                {
+                temp[y] = *rows(y);
+                }
+              }
+
+            if (height > 1)
+              {
+              KaiserVertical<Simd>(temp, w, height, next, h);
+              }
+            else
+              {
+              next = temp;
+              }
+            }
+          else
+            {
+            BoxDownsample<Simd>(rows, width, height, next, w, h);
+            }
+
+          chain.push_back(Encode<Simd>(next, colorSpace));
+          current.swap(next);
+          rows.SetImage(current, w);
+          width = w;
+          height = h;
+          }
+
+        return chain;
+      }
+    };
+
+    MipChain Generate(const unsigned char* rgba, int width, int height, Filter filter, ColorSpace colorSpace)
+    {
+      return Build<true>(rgba, width, height, filter, colorSpace);
+    }
+
+    MipChain GenerateReference(const unsigned char* rgba, int width, int height, Filter filter, ColorSpace colorSpace)
+    {
+      return Build<false>(rgba, width, height, filter, colorSpace);
+    }
+
+    int LevelCount(int width, int height)
+    {
+      int levels = 1;
+      while (width > 1 || height > 1)
+        {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        levels++;
+        }
+      return levels;
+    }
+  };
+};
@@ -0,0 +1,47 @@
+// This is the MipmapGenerator.h file
+#ifndef MIPMAPGENERATOR_H_
+#define MIPMAPGENERATOR_H_
+#pragma once
+
+// STD includes
+#include <vector>
+
+namespace Framework {
+
+  // CPU mip chain generation for RGBA8 images.
+  //
+  // Filtering is done in linear light: color channels stored as sRGB are decoded before
+  // filtering and re-encoded afterwards, so bright and dark texels average correctly.
+  // The inner loops use SSE2 (and AVX2 when the framework is built with it); the scalar
+  // reference produces bit-identical results.
+  namespace MipmapGenerator {
+
+    enum class Filter { Box, Kaiser };
+    enum class ColorSpace { Linear, sRGB };
+
+    using MipChain = std::vector<std::vector<unsigned char>>;
+
+    /**
+     *  Full mip chain of an RGBA8 image, down to 1x1.
+     *
+     *  Level n has size max(1, width >> n) x max(1, height >> n). Level 0 is a copy of the input.
+     *
+     *  @returns Vector of levels (RGBA8, tightly packed)
+     */
+    MipChain Generate(const unsigned char* rgba, int width, int height,
+                      Filter filter = Filter::Box, ColorSpace colorSpace = ColorSpace::sRGB);
+
+    /**
+     *  Scalar version of Generate(), used as reference for the SIMD code paths.
+     */
+    MipChain GenerateReference(const unsigned char* rgba, int width, int height,
+                               Filter filter = Filter::Box, ColorSpace colorSpace = ColorSpace::sRGB);
+
+    /**
+     *  Number of levels in a full mip chain.
+     */
+    int LevelCount(int width, int height);
+  };
+};
+
+#endif // MIPMAPGENERATOR_H_
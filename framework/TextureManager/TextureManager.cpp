@@ -1,104 +1,481 @@
 // This is the TextureManager.cpp
 #include "TextureManager.h"
 
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 
 namespace Framework {
-  bool TextureManager::LoadTexture2DRGBA(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap)
+
+  // ARB_bindless_texture is not part of the generated glad loader, so the few entry points
+  // we need are fetched by hand once the extension has been found.
+  namespace {
+    typedef GLuint64 (APIENTRYP PFNGLGETTEXTUREHANDLEARBPROC)(GLuint texture);
+    typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLERESIDENTARBPROC)(GLuint64 handle);
+    typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)(GLuint64 handle);
+
+    PFNGLGETTEXTUREHANDLEARBPROC glGetTextureHandleARB = nullptr;
+    PFNGLMAKETEXTUREHANDLERESIDENTARBPROC glMakeTextureHandleResidentARB = nullptr;
+    PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC glMakeTextureHandleNonResidentARB = nullptr;
+
+    bool HasExtension(const char* extension)
+    {
+      GLint count = 0;
+      glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+      for (GLint i = 0; i < count; i++)
+        {
+        auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && !strcmp(name, extension))
+          {
+          return true;
+          }
+        }
+      return false;
+    }
+
+    // RGBA8, plus a third for the mip chain
+    GLsizeiptr EstimateBytes(int width, int height, int faces, bool mipMap)
+    {
+      GLsizeiptr bytes = static_cast<GLsizeiptr>(width) * height * 4 * faces;
+      return mipMap ? bytes + bytes / 3 : bytes;
+    }
+  };
+
+  bool TextureManager::LoadTexture2DRGBA(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap, bool flipVertically)
+  {
+    Texture texture;
+    MipmapGenerator::MipChain mips;
+    if (!this->DecodeTexture2D(filePath, mipMap, flipVertically, this->MipFilter.load(), texture, mips))
+      {
+      return false;
+      }
+
+    texture.name = name;
+    texture.unit = unit;
+    this->AddTexture2D(texture, mips);
+
+    return true;
+  }
+
+  void TextureManager::LoadTexture2DRGBAAsync(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap, bool flipVertically)
+  {
+    this->PendingLoads++;
+    auto filter = this->MipFilter.load();
+    this->GetLoader().Submit([this, name, filePath, unit, mipMap, flipVertically, filter]() {
+      // Decoding and mip generation happen here, off the render thread
+      PendingTexture pending;
+      pending.faces.resize(1);
+      pending.ok = this->DecodeTexture2D(filePath, mipMap, flipVertically, filter, pending.texture, pending.faces[0]);
+      pending.texture.name = name;
+      pending.texture.unit = unit;
+
+      std::lock_guard<std::mutex> lock(this->PendingMutex);
+      this->Finished.push_back(std::move(pending));
+    });
+  }
+
+  size_t TextureManager::ProcessPendingLoads()
+  {
+    std::vector<PendingTexture> finished;
+    {
+      std::lock_guard<std::mutex> lock(this->PendingMutex);
+      finished.swap(this->Finished);
+    }
+
+    size_t uploaded = 0;
+    for (auto& pending : finished)
+      {
+      if (!pending.ok)
+        {
+        std::cout << "Failed to load texture " << pending.texture.filePath << "\n";
+        continue;
+        }
+      // The whole chain is uploaded at once
+      if (pending.texture.type == CubeMap)
+        {
+        this->AddCubeMap(pending.texture, pending.faces);
+        }
+      else
+        {
+        this->AddTexture2D(pending.texture, pending.faces[0]);
+        }
+      uploaded++;
+      }
+
+    this->PendingLoads -= finished.size();
+    return uploaded;
+  }
+
+  bool TextureManager::DecodeTexture2D(const std::string& filePath, bool mipMap, bool flipVertically, MipmapGenerator::Filter filter,
+                                       Texture& texture, MipmapGenerator::MipChain& mips) const
   {
     int width, height, bpp;
-    auto data = this->LoadTextureImage(filePath, width, height, bpp, STBI_rgb_alpha);
+    auto data = this->LoadTextureImage(filePath, width, height, bpp, STBI_rgb_alpha, flipVertically);
 
+    texture.filePath = filePath;
     if (!data)
       {
       return false;
       }
 
-    GLuint tex;
-    glGenTextures(1, &tex);
-    glActiveTexture(GL_TEXTURE0 + unit); // Texture Unit
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-
     if (mipMap)
       {
-      glGenerateMipmap(GL_TEXTURE_2D);
+      mips = MipmapGenerator::Generate(data, width, height, filter);
       }
+    else
+      {
+      mips.emplace_back(data, data + static_cast<size_t>(width) * height * 4);
+      }
+    this->FreeTextureImage(data);
 
-    // Wrapping
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // Filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    Texture texture;
     texture.mipMap = mipMap;
     texture.width = width;
     texture.height = height;
-    texture.name = name;
-    texture.filePath = filePath;
-    texture.unit = unit;
+    texture.bpp = bpp;
     texture.type = Texture2D;
+    return true;
+  }
+
+  void TextureManager::AddTexture2D(Texture& texture, MipmapGenerator::MipChain& mips)
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    if (this->Streaming && texture.mipMap)
+      {
+      texture.streamed = true;
+      texture.mips = std::move(mips);
+
+      // Start with the coarse tail of the chain
+      int level = 0;
+      while (level + 1 < static_cast<int>(texture.mips.size())
+             && std::max(texture.width >> level, texture.height >> level) > this->StreamingBaseSize)
+        {
+        level++;
+        }
+      texture.requestedLevel = level;
+      texture.lastUsed = this->Frame;
+
+      this->UploadStreamedLevels(texture, level);
+      }
+    else
+      {
+      const int levels = static_cast<int>(mips.size());
+
+      GLuint tex;
+      glGenTextures(1, &tex);
+      glActiveTexture(GL_TEXTURE0 + texture.unit); // Texture Unit
+      glBindTexture(GL_TEXTURE_2D, tex);
+      glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, texture.width, texture.height);
+      for (int i = 0; i < levels; i++)
+        {
+        glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, std::max(1, texture.width >> i), std::max(1, texture.height >> i),
+                        GL_RGBA, GL_UNSIGNED_BYTE, mips[i].data());
+        }
+
+      // Wrapping
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+      // Filtering
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.mipMap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+      texture.id = tex;
+      texture.bytes = EstimateBytes(texture.width, texture.height, 1, texture.mipMap);
+      this->RegisterTexture(texture);
+      }
 
     this->Textures.push_back(texture);
+    this->UploadHandleBuffer();
+  }
 
-    this->FreeTextureImage(data);
+  bool TextureManager::LoadCubeMapRGBA(const std::string& name, const std::array<std::string, 6>& facePaths, GLuint unit, bool mipMap, bool flipVertically)
+  {
+    Texture texture;
+    std::vector<MipmapGenerator::MipChain> faces;
+    if (!this->DecodeCubeMap(facePaths, mipMap, flipVertically, this->MipFilter.load(), this->GetLoader(), texture, faces))
+      {
+      return false;
+      }
+
+    texture.name = name;
+    texture.unit = unit;
+    this->AddCubeMap(texture, faces);
 
     return true;
   }
 
-  bool TextureManager::LoadCubeMapRGBA(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap)
+  bool TextureManager::LoadCubeMapRGBA(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap, bool flipVertically)
+  {
+    Texture texture;
+    std::vector<MipmapGenerator::MipChain> faces;
+    if (!this->DecodeCubeMapLayout(filePath, mipMap, flipVertically, this->MipFilter.load(), this->GetLoader(), texture, faces))
+      {
+      return false;
+      }
+
+    texture.name = name;
+    texture.unit = unit;
+    this->AddCubeMap(texture, faces);
+
+    return true;
+  }
+
+  void TextureManager::LoadCubeMapRGBAAsync(const std::string& name, const std::array<std::string, 6>& facePaths, GLuint unit, bool mipMap, bool flipVertically)
+  {
+    this->PendingLoads++;
+    auto filter = this->MipFilter.load();
+    auto& loader = this->GetLoader();
+    loader.Submit([this, name, facePaths, unit, mipMap, flipVertically, filter, &loader]() {
+      PendingTexture pending;
+      pending.ok = this->DecodeCubeMap(facePaths, mipMap, flipVertically, filter, loader, pending.texture, pending.faces);
+      pending.texture.name = name;
+      pending.texture.unit = unit;
+      pending.texture.type = CubeMap;
+
+      std::lock_guard<std::mutex> lock(this->PendingMutex);
+      this->Finished.push_back(std::move(pending));
+    });
+  }
+
+  void TextureManager::LoadCubeMapRGBAAsync(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap, bool flipVertically)
+  {
+    this->PendingLoads++;
+    auto filter = this->MipFilter.load();
+    auto& loader = this->GetLoader();
+    loader.Submit([this, name, filePath, unit, mipMap, flipVertically, filter, &loader]() {
+      PendingTexture pending;
+      pending.ok = this->DecodeCubeMapLayout(filePath, mipMap, flipVertically, filter, loader, pending.texture, pending.faces);
+      pending.texture.name = name;
+      pending.texture.unit = unit;
+      pending.texture.type = CubeMap;
+
+      std::lock_guard<std::mutex> lock(this->PendingMutex);
+      this->Finished.push_back(std::move(pending));
+    });
+  }
+
+  bool TextureManager::DecodeCubeMap(const std::array<std::string, 6>& facePaths, bool mipMap, bool flipVertically, MipmapGenerator::Filter filter,
+                                     ThreadPool& pool, Texture& texture, std::vector<MipmapGenerator::MipChain>& faces) const
+  {
+    // Decode and filter the six faces in parallel
+    std::array<Texture, 6> decoded;
+    std::array<bool, 6> ok;
+    faces.resize(6);
+    pool.ParallelFor(0, 6, 1, [&](size_t first, size_t last) {
+      for (size_t i = first; i < last; i++)
+        {
+        ok[i] = this->DecodeTexture2D(facePaths[i], mipMap, flipVertically, filter, decoded[i], faces[i]);
+        }
+    });
+
+    texture.filePath = facePaths[0];
+    for (int i = 0; i < 6; i++)
+      {
+      if (!ok[i])
+        {
+        std::cout << "Failed to load cube map face " << facePaths[i] << "\n";
+        return false;
+        }
+      if (decoded[i].width != decoded[i].height || decoded[i].width != decoded[0].width)
+        {
+        std::cout << "Cube map faces must be square and of equal size: " << facePaths[i] << " is "
+                  << decoded[i].width << "x" << decoded[i].height << "\n";
+        return false;
+        }
+      }
+
+    texture.mipMap = mipMap;
+    texture.width = decoded[0].width;
+    texture.height = decoded[0].height;
+    texture.bpp = decoded[0].bpp;
+    texture.type = CubeMap;
+    return true;
+  }
+
+  bool TextureManager::DecodeCubeMapLayout(const std::string& filePath, bool mipMap, bool flipVertically, MipmapGenerator::Filter filter,
+                                           ThreadPool& pool, Texture& texture, std::vector<MipmapGenerator::MipChain>& faces) const
   {
     int width, height, bpp;
-    auto data = this->LoadTextureImage(filePath, width, height, bpp, STBI_rgb_alpha);
+    auto data = this->LoadTextureImage(filePath, width, height, bpp, STBI_rgb_alpha, flipVertically);
 
+    texture.filePath = filePath;
     if (!data)
       {
       return false;
       }
 
-    /*Generate a texture object and upload the loaded image to it.*/
+    // Face positions (column, row from the top of the file) in +X, -X, +Y, -Y, +Z, -Z order.
+    // The vertical cross stores -Z upside down, below -Y.
+    //   Horizontal cross     Vertical cross     Strips
+    //       +Y                   +Y             +X -X +Y -Y +Z -Z   (or top to bottom)
+    //    -X +Z +X -Z          -X +Z +X
+    //       -Y                   -Y
+    //                            -Z
+    static const int horizontalCross[6][2] = {{2, 1}, {0, 1}, {1, 0}, {1, 2}, {1, 1}, {3, 1}};
+    static const int verticalCross[6][2] = {{2, 1}, {0, 1}, {1, 0}, {1, 2}, {1, 1}, {1, 3}};
+
+    int columns, rows;
+    const int (*layout)[2] = nullptr;
+    bool rotateNegativeZ = false;
+    if (width * 3 == height * 4)      { columns = 4; rows = 3; layout = horizontalCross; }
+    else if (width * 4 == height * 3) { columns = 3; rows = 4; layout = verticalCross; rotateNegativeZ = true; }
+    else if (width == height * 6)     { columns = 6; rows = 1; }
+    else if (width * 6 == height)     { columns = 1; rows = 6; }
+    else if (width == height)         { columns = 1; rows = 1; } // Same image on every face
+    else
+      {
+      std::cout << "Unrecognized cube map layout (" << width << "x" << height << "): " << filePath << "\n";
+      this->FreeTextureImage(data);
+      return false;
+      }
+
+    const int size = width / columns;
+    std::array<std::vector<unsigned char>, 6> images;
+    for (int face = 0; face < 6; face++)
+      {
+      int column = 0, row = 0;
+      if (layout)                 { column = layout[face][0]; row = layout[face][1]; }
+      else if (columns == 6)      { column = face; }
+      else if (rows == 6)         { row = face; }
+
+      // In a flipped image the rows are counted from the bottom
+      if (flipVertically)
+        {
+        row = rows - 1 - row;
+        }
+
+      auto& image = images[face];
+      image.resize(static_cast<size_t>(size) * size * 4);
+      for (int y = 0; y < size; y++)
+        {
+        const unsigned char* src = data + ((static_cast<size_t>(row) * size + y) * width + column * size) * 4;
+        std::copy(src, src + size * 4, image.begin() + static_cast<size_t>(y) * size * 4);
+        }
+
+      if (rotateNegativeZ && face == 5)
+        {
+        // Rotating 180 degrees reverses the texel order
+        auto* texels = reinterpret_cast<uint32_t*>(image.data());
+        std::reverse(texels, texels + static_cast<size_t>(size) * size);
+        }
+      }
+    this->FreeTextureImage(data);
+
+    faces.resize(6);
+    pool.ParallelFor(0, 6, 1, [&](size_t first, size_t last) {
+      for (size_t i = first; i < last; i++)
+        {
+        if (mipMap)
+          {
+          faces[i] = MipmapGenerator::Generate(images[i].data(), size, size, filter);
+          }
+        else
+          {
+          faces[i].assign(1, std::move(images[i]));
+          }
+        }
+    });
+
+    texture.mipMap = mipMap;
+    texture.width = size;
+    texture.height = size;
+    texture.bpp = bpp;
+    texture.type = CubeMap;
+    return true;
+  }
+
+  void TextureManager::AddCubeMap(Texture& texture, std::vector<MipmapGenerator::MipChain>& faces)
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    const int levels = static_cast<int>(faces[0].size());
+
     GLuint tex;
     glGenTextures(1, &tex);
-    glActiveTexture(GL_TEXTURE0 + unit); // Texture Unit
+    glActiveTexture(GL_TEXTURE0 + texture.unit); // Texture Unit
     glBindTexture(GL_TEXTURE_CUBE_MAP, tex);
-
-    for (unsigned int i = 0; i < 6; i++) {
-      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    }
-
-    if (mipMap)
+    glTexStorage2D(GL_TEXTURE_CUBE_MAP, levels, GL_RGBA8, texture.width, texture.height);
+    for (unsigned int face = 0; face < 6; face++)
       {
-      glGenerateMipmap(GL_TEXTURE_2D);
+      for (int i = 0; i < levels; i++)
+        {
+        glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, i, 0, 0,
+                        std::max(1, texture.width >> i), std::max(1, texture.height >> i),
+                        GL_RGBA, GL_UNSIGNED_BYTE, faces[face][i].data());
+        }
       }
 
     // Wrapping
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
     // Filtering
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, texture.mipMap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    Texture texture;
-    texture.mipMap = mipMap;
-    texture.width = width;
-    texture.height = height;
-    texture.name = name;
-    texture.filePath = filePath;
-    texture.unit = unit;
-    texture.type = CubeMap;
+    texture.id = tex;
+    texture.bytes = EstimateBytes(texture.width, texture.height, 6, texture.mipMap);
 
+    this->RegisterTexture(texture);
     this->Textures.push_back(texture);
-    this->FreeTextureImage(data);
+    this->UploadHandleBuffer();
+  }
 
-    return true;
+  ThreadPool& TextureManager::GetLoader()
+  {
+    std::call_once(this->LoaderOnce, [this]() { this->Loader = std::make_unique<ThreadPool>(); });
+    return *this->Loader;
+  }
+
+
+  TextureManager* TextureManager::GetInstance()
+  {
+    // Double-checked locking: only the first calls pay for the mutex
+    auto instance = TextureManager::Instance.load(std::memory_order_acquire);
+    if (!instance)
+      {
+      std::lock_guard<std::mutex> lock(TextureManager::InstanceMutex);
+      instance = TextureManager::Instance.load(std::memory_order_relaxed);
+      if (!instance)
+        {
+        instance = new TextureManager();
+        TextureManager::Instance.store(instance, std::memory_order_release);
+        }
+      }
+    return instance;
+  }
+
+  void TextureManager::DestroyInstance()
+  {
+    std::lock_guard<std::mutex> lock(TextureManager::InstanceMutex);
+    delete TextureManager::Instance.exchange(nullptr);
+  }
+
+  TextureManager::~TextureManager()
+  {
+    // Let running loads finish before the containers they write to are gone
+    this->Loader.reset();
+
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+
+    for (auto& texture : this->Textures)
+      {
+      this->SetResident(texture, false);
+      glDeleteTextures(1, &texture.id);
+      }
+
+    if (this->HandleBuffer)
+      {
+      glDeleteBuffers(1, &this->HandleBuffer);
+      }
   }
 
 
   GLuint TextureManager::GetUnitByName(const std::string& name) const
   {
+  std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
   for(const auto& texture: this->Textures)
     {
     if (!texture.name.compare(name))
@@ -109,10 +486,318 @@ namespace Framework {
   return -1;
   }
 
-  unsigned char* TextureManager::LoadTextureImage(const std::string& filepath, int& width, int& height, int& bpp, int format) const
+  bool TextureManager::EnableBindless(GLsizeiptr residentBudget)
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    if (!HasExtension("GL_ARB_bindless_texture"))
+      {
+      std::cout << "GL_ARB_bindless_texture not supported, using texture units.\n";
+      return false;
+      }
+
+    glGetTextureHandleARB = reinterpret_cast<PFNGLGETTEXTUREHANDLEARBPROC>(glfwGetProcAddress("glGetTextureHandleARB"));
+    glMakeTextureHandleResidentARB = reinterpret_cast<PFNGLMAKETEXTUREHANDLERESIDENTARBPROC>(glfwGetProcAddress("glMakeTextureHandleResidentARB"));
+    glMakeTextureHandleNonResidentARB = reinterpret_cast<PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC>(glfwGetProcAddress("glMakeTextureHandleNonResidentARB"));
+    if (!glGetTextureHandleARB || !glMakeTextureHandleResidentARB || !glMakeTextureHandleNonResidentARB)
+      {
+      return false;
+      }
+
+    this->Bindless = true;
+    this->ResidentBudget = residentBudget;
+    glGenBuffers(1, &this->HandleBuffer);
+
+    // Textures loaded before bindless was enabled get their handles now
+    for (auto& texture : this->Textures)
+      {
+      this->RegisterTexture(texture);
+      }
+    this->UploadHandleBuffer();
+
+    return true;
+  }
+
+  GLint TextureManager::GetIndexByName(const std::string& name) const
   {
-    stbi_set_flip_vertically_on_load(1); //flipper texture. fjern om den ødelegger noe. må brukes for orthographic camera
-    return stbi_load(filepath.c_str(), &width, &height, &bpp, format);
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    for (size_t i = 0; i < this->Textures.size(); i++)
+      {
+      if (!this->Textures[i].name.compare(name))
+        {
+        return static_cast<GLint>(i);
+        }
+      }
+    return -1;
+  }
+
+  bool TextureManager::MakeResident(const std::string& name, bool resident)
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    auto index = this->GetIndexByName(name);
+    if (index < 0 || !this->Bindless)
+      {
+      return false;
+      }
+
+    if (!this->SetResident(this->Textures[index], resident))
+      {
+      return false;
+      }
+    this->UploadHandleBuffer();
+    return true;
+  }
+
+  void TextureManager::BindHandleBuffer(GLuint binding) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    if (this->Bindless)
+      {
+      glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, this->HandleBuffer);
+      }
+  }
+
+  void TextureManager::RegisterTexture(Texture& texture)
+  {
+    texture.handle = 0;
+    texture.resident = false;
+
+    if (!this->Bindless)
+      {
+      return;
+      }
+
+    // Handles are immutable once created, so all sampling state has to be set by now
+    texture.handle = glGetTextureHandleARB(texture.id);
+    this->SetResident(texture, true);
+  }
+
+  bool TextureManager::SetResident(Texture& texture, bool resident)
+  {
+    if (texture.handle == 0 || texture.resident == resident)
+      {
+      return texture.resident == resident;
+      }
+
+    if (resident)
+      {
+      if (this->ResidentBytes + texture.bytes > this->ResidentBudget)
+        {
+        return false;
+        }
+      glMakeTextureHandleResidentARB(texture.handle);
+      this->ResidentBytes += texture.bytes;
+      }
+    else
+      {
+      glMakeTextureHandleNonResidentARB(texture.handle);
+      this->ResidentBytes -= texture.bytes;
+      }
+
+    texture.resident = resident;
+    return true;
+  }
+
+  void TextureManager::UploadHandleBuffer()
+  {
+    if (!this->Bindless)
+      {
+      return;
+      }
+
+    // Non-resident textures are written as 0 so stale handles are never sampled
+    std::vector<GLuint64> handles;
+    handles.reserve(this->Textures.size());
+    for (const auto& texture : this->Textures)
+      {
+      handles.push_back(texture.resident ? texture.handle : 0);
+      }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->HandleBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, handles.size() * sizeof(GLuint64), handles.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  }
+
+  void TextureManager::EnableStreaming(GLsizeiptr budget, int baseSize)
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    this->Streaming = true;
+    this->StreamingBaseSize = std::max(1, baseSize);
+    this->Stats.budget = budget;
+  }
+
+  void TextureManager::RequestTextureSize(const std::string& name, float screenPixels)
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    auto index = this->GetIndexByName(name);
+    if (index < 0 || !this->Textures[index].streamed)
+      {
+      return;
+      }
+
+    auto& texture = this->Textures[index];
+    int coarsest = static_cast<int>(texture.mips.size()) - 1;
+    int level = coarsest;
+    if (screenPixels >= 1.0f)
+      {
+      // Finest level whose size does not exceed the size on screen
+      float ratio = static_cast<float>(std::max(texture.width, texture.height)) / screenPixels;
+      level = std::clamp(static_cast<int>(std::floor(std::log2(std::max(ratio, 1.0f)))), 0, coarsest);
+      }
+
+    // Several requests in the same frame keep the finest one
+    texture.requestedLevel = texture.lastUsed == this->Frame ? std::min(texture.requestedLevel, level) : level;
+    texture.lastUsed = this->Frame;
+  }
+
+  void TextureManager::UpdateStreaming()
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex);
+    bool changed = false;
+
+    for (auto& texture : this->Textures)
+      {
+      if (!texture.streamed || texture.requestedLevel >= texture.residentLevel)
+        {
+        continue;
+        }
+
+      GLsizeiptr needed = this->StreamedBytes(texture, texture.requestedLevel) - texture.bytes;
+      if (this->Stats.residentBytes + needed > this->Stats.budget
+          && !this->EvictLeastRecentlyUsed(needed, &texture))
+        {
+        continue; // Cannot make room this frame
+        }
+
+      this->UploadStreamedLevels(texture, texture.requestedLevel);
+      changed = true;
+      }
+
+    if (changed)
+      {
+      this->UploadHandleBuffer();
+      }
+    this->Frame++;
+  }
+
+  bool TextureManager::UploadStreamedLevels(Texture& texture, int level)
+  {
+    const int levels = static_cast<int>(texture.mips.size()) - level;
+    const int width = std::max(1, texture.width >> level);
+    const int height = std::max(1, texture.height >> level);
+
+    // Reallocate with immutable storage for exactly the resident levels, so evicted levels
+    // actually give their memory back
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glActiveTexture(GL_TEXTURE0 + texture.unit); // Texture Unit
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, width, height);
+    for (int i = 0; i < levels; i++)
+      {
+      glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, std::max(1, width >> i), std::max(1, height >> i),
+                      GL_RGBA, GL_UNSIGNED_BYTE, texture.mips[level + i].data());
+      }
+
+    // Wrapping
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    // Filtering
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Stats
+    if (!texture.id)
+      {
+      this->Stats.uploads += levels;
+      }
+    else if (level < texture.residentLevel)
+      {
+      this->Stats.uploads += texture.residentLevel - level;
+      }
+    else
+      {
+      this->Stats.evictions += level - texture.residentLevel;
+      }
+
+    // Release the previous allocation
+    if (texture.id)
+      {
+      this->SetResident(texture, false);
+      glDeleteTextures(1, &texture.id);
+      }
+
+    GLsizeiptr bytes = this->StreamedBytes(texture, level);
+    this->Stats.residentBytes += bytes - texture.bytes;
+
+    texture.id = tex;
+    texture.bytes = bytes;
+    texture.residentLevel = level;
+    this->RegisterTexture(texture);
+
+    return true;
+  }
+
+  GLsizeiptr TextureManager::StreamedBytes(const Texture& texture, int level) const
+  {
+    GLsizeiptr bytes = 0;
+    for (size_t i = level; i < texture.mips.size(); i++)
+      {
+      bytes += texture.mips[i].size();
+      }
+    return bytes;
+  }
+
+  bool TextureManager::EvictLeastRecentlyUsed(GLsizeiptr bytesNeeded, const Texture* keep)
+  {
+    while (this->Stats.residentBytes + bytesNeeded > this->Stats.budget)
+      {
+      // Textures requested this frame are never evicted, to avoid uploading and evicting
+      // the same levels back and forth
+      Texture* victim = nullptr;
+      for (auto& texture : this->Textures)
+        {
+        if (!texture.streamed || &texture == keep || texture.lastUsed == this->Frame
+            || texture.residentLevel + 1 >= static_cast<int>(texture.mips.size()))
+          {
+          continue;
+          }
+        if (!victim || texture.lastUsed < victim->lastUsed)
+          {
+          victim = &texture;
+          }
+        }
+
+      if (!victim)
+        {
+        return false;
+        }
+
+      // Drop the finest resident level; it is streamed back in once it is requested again
+      this->UploadStreamedLevels(*victim, victim->residentLevel + 1);
+      victim->requestedLevel = victim->residentLevel;
+      }
+
+    return true;
+  }
+
+  unsigned char* TextureManager::LoadTextureImage(const std::string& filepath, int& width, int& height, int& bpp, int format, bool flipVertically) const
+  {
+    // stbi_set_flip_vertically_on_load() is process-wide state shared by all loader threads,
+    // so the rows are flipped here instead
+    auto data = stbi_load(filepath.c_str(), &width, &height, &bpp, format);
+
+    if (data && flipVertically)
+      {
+      const size_t stride = static_cast<size_t>(width) * (format ? format : bpp);
+      for (int y = 0; y < height / 2; y++)
+        {
+        auto top = data + y * stride;
+        auto bottom = data + (height - 1 - y) * stride;
+        std::swap_ranges(top, top + stride, bottom);
+        }
+      }
+
+    return data;
   }
 
 
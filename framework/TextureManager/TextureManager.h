@@ -7,7 +7,15 @@
 #include <glad/glad.h>
 #include <stb_image.h>
 
+// Framework
+#include "MipmapGenerator.h"
+#include "ThreadPool.h"
+
 // STD includes
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -27,21 +35,129 @@ namespace Framework {
       std::string filePath;
       GLuint unit;
       TextureManager::TextureType type;
+      GLuint id = 0;          // OpenGL texture object
+      GLuint64 handle = 0;    // Bindless handle (0 if bindless is not enabled)
+      bool resident = false;  // Whether the bindless handle is currently resident
+      GLsizeiptr bytes = 0;   // Estimated video memory footprint
+
+      // Streaming (only used for textures loaded while streaming is enabled)
+      bool streamed = false;
+      std::vector<std::vector<unsigned char>> mips; // Decoded RGBA8 mip chain kept in system memory
+      int residentLevel = 0;      // Finest mip level currently uploaded
+      int requestedLevel = 0;     // Finest mip level needed for the requested screen size
+      unsigned long lastUsed = 0; // Frame of the last request (for LRU eviction)
+    };
+
+    struct StreamingStats
+    {
+      GLsizeiptr residentBytes; // Video memory used by streamed textures
+      GLsizeiptr budget;
+      unsigned long uploads;    // Number of mip levels uploaded
+      unsigned long evictions;  // Number of mip levels evicted
     };
 
   public:
-    static TextureManager* GetInstance()
-    {return TextureManager::Instance != nullptr?TextureManager::Instance: TextureManager::Instance = new TextureManager(); }
+    // Thread-safe; the instance is created on first use.
+    static TextureManager* GetInstance();
+    // Delete all textures. Must be called while the OpenGL context is still alive.
+    static void DestroyInstance();
 
   public:
-    bool LoadTexture2DRGBA(const std::string& name, const std::string& filepath, GLuint unit, bool mipMap=true);
-    bool LoadCubeMapRGBA(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap=true);
+    // Images are flipped vertically by default, so their first row ends up at t = 0 as OpenGL
+    // expects. The flip is done per load; stb's global flip setting is never touched.
+    bool LoadTexture2DRGBA(const std::string& name, const std::string& filepath, GLuint unit, bool mipMap=true, bool flipVertically=true);
+    // Cube map from six square images of equal size, in +X, -X, +Y, -Y, +Z, -Z order.
+    bool LoadCubeMapRGBA(const std::string& name, const std::array<std::string, 6>& facePaths, GLuint unit, bool mipMap=true, bool flipVertically=true);
+    // Cube map from a single image laid out as a horizontal (4:3) or vertical (3:4) cross, or
+    // as a horizontal (6:1) or vertical (1:6) strip. A square image is used for all six faces.
+    bool LoadCubeMapRGBA(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap=true, bool flipVertically=true);
     GLuint GetUnitByName(const std::string& name) const;
 
+    // Asynchronous loading.
+    //
+    // The image is decoded and its mip chain built on a loader thread; any thread may queue
+    // loads. Finished textures are uploaded (complete mip chain at once) by ProcessPendingLoads(),
+    // which must be called on the thread owning the OpenGL context, e.g. once per frame. Returns
+    // the number uploaded.
+    void LoadTexture2DRGBAAsync(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap=true, bool flipVertically=true);
+    void LoadCubeMapRGBAAsync(const std::string& name, const std::array<std::string, 6>& facePaths, GLuint unit, bool mipMap=true, bool flipVertically=true);
+    void LoadCubeMapRGBAAsync(const std::string& name, const std::string& filePath, GLuint unit, bool mipMap=true, bool flipVertically=true);
+    size_t ProcessPendingLoads();
+    size_t GetPendingLoadCount() const { return this->PendingLoads.load(); }
+    // Loads decoded and waiting for ProcessPendingLoads()
+    size_t GetFinishedLoadCount() const { std::lock_guard<std::mutex> lock(this->PendingMutex); return this->Finished.size(); }
+
+    // Filter used when building mip chains (box by default)
+    void SetMipmapFilter(MipmapGenerator::Filter filter) { this->MipFilter = filter; }
+
+    // Bindless textures (ARB_bindless_texture).
+    //
+    // When enabled, every texture gets a 64-bit handle which is made resident as long as
+    // the total footprint of resident textures stays within 'residentBudget' bytes. The
+    // handles are stored in a shader storage buffer, in load order, so a shader can pick
+    // its texture by index instead of by texture unit:
+    //
+    //   #extension GL_ARB_bindless_texture : require
+    //   layout(std430, binding = 0) readonly buffer TextureHandles { uvec2 u_Handles[]; };
+    //   uniform uint u_TextureIndex;
+    //   ... texture(sampler2D(u_Handles[u_TextureIndex]), uv) ...
+    //
+    // Returns false (and keeps classic unit binding) if the extension is not supported.
+    bool EnableBindless(GLsizeiptr residentBudget);
+    bool IsBindless() const { std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex); return this->Bindless; }
+
+    // Index of the texture's handle in the handle buffer (-1 if not found).
+    GLint GetIndexByName(const std::string& name) const;
+    // Make a texture handle resident/non-resident. Fails if the budget would be exceeded.
+    bool MakeResident(const std::string& name, bool resident=true);
+    // Bind the handle buffer to a shader storage buffer binding point.
+    void BindHandleBuffer(GLuint binding) const;
+    GLsizeiptr GetResidentBytes() const { std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex); return this->ResidentBytes; }
+
+    // Texture streaming.
+    //
+    // 2D textures loaded with mipmaps while streaming is enabled start out with only the
+    // mip levels no larger than 'baseSize' in video memory. RequestTextureSize() tells the
+    // manager how large a texture appears on screen, and UpdateStreaming() (once per frame)
+    // uploads the finer levels that are needed. When the streamed textures exceed 'budget'
+    // bytes, the finest levels of the least recently requested textures are evicted.
+    // Note that a streamed texture is reallocated when its residency changes, so its texture
+    // object (and bindless handle) may change between frames.
+    void EnableStreaming(GLsizeiptr budget, int baseSize=64);
+    void RequestTextureSize(const std::string& name, float screenPixels);
+    void UpdateStreaming();
+    StreamingStats GetStreamingStats() const { std::lock_guard<std::recursive_mutex> lock(this->TexturesMutex); return this->Stats; }
+
   private:
-    unsigned char* LoadTextureImage(const std::string& filepath, int& width, int& height, int& bpp, int format)const;
+    struct PendingTexture
+    {
+      bool ok;
+      Texture texture;
+      std::vector<MipmapGenerator::MipChain> faces; // One mip chain per face
+    };
+
+  private:
+    bool DecodeTexture2D(const std::string& filePath, bool mipMap, bool flipVertically, MipmapGenerator::Filter filter,
+                         Texture& texture, MipmapGenerator::MipChain& mips) const;
+    void AddTexture2D(Texture& texture, MipmapGenerator::MipChain& mips);
+    bool DecodeCubeMap(const std::array<std::string, 6>& facePaths, bool mipMap, bool flipVertically, MipmapGenerator::Filter filter,
+                       ThreadPool& pool, Texture& texture, std::vector<MipmapGenerator::MipChain>& faces) const;
+    bool DecodeCubeMapLayout(const std::string& filePath, bool mipMap, bool flipVertically, MipmapGenerator::Filter filter,
+                             ThreadPool& pool, Texture& texture, std::vector<MipmapGenerator::MipChain>& faces) const;
+    void AddCubeMap(Texture& texture, std::vector<MipmapGenerator::MipChain>& faces);
+    ThreadPool& GetLoader();
+
+    unsigned char* LoadTextureImage(const std::string& filepath, int& width, int& height, int& bpp, int format, bool flipVertically)const;
     void FreeTextureImage(unsigned char* data) const;
 
+    void RegisterTexture(Texture& texture);
+    bool SetResident(Texture& texture, bool resident);
+    void UploadHandleBuffer();
+
+    bool UploadStreamedLevels(Texture& texture, int level);
+    GLsizeiptr StreamedBytes(const Texture& texture, int level) const;
+    bool EvictLeastRecentlyUsed(GLsizeiptr bytesNeeded, const Texture* keep);
+
   private:
     TextureManager(){};
     ~TextureManager();
@@ -49,10 +165,34 @@ namespace Framework {
     void operator=(const TextureManager&) = delete;
 
   private:
-    inline static TextureManager* Instance = nullptr;
+    inline static std::atomic<TextureManager*> Instance{nullptr};
+    inline static std::mutex InstanceMutex;
 
   private:
+    // Guards the texture list and the bindless/streaming state below. Recursive, since public
+    // functions call each other.
+    mutable std::recursive_mutex TexturesMutex;
     std::vector<TextureManager::Texture> Textures;
+
+    // Bindless
+    bool Bindless = false;
+    GLuint HandleBuffer = 0;
+    GLsizeiptr ResidentBudget = 0;
+    GLsizeiptr ResidentBytes = 0;
+
+    // Streaming
+    bool Streaming = false;
+    int StreamingBaseSize = 64;
+    unsigned long Frame = 0;
+    StreamingStats Stats = {0, 0, 0, 0};
+
+    // Asynchronous loading
+    std::atomic<MipmapGenerator::Filter> MipFilter{MipmapGenerator::Filter::Box};
+    mutable std::mutex PendingMutex;
+    std::vector<PendingTexture> Finished;
+    std::atomic<size_t> PendingLoads{0};
+    std::once_flag LoaderOnce;
+    std::unique_ptr<ThreadPool> Loader;
   };
 };
 
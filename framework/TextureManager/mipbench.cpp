@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "MipmapGenerator.h"
+
+// Mip chain check and benchmark: the SIMD Generate() must match the scalar reference byte for
+// byte at every level, for odd and even sizes, both filters and both color spaces. Then both are
+// timed on a large image.
+//
+//   mipbench [size] [runs]
+
+using namespace Framework;
+
+namespace {
+    struct Size {
+        int Width, Height;
+    };
+
+    const Size CheckSizes[] = {
+        {1, 1}, {2, 1}, {1, 7}, {3, 5}, {4, 4}, {17, 33}, {64, 64}, {100, 37}, {255, 256}, {513, 300},
+    };
+
+    const MipmapGenerator::Filter Filters[] = {MipmapGenerator::Filter::Box, MipmapGenerator::Filter::Kaiser};
+    const MipmapGenerator::ColorSpace ColorSpaces[] = {MipmapGenerator::ColorSpace::Linear, MipmapGenerator::ColorSpace::sRGB};
+
+    const char* Name(MipmapGenerator::Filter filter) { return filter == MipmapGenerator::Filter::Box ? "box" : "kaiser"; }
+    const char* Name(MipmapGenerator::ColorSpace space) { return space == MipmapGenerator::ColorSpace::sRGB ? "srgb" : "linear"; }
+
+    // Noise with some smooth areas, the same on every run
+    std::vector<unsigned char> MakeImage(int width, int height) {
+        std::vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+        uint32_t state = 0x12345678u ^ static_cast<uint32_t>(width * 7919 + height);
+        for (size_t i = 0; i < rgba.size(); i++) {
+            state = state * 1664525u + 1013904223u;
+            const size_t texel = i / 4;
+            const bool smooth = (texel / width / 8 + texel % width / 8) % 2 == 0;
+            rgba[i] = smooth ? static_cast<unsigned char>((texel % width) * 255 / width) : static_cast<unsigned char>(state >> 24);
+        }
+        return rgba;
+    }
+
+    double Seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    const int size = argc > 1 ? atoi(argv[1]) : 2048;
+    const int runs = argc > 2 ? atoi(argv[2]) : 5;
+    if (size < 1 || runs < 1) {
+        printf("usage: mipbench [size] [runs]\n");
+        return 1;
+    }
+
+    // Check
+    int mismatches = 0, checks = 0;
+    for (const Size& s : CheckSizes) {
+        const std::vector<unsigned char> image = MakeImage(s.Width, s.Height);
+        for (MipmapGenerator::Filter filter : Filters) {
+            for (MipmapGenerator::ColorSpace space : ColorSpaces) {
+                const MipmapGenerator::MipChain simd = MipmapGenerator::Generate(image.data(), s.Width, s.Height, filter, space);
+                const MipmapGenerator::MipChain reference = MipmapGenerator::GenerateReference(image.data(), s.Width, s.Height, filter, space);
+                checks++;
+
+                bool same = simd.size() == reference.size();
+                for (size_t level = 0; same && level < simd.size(); level++) same = simd[level] == reference[level];
+                if (!same) {
+                    printf("mismatch: %dx%d %s %s\n", s.Width, s.Height, Name(filter), Name(space));
+                    mismatches++;
+                }
+            }
+        }
+    }
+    printf("%d of %d chains match the reference\n\n", checks - mismatches, checks);
+
+    // Benchmark: input megabytes per second
+    const std::vector<unsigned char> image = MakeImage(size, size);
+    const double megabytes = static_cast<double>(image.size()) / (1024.0 * 1024.0);
+    printf("%dx%d, best of %d runs\n", size, size, runs);
+    printf("filter  space       simd (MB/s)  reference (MB/s)  speedup\n");
+    for (MipmapGenerator::Filter filter : Filters) {
+        for (MipmapGenerator::ColorSpace space : ColorSpaces) {
+            double simdBest = 1e30, referenceBest = 1e30;
+            for (int run = 0; run < runs; run++) {
+                auto start = std::chrono::steady_clock::now();
+                MipmapGenerator::Generate(image.data(), size, size, filter, space);
+                simdBest = std::min(simdBest, Seconds(start));
+
+                start = std::chrono::steady_clock::now();
+                MipmapGenerator::GenerateReference(image.data(), size, size, filter, space);
+                referenceBest = std::min(referenceBest, Seconds(start));
+            }
+            printf("%-7s %-7s %15.1f %17.1f %8.2f\n", Name(filter), Name(space), megabytes / simdBest,
+                   megabytes / referenceBest, referenceBest / simdBest);
+        }
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TextureManager.h"
+
+// The texture manager only declares stb_image; the program provides it
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+// Stress test of asynchronous texture loading, meant to run under ThreadSanitizer: several
+// threads race to create the instance, then queue decodes (flipped and not, changing the mip
+// filter in between) while others keep calling GetInstance() and the read-only queries. No
+// OpenGL context is needed, since nothing is uploaded.
+//
+//   texturestress [threads] [loads per thread]
+
+using namespace Framework;
+
+namespace {
+    // A few small PNGs of different sizes, written next to the executable
+    std::vector<std::string> WriteImages() {
+        const int sizes[][2] = {{1, 1}, {7, 3}, {64, 64}, {100, 60}};
+        std::vector<std::string> paths;
+        for (const auto& size : sizes) {
+            const int width = size[0], height = size[1];
+            std::vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+            for (size_t i = 0; i < rgba.size(); i++) rgba[i] = static_cast<unsigned char>(i * 37 + width);
+
+            const std::string path = "texturestress_" + std::to_string(width) + "x" + std::to_string(height) + ".png";
+            if (!stbi_write_png(path.c_str(), width, height, 4, rgba.data(), width * 4)) return {};
+            paths.push_back(path);
+        }
+        return paths;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int threads = argc > 1 ? atoi(argv[1]) : 8;
+    const int loadsPerThread = argc > 2 ? atoi(argv[2]) : 64;
+    if (threads < 1 || loadsPerThread < 1) {
+        printf("usage: texturestress [threads] [loads per thread]\n");
+        return 1;
+    }
+
+    const std::vector<std::string> paths = WriteImages();
+    if (paths.empty()) {
+        printf("could not write the test images\n");
+        return 1;
+    }
+
+    std::atomic<bool> go{false};
+    std::atomic<int> loaders{threads};
+    std::vector<std::thread> workers;
+
+    // Loaders: the first GetInstance() calls race each other
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            while (!go.load()) std::this_thread::yield();
+            for (int i = 0; i < loadsPerThread; i++) {
+                TextureManager* manager = TextureManager::GetInstance();
+                const std::string& path = paths[(t + i) % paths.size()];
+                const std::string name = "t" + std::to_string(t) + "_" + std::to_string(i);
+                if (i % 16 == 0) manager->SetMipmapFilter(i % 32 ? MipmapGenerator::Filter::Kaiser : MipmapGenerator::Filter::Box);
+                manager->LoadTexture2DRGBAAsync(name, path, 0, i % 3 != 0, i % 2 == 0);
+            }
+            loaders--;
+        });
+    }
+
+    // Readers, until every load is queued
+    for (int t = 0; t < 2; t++) {
+        workers.emplace_back([&]() {
+            while (!go.load()) std::this_thread::yield();
+            while (loaders.load() > 0) {
+                TextureManager* manager = TextureManager::GetInstance();
+                manager->GetPendingLoadCount();
+                manager->GetFinishedLoadCount();
+                manager->GetUnitByName("t0_0");
+            }
+        });
+    }
+
+    go = true;
+    for (std::thread& worker : workers) worker.join();
+
+    // Every queued load must show up as decoded
+    const size_t expected = static_cast<size_t>(threads) * loadsPerThread;
+    TextureManager* manager = TextureManager::GetInstance();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(120);
+    while (manager->GetFinishedLoadCount() < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const size_t finished = manager->GetFinishedLoadCount();
+    const size_t pending = manager->GetPendingLoadCount();
+    printf("%d threads, %zu loads: %zu decoded, %zu pending\n", threads, expected, finished, pending);
+
+    TextureManager::DestroyInstance();
+    for (const std::string& path : paths) std::remove(path.c_str());
+
+    return finished == expected && pending == expected ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#include "ThreadPool.h"
+
+namespace Framework {
+
+    ThreadPool::ThreadPool(unsigned int threads) {
+        threads = std::max(threads, 1u); // hardware_concurrency() may return 0
+
+        for (unsigned int i = 0; i < threads; i++) {
+            Workers.emplace_back(&ThreadPool::Worker, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Stopping = true;
+        }
+        Condition.notify_all();
+
+        for (auto &worker : Workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool& ThreadPool::GetShared() {
+        static ThreadPool pool; // Thread-safe initialization
+        return pool;
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Tasks.push(std::move(task));
+        }
+        Condition.notify_one();
+    }
+
+    void ThreadPool::Worker() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(Mutex);
+                Condition.wait(lock, [this]() { return Stopping || !Tasks.empty(); });
+
+                // Only stop once the queue is drained
+                if (Tasks.empty()) return;
+
+                task = std::move(Tasks.front());
+                Tasks.pop();
+            }
+            task();
+        }
+    }
+};
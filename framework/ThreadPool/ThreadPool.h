@@ -0,0 +1,111 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Framework {
+
+  class ThreadPool {
+  public:
+    // Constructor: starts 'threads' worker threads (at least one).
+    explicit ThreadPool(unsigned int threads = std::thread::hardware_concurrency());
+    // Destructor: finishes all queued tasks, then joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    void operator=(const ThreadPool&) = delete;
+
+    // Pool shared by the framework's parallel algorithms.
+    static ThreadPool& GetShared();
+
+    inline unsigned int GetThreadCount() const { return static_cast<unsigned int>(Workers.size()); }
+
+    // Queue a task. The returned future holds its result (or exception).
+    template <typename F>
+    auto Submit(F&& task) -> std::future<decltype(task())>;
+
+    // Split [begin, end) into chunks of 'grain' elements and call fn(chunkBegin, chunkEnd)
+    // for each chunk in parallel. The calling thread works on chunks as well, so this may
+    // safely be called from inside a pool task. Blocks until all chunks are done.
+    template <typename F>
+    void ParallelFor(size_t begin, size_t end, size_t grain, F&& fn);
+
+  private:
+    void Enqueue(std::function<void()> task);
+    void Worker();
+
+  private:
+    std::vector<std::thread> Workers;
+    std::queue<std::function<void()>> Tasks;
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    bool Stopping = false;
+  };
+
+
+  template <typename F>
+  auto ThreadPool::Submit(F&& task) -> std::future<decltype(task())> {
+    using Result = decltype(task());
+
+    // std::function needs a copyable callable, so the packaged task lives on the heap
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    auto future = packaged->get_future();
+    Enqueue([packaged]() { (*packaged)(); });
+    return future;
+  }
+
+  template <typename F>
+  void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, F&& fn) {
+    if (begin >= end) return;
+    grain = std::max<size_t>(grain, 1);
+
+    const size_t chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1) {
+      fn(begin, end);
+      return;
+    }
+
+    // Shared between the caller and the helper tasks, which may outlive this call
+    // if they are dequeued after all chunks are taken
+    struct State {
+      std::atomic<size_t> next{0};
+      std::atomic<size_t> done{0};
+      std::mutex mutex;
+      std::condition_variable finished;
+    };
+    auto state = std::make_shared<State>();
+
+    auto run = [state, begin, end, grain, chunks, &fn]() {
+      size_t chunk;
+      while ((chunk = state->next.fetch_add(1)) < chunks) {
+        size_t first = begin + chunk * grain;
+        fn(first, std::min(first + grain, end));
+        if (state->done.fetch_add(1) + 1 == chunks) {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->finished.notify_all();
+        }
+      }
+    };
+
+    const size_t helpers = std::min<size_t>(chunks - 1, GetThreadCount());
+    for (size_t i = 0; i < helpers; i++) {
+      // Helpers never touch 'fn' once all chunks are taken, so capturing it by reference is safe
+      Enqueue([state, chunks, run]() { if (state->next.load() < chunks) run(); });
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, chunks]() { return state->done.load() == chunks; });
+  }
+};
+
+#endif // THREADPOOL_H_
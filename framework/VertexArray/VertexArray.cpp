@@ -31,12 +31,21 @@ namespace Framework {
         for (auto attr : layout.GetAttributes()) {
             // Add a vertex attrib pointer
             // (This opengl call is what associates the bounded VAO with the bounded VBO)
-            glVertexAttribPointer(attrIndex,
-                                attr.Count,
-                                ShaderDataTypeToOpenGLBaseType(attr.Type),
-                                attr.Normalized,
-                                layout.GetStride(),
-                                (const void*)(intptr_t)attr.Offset);
+            if (ShaderDataTypeIsInteger(attr.Type)) {
+                glVertexAttribIPointer(attrIndex,
+                                    attr.Count,
+                                    ShaderDataTypeToOpenGLBaseType(attr.Type),
+                                    layout.GetStride(),
+                                    (const void*)(intptr_t)attr.Offset);
+            } else {
+                // Packed normalized types are always normalized, whatever the attribute asks for
+                glVertexAttribPointer(attrIndex,
+                                    attr.Count,
+                                    ShaderDataTypeToOpenGLBaseType(attr.Type),
+                                    attr.Normalized || ShaderDataTypeIsNormalized(attr.Type),
+                                    layout.GetStride(),
+                                    (const void*)(intptr_t)attr.Offset);
+            }
             glEnableVertexAttribArray(attrIndex);
             attrIndex++;
         }
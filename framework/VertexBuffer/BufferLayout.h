@@ -29,6 +29,10 @@ namespace Framework {
             : Attributes(attributes) {
             this->CalculateOffsetAndStride();
         }
+        BufferLayout(const std::vector<BufferAttribute> &attributes)
+            : Attributes(attributes) {
+            this->CalculateOffsetAndStride();
+        }
 
         inline const std::vector<BufferAttribute> &GetAttributes() const { return this->Attributes; }
         inline GLsizei GetStride() const { return this->Stride; }
@@ -51,7 +55,7 @@ namespace Framework {
 
     private:
         std::vector<BufferAttribute> Attributes;
-        GLsizei Stride;
+        GLsizei Stride = 0;
     };
 };
 
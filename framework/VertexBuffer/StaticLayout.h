@@ -0,0 +1,61 @@
+#ifndef STATICLAYOUT_H
+#define STATICLAYOUT_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include "BufferLayout.h"
+
+namespace Framework {
+
+    namespace Detail {
+        constexpr GLuint SumOfFirst(std::initializer_list<GLsizei> sizes, size_t count) {
+            GLuint sum = 0;
+            for (auto it = sizes.begin(); count > 0; ++it, count--) sum += *it;
+            return sum;
+        }
+    };
+
+    // One attribute of a StaticLayout. The name must be a constant with static storage,
+    // since C++17 does not take string literals as template arguments:
+    //
+    //     static constexpr char PositionName[] = "a_Position";
+    //     Attr<ShaderDataType::Float3, PositionName>
+    template<ShaderDataType type, const char* name, bool normalized = false>
+    struct Attr {
+        static constexpr ShaderDataType Type = type;
+        static constexpr const char* Name = name;
+        static constexpr bool Normalized = normalized;
+        static constexpr GLsizei Size = ShaderDataTypeSize(type);
+        static constexpr GLint Count = ShaderDataTypeComponentCount(type);
+    };
+
+    // Vertex layout whose offsets and stride are known at compile time, so they can be
+    // checked against the vertex struct that fills the buffer:
+    //
+    //     using Layout = StaticLayout<Attr<ShaderDataType::Float3, PositionName>, Attr<ShaderDataType::Float2, UVName>>;
+    //     static_assert(Layout::Stride == sizeof(Vertex));
+    //     static_assert(Layout::Offset<1> == offsetof(Vertex, uv));
+    //     vertexBuffer->SetLayout(Layout::ToBufferLayout());
+    //
+    // Attributes are packed back to back, like in BufferLayout.
+    template<typename... Attrs>
+    class StaticLayout {
+    public:
+        static constexpr size_t Count = sizeof...(Attrs);
+        static constexpr GLsizei Stride = (GLsizei(0) + ... + Attrs::Size);
+
+        template<size_t index>
+        using Attribute = std::tuple_element_t<index, std::tuple<Attrs...>>;
+
+        template<size_t index>
+        static constexpr GLuint Offset = Detail::SumOfFirst({Attrs::Size..., 0}, index);
+
+        // Runtime copy, for VertexBuffer::SetLayout
+        static BufferLayout ToBufferLayout() {
+            return BufferLayout({BufferAttribute(Attrs::Type, Attrs::Name, Attrs::Normalized)...});
+        }
+    };
+};
+
+#endif
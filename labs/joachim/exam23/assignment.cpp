@@ -17,8 +17,9 @@
 
 #include "glHelpers.h"
 #include "board.h"
+#include "levelGenerator.h"
+#include "sokobanSolver.h"
 
-#include <cstdlib>
 #include <ctime>
 
 #ifndef TEXTURES_DIR
@@ -28,7 +29,7 @@
 
 using namespace Framework;
 
-bool moveBox(std::vector<Piece>& boxes, const std::vector<Piece>& pillars, const std::vector<Piece>& pieces, const std::vector<DesLoc>& desLoc, const Board::Pos& markedSquare, const std::string& way);
+bool moveBox(Entities& entities, const Board::Pos& markedSquare, const std::string& way);
 
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     // Key pressed
@@ -61,67 +62,41 @@ void Assignment::parseInput() {
                     // Move marker
                     case GLFW_KEY_UP:
                         {
-                        bool canMove = true;
-                            for (const auto& pillar : pillars) {
-                                if (markedSquare.x == pillar.GetPosition().x && markedSquare.y + 1 == pillar.GetPosition().y) {
-                                    canMove = false;
-                                    break;
-                                }
-                            }       
-
-                            if (canMove) {
-                                moveBox(boxes,pillars,pieces,desLoc,markedSquare, "up");
-                                    moveMarkedSquare(0, 1);
+                            // The player only steps onto a box's square if the box could be pushed away
+                            Board::Pos next(markedSquare.x, markedSquare.y + 1);
+                            if (!entities.IsOccupied(next, Entities::Pillar) && (moveBox(entities, markedSquare, "up") || !entities.IsOccupied(next, Entities::Box))) {
+                                moveMarkedSquare(0, 1);
                             }
                             return true;
                         }
                     case GLFW_KEY_DOWN:
                         {
-                        bool canMove = true;
-                            for (const auto& pillar : pillars) {
-                                if (markedSquare.x == pillar.GetPosition().x && markedSquare.y - 1 == pillar.GetPosition().y) {
-                                    canMove = false;
-                                    break;
-                                }
-                            }
-
-                            if (canMove) {
-                                moveBox(boxes,pillars,pieces,desLoc,markedSquare, "down");
+                            Board::Pos next(markedSquare.x, markedSquare.y - 1);
+                            if (!entities.IsOccupied(next, Entities::Pillar) && (moveBox(entities, markedSquare, "down") || !entities.IsOccupied(next, Entities::Box))) {
                                 moveMarkedSquare(0, -1);
                             }
                             return true;
                         }
                     case GLFW_KEY_LEFT:
                         {
-                            bool canMove = true;
-                            for (const auto& pillar : pillars) {
-                                if (markedSquare.x - 1 == pillar.GetPosition().x && markedSquare.y == pillar.GetPosition().y) {
-                                    canMove = false;
-                                    break;
-                                }
-                            }           
-                            if (canMove) {
-                                moveBox(boxes,pillars,pieces,desLoc,markedSquare, "left");
+                            Board::Pos next(markedSquare.x - 1, markedSquare.y);
+                            if (!entities.IsOccupied(next, Entities::Pillar) && (moveBox(entities, markedSquare, "left") || !entities.IsOccupied(next, Entities::Box))) {
                                 moveMarkedSquare(-1, 0);
                             }
                             return true;
                         }
                     case GLFW_KEY_RIGHT:
                         {
-                            bool canMove = true;
-                            for (const auto& pillar : pillars) {
-                                if (markedSquare.x + 1 == pillar.GetPosition().x && markedSquare.y == pillar.GetPosition().y) {
-                                    canMove = false;
-                                    break;
-                                }
-                            }
-
-                            if (canMove) {
-                                moveBox(boxes,pillars,pieces,desLoc,markedSquare, "right");
+                            Board::Pos next(markedSquare.x + 1, markedSquare.y);
+                            if (!entities.IsOccupied(next, Entities::Pillar) && (moveBox(entities, markedSquare, "right") || !entities.IsOccupied(next, Entities::Box))) {
                                 moveMarkedSquare(1, 0);
                             }
                             return true;
                         }
+                    // Print the next step towards a solution
+                    case GLFW_KEY_H:
+                        showHint();
+                        return true;
                     // Quit
                     case GLFW_KEY_Q:
                         glfwSetWindowShouldClose(window, GLFW_TRUE);
@@ -169,15 +144,14 @@ bool Assignment::Init() {
         return false;
     }
 
-    // Seed the random number generator
-    srand(static_cast<unsigned int>(std::time(0)));
-
     // OpenGL / GLFW setup
     glEnable(GL_DEPTH_TEST);
     glfwSetKeyCallback(window, keyCallback); // Input
 
     // Create board
     board = std::make_shared<Board>();
+    boardNode = scene.CreateNode();
+    entityRenderer = std::make_shared<EntityRenderer>();
 
 
     // Blue team: Pieces are only placed within the inner part of the board
@@ -186,155 +160,33 @@ bool Assignment::Init() {
             // Check for border squares
             if (i == 0 || i == BOARD_ROWS - 1 || j == 0 || j == BOARD_COLS - 1) {
                 // Add piece to the border square
-                pieces.push_back(Piece(j, i, glm::vec4(1.0f, 1.0f, 0.0f, 1.0f)));
+                pieces.push_back(Piece(entities, Entities::Piece, j, i, glm::vec4(1.0f, 1.0f, 0.0f, 1.0f)));
             }
         }
     }
 
-    // Randomize pillars within the inner part of the board
-    while (pillars.size() < 6) {
-        int x = rand() % (BOARD_COLS - 2) + 1; // Ensure x is within the inner part
-        int y = rand() % (BOARD_ROWS - 2) + 1; // Ensure y is within the inner part
-        bool positionOccupied = false;
-
-        // Check if the position is already occupied by another pillar
-        for (const auto& pillar : pillars) {
-            if (pillar.GetPosition().x == x && pillar.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-
-        // If the position is not occupied, add the new pillar
-        if (!positionOccupied) {
-            pillars.push_back(Piece(static_cast<float>(x), static_cast<float>(y), glm::vec4(0.0f, 1.0f, 1.0f, 1.0f)));
-        }
-    }
-    // Randomize pillars within the inner part of the board
-    while (boxes.size() < 6) {
-        int x = rand() % (BOARD_COLS - 2) + 1; // Ensure x is within the inner part
-        int y = rand() % (BOARD_ROWS - 2) + 1; // Ensure y is within the inner part
-        bool positionOccupied = false;
-
-        // Check if the position is already occupied by another pillar
-        for (const auto& pillar : pillars) {
-            if (pillar.GetPosition().x == x && pillar.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-        for (const auto& box : boxes) {
-            if (box.GetPosition().x == x && box.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-
-
-        // If the position is not occupied, add the new pillar
-        if (!positionOccupied) {
-            boxes.push_back(Piece(static_cast<float>(x), static_cast<float>(y), glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)));
-        }
-    }
-
-    while (boxes.size() < 6) {
-        int x = rand() % (BOARD_COLS - 2) + 1; // Ensure x is within the inner part
-        int y = rand() % (BOARD_ROWS - 2) + 1; // Ensure y is within the inner part
-        bool positionOccupied = false;
-
-        // Check if the position is already occupied by another pillar
-        for (const auto& pillar : pillars) {
-            if (pillar.GetPosition().x == x && pillar.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-        for (const auto& box : boxes) {
-            if (box.GetPosition().x == x && box.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-
-
-        // If the position is not occupied, add the new pillar
-        if (!positionOccupied) {
-            boxes.push_back(Piece(static_cast<float>(x), static_cast<float>(y), glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)));
-        }
+    // Pillars, boxes, destinations and the player from a generated level. Every generated level
+    // can be solved, and its seed makes it again.
+    LevelGenerator generator(SokobanLevel::FromEntities(entities, markedSquare));
+    LevelGenerator::Options options;
+    options.Seed = static_cast<uint64_t>(std::time(0));
+    std::vector<LevelGenerator::Level> levels;
+    while ((levels = generator.Generate(options)).empty()) options.Seed++;
+    const LevelGenerator::Level& level = levels.front();
+
+    for (const Board::Pos& pos : level.Pillars) {
+        pillars.push_back(Piece(entities, Entities::Pillar, pos.x, pos.y, glm::vec4(0.0f, 1.0f, 1.0f, 1.0f)));
     }
-
-    while (desLoc.size() < 6) {
-        int x = rand() % (BOARD_COLS - 2) + 1; // Ensure x is within the inner part
-        int y = rand() % (BOARD_ROWS - 2) + 1; // Ensure y is within the inner part
-        bool positionOccupied = false;
-
-        // Check if the position is already occupied by another pillar
-        for (const auto& pillar : pillars) {
-            if (pillar.GetPosition().x == x && pillar.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-        for (const auto& box : boxes) {
-            if (box.GetPosition().x == x && box.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-        for (const auto& loc : desLoc) {
-            if (loc.GetPosition().x == x && loc.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-
-
-        // If the position is not occupied, add the new pillar
-        if (!positionOccupied) {
-            desLoc.push_back(DesLoc(static_cast<float>(x), static_cast<float>(y), glm::vec4(1.0f, 0.0f, 1.0f, 1.0f)));
-        }
+    for (const Board::Pos& pos : level.Puzzle.Boxes) {
+        boxes.push_back(Piece(entities, Entities::Box, pos.x, pos.y, glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)));
     }
-    // Randomize markedSquare position
-    bool placeAllowed = false;
-    while (!placeAllowed) {
-        int x = rand() % (BOARD_COLS - 2) + 1; // Ensure x is within the inner part
-        int y = rand() % (BOARD_ROWS - 2) + 1; // Ensure y is within the inner part
-        bool positionOccupied = false;
-
-        // Check if the position is already occupied by another pillar, box, desLoc, or piece
-        for (const auto& pillar : pillars) {
-            if (pillar.GetPosition().x == x && pillar.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-        for (const auto& box : boxes) {
-            if (box.GetPosition().x == x && box.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-        for (const auto& loc : desLoc) {
-            if (loc.GetPosition().x == x && loc.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-        for (const auto& piece : pieces) {
-            if (piece.GetPosition().x == x && piece.GetPosition().y == y) {
-                positionOccupied = true;
-                break;
-            }
-        }
-
-        // If the position is not occupied, update the markedSquare position
-        if (!positionOccupied) {
-            markedSquare = Board::Pos(static_cast<float>(x), static_cast<float>(y));
-            placeAllowed = true;
-        }
+    for (const Board::Pos& pos : level.Puzzle.Targets) {
+        desLoc.push_back(DesLoc(entities, pos.x, pos.y, glm::vec4(1.0f, 0.0f, 1.0f, 1.0f)));
     }
+    markedSquare = level.Puzzle.Player;
+    std::cout << "Level " << level.Seed << ", difficulty " << level.Difficulty << std::endl;
 
-    player.push_back(Piece(markedSquare.x, markedSquare.y, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)));
+    player.push_back(Piece(entities, Entities::Player, markedSquare.x, markedSquare.y, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)));
 
     // Camera
     auto position = glm::vec3(0, 0, 2); // x, y: overwritten by rotateCamera
@@ -352,9 +204,6 @@ bool Assignment::Init() {
     camera = std::make_shared<PerspectiveCamera>(frustrum, position, lookAt, upVector);
     rotateCamera(0);
 
-    // Randomize markedSquare position
-    markedSquare = Board::Pos(static_cast<float>(rand() % BOARD_COLS), static_cast<float>(rand() % BOARD_ROWS));
-
     return true;
 }
 
@@ -384,48 +233,20 @@ void Assignment::Run() {
         RenderCommands::Clear();
 
 
-        // Draw board
-        board->Draw(camera->GetViewProjectionMatrix(), markedSquare);
-
-        // Loop through and draw each piece
-        for (auto& piece : pieces) {
-            piece.Draw(camera->GetViewProjectionMatrix(), nullptr);
-        }
-
-        // Loop through and draw each pillar
-        for (auto& pillar : pillars) {
-            pillar.Draw(camera->GetViewProjectionMatrix(), nullptr);
-        }
-
         if (!player.empty()) {
             player[0].SetPosition(Board::Pos{markedSquare.x, markedSquare.y});
         }
-        for (auto &p : player) {
-
-            p.Draw(camera->GetViewProjectionMatrix(), nullptr);
-        }
 
-        // Loop through and draw each box
-        for (auto& box : boxes) {
-            bool onLocation = false;
-            for (const auto& loc : desLoc) {
-                if (box.GetPosition().x == loc.GetPosition().x && box.GetPosition().y == loc.GetPosition().y) {
-                    onLocation = true;
-                    break;
-                }
-            }
+        // Systems: transforms of the entities that moved, colors of the boxes
+        scene.Update();
+        entities.UpdateTransforms(scene.GetWorldMatrix(boardNode), scene.IsWorldChanged(boardNode));
+        entities.UpdateHighlights();
 
-            // Determine the color of the box
-            std::shared_ptr<glm::vec4> color = onLocation ? std::make_shared<glm::vec4>(0.0f, 0.0f, 1.0f, 1.0f) : nullptr;
-
-            // Draw the box with the correct color
-            box.Draw(camera->GetViewProjectionMatrix(), color);
-        }
+        // Draw board
+        board->Draw(camera->GetViewProjectionMatrix(), markedSquare);
 
-        // Loop through and draw each destination location
-        for (auto& loc : desLoc) {
-            loc.Draw(camera->GetViewProjectionMatrix(), nullptr);
-        }
+        // Draw pieces, pillars, the player, boxes and destinations
+        entityRenderer->Draw(entities, camera->GetViewProjectionMatrix());
 
         // Swap buffers
         glfwSwapBuffers(window);
@@ -480,7 +301,7 @@ void Assignment::moveMarkedSquare(int dx, int dy) {
 }
 
 void Assignment::selectPiece() {
-    if (selectedPiece) return; // Verify that there is no selected piece
+    if (selectedPiece != Entities::NoEntity) return; // Verify that there is no selected piece
 
     // Find piece at currently marked pos
     selectedPiece = getPieceAtPos(markedSquare); // Select it
@@ -491,77 +312,61 @@ void Assignment::movePiece() {
 
 }
 
-// Returns a pointer to the piece at the given pos (nullptr if none)
-Piece* Assignment::getPieceAtPos(Board::Pos p) {
-    for (int i = 0; i < pieces.size(); i++) {
-        if (pieces[i].GetPosition() == p)
-            return &pieces[i];
+// Solves the level from where it stands and prints the next step
+void Assignment::showHint() {
+    SokobanSolver solver(SokobanLevel::FromEntities(entities, markedSquare));
+    SokobanSolver::Result result = solver.Solve();
+
+    if (result.Outcome == SokobanSolver::Unsolvable) {
+        std::cout << "Hint: the level can no longer be solved" << std::endl;
+    } else if (result.Outcome == SokobanSolver::GaveUp) {
+        std::cout << "Hint: no solution found" << std::endl;
+    } else if (result.Steps.empty()) {
+        std::cout << "Hint: solved" << std::endl;
+    } else {
+        const Board::Pos step = result.Steps.front();
+        const char* way = step.y > 0 ? "up" : step.y < 0 ? "down" : step.x < 0 ? "left" : "right";
+        std::cout << "Hint: " << way << ", " << result.Pushes.size() << " pushes left" << std::endl;
     }
-    return nullptr;
+    std::cout << "  " << result.States << " states in " << result.Seconds << " s ("
+              << static_cast<size_t>(result.StatesPerSecond()) << " states/s)" << std::endl;
 }
 
-bool moveBox(std::vector<Piece>& boxes, const std::vector<Piece>& pillars, const std::vector<Piece>& pieces, const std::vector<DesLoc>& desLoc, const Board::Pos& markedSquare, const std::string& way) {
-    for (auto& box : boxes) {
-        bool canMove = true;
-        Board::Pos newPos = box.GetPosition();
-
-        // Determine the new position based on the direction
-        if (way == "down") {
-            newPos.y -= 1;
-        } else if (way == "up") {
-            newPos.y += 1;
-        } else if (way == "left") {
-            newPos.x -= 1;
-        } else if (way == "right") {
-            newPos.x += 1;
-        }
+// Returns the piece at the given pos (Entities::NoEntity if none)
+Entities::Entity Assignment::getPieceAtPos(Board::Pos p) {
+    return entities.Find(p, Entities::Piece);
+}
 
-        // Check for collisions with walls (assuming walls are at the edges of the board)
-        if (newPos.x < 0 || newPos.x >= BOARD_COLS || newPos.y < 0 || newPos.y >= BOARD_ROWS) {
-            canMove = false;
-        }
+bool moveBox(Entities& entities, const Board::Pos& markedSquare, const std::string& way) {
+    // Step in the given direction
+    Board::Pos step(0, 0);
+    if (way == "down") {
+        step.y = -1;
+    } else if (way == "up") {
+        step.y = 1;
+    } else if (way == "left") {
+        step.x = -1;
+    } else if (way == "right") {
+        step.x = 1;
+    }
 
-        // Check for collisions with pillars
-        for (const auto& pillar : pillars) {
-            if (newPos == pillar.GetPosition()) {
-                canMove = false;
-                break;
-            }
-        }
+    // Only the box right next to the marked square is pushed
+    Board::Pos boxPos(markedSquare.x + step.x, markedSquare.y + step.y);
+    Entities::Entity box = entities.Find(boxPos, Entities::Box);
+    if (box == Entities::NoEntity) return false;
 
-        // Check for collisions with other pieces
-        for (const auto& piece : pieces) {
-            if (newPos == piece.GetPosition()) {
-                canMove = false;
-                break;
-            }
-        }
+    Board::Pos newPos(boxPos.x + step.x, boxPos.y + step.y);
 
-        // Check for collisions with other boxes
-        for (const auto& otherBox : boxes) {
-            if (&otherBox != &box && newPos == otherBox.GetPosition()) {
-                canMove = false;
-                break;
-            }
-        }
+    // Check for collisions with walls (assuming walls are at the edges of the board)
+    if (newPos.x < 0 || newPos.x >= BOARD_COLS || newPos.y < 0 || newPos.y >= BOARD_ROWS) {
+        return false;
+    }
 
-        // Move the box if there are no collisions
-        if (canMove) {
-            if (way == "down" && markedSquare.x == box.GetPosition().x && markedSquare.y - 1 == box.GetPosition().y) {
-                box.SetPosition(newPos);
-                return true;
-            } else if (way == "up" && markedSquare.x == box.GetPosition().x && markedSquare.y + 1 == box.GetPosition().y) {
-                box.SetPosition(newPos);
-                return true;
-            } else if (way == "left" && markedSquare.x - 1 == box.GetPosition().x && markedSquare.y == box.GetPosition().y) {
-                box.SetPosition(newPos);
-                return true;
-            } else if (way == "right" && markedSquare.x + 1 == box.GetPosition().x && markedSquare.y == box.GetPosition().y) {
-                box.SetPosition(newPos);
-                return true;
-            }
-        }
+    // Check for collisions with pillars, pieces and other boxes
+    if (entities.IsOccupied(newPos, Entities::Pillar | Entities::Piece | Entities::Box)) {
+        return false;
     }
-    return false;
-}
 
+    entities.SetPosition(box, newPos);
+    return true;
+}
@@ -11,8 +11,11 @@
 
 #include "GLFWApplication.h"
 #include "PerspectiveCamera.h"
+#include "SceneGraph.h"
 
 #include "board.h"
+#include "entities.h"
+#include "entityRenderer.h"
 #include "piece.h"
 #include "desLoc.h"
 
@@ -33,7 +36,7 @@ private:
     const float cameraDistance = 3;
 
     // Config
-    Piece* selectedPiece = nullptr;
+    Entities::Entity selectedPiece = Entities::NoEntity;
 
     // Runtime
     double time = 0.0f; // Total time since start
@@ -47,10 +50,17 @@ private:
     void moveMarkedSquare(int deltaX, int deltaY);
     void selectPiece();
     void movePiece();
+    void showHint();
 
-    Piece* getPieceAtPos(Board::Pos p);
+    Entities::Entity getPieceAtPos(Board::Pos p);
 public:
     bool texture_bool = false;
+    // The board's transform; the entities are placed relative to it
+    Framework::SceneGraph scene;
+    Framework::SceneGraph::NodeId boardNode = Framework::SceneGraph::NoNode;
+    // Everything on the board; Piece and DesLoc are handles into it
+    Entities entities;
+    std::shared_ptr<EntityRenderer> entityRenderer;
     Board::Pos markedSquare;
     std::vector<Piece> pillars;
     std::vector<Piece> boxes;
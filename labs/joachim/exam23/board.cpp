@@ -11,8 +11,8 @@ using namespace Framework;
 Board::Board() {
 
     // Initialize board
-    auto chessBoardVertices = GeometricTools::UnitGridGeometry2D<BOARD_ROWS, BOARD_COLS>(); //data for verticies
-    auto chessBoardIndices = GeometricTools::UnitGridTopologyTriangles<BOARD_ROWS, BOARD_COLS>(); //data for squares/incencies
+    static constexpr auto chessBoardVertices = GeometricTools::UnitGridGeometry2D<BOARD_ROWS, BOARD_COLS>(); //data for verticies
+    static constexpr auto chessBoardIndices = GeometricTools::UnitGridTopologyTriangles<BOARD_ROWS, BOARD_COLS>(); //data for squares/incencies
 
     auto vb = std::make_shared<VertexBuffer>(chessBoardVertices.data(), chessBoardVertices.size() * sizeof(chessBoardVertices[0]));
     BufferLayout vboLayout = {
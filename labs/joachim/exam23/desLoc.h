@@ -2,30 +2,24 @@
 #define DESLOC_H
 
 #include <glm/glm.hpp>
-#include <memory>
-
-#include "VertexArray.h"
-#include "Shader.h"
 
 #include "board.h"
+#include "entities.h"
 
+// Handle to a destination marker. The data lives in the Entities arrays; copies of a DesLoc
+// refer to the same entity.
 class DesLoc {
   private:
-    std::shared_ptr<Framework::VertexArray> vertexArray;
-    std::shared_ptr<Framework::Shader> shader;
-    glm::mat4 modelMatrix;
-    glm::mat4 initModelMatrix;
-    glm::vec4 color;
-    Board::Pos pos;
+    Entities* entities;
+    Entities::Entity entity;
     
   public:
-    DesLoc(int x, int y, glm::vec4 color);
+    DesLoc(Entities& entities, int x, int y, glm::vec4 color);
     ~DesLoc() { }   
 
-    void SetPosition(Board::Pos pos);
-    Board::Pos GetPosition() const { return pos; }
-
-    void Draw(glm::mat4 cameraModel, std::shared_ptr<glm::vec4> overrideColor = nullptr);
+    void SetPosition(Board::Pos pos) { entities->SetPosition(entity, pos); }
+    Board::Pos GetPosition() const { return entities->GetPosition(entity); }
+    Entities::Entity GetEntity() const { return entity; }
 };
 
 #endif
\ No newline at end of file
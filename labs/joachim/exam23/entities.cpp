@@ -0,0 +1,162 @@
+#include "entities.h"
+
+#include <algorithm>
+
+namespace {
+    // Size of each mesh's cube and the height of its center above the board
+    struct MeshShape {
+        float scale;
+        float height;
+    };
+    const MeshShape MeshShapes[Entities::MeshCount] = {
+        {0.2f, 0.10f},      // MeshPiece
+        {0.1f, 0.01f}       // MeshMarker
+    };
+
+    const glm::vec4 HighlightColor(0.0f, 0.0f, 1.0f, 1.0f);
+
+    // One occupancy layer per kind flag
+    constexpr int KindLayers = 5;
+    static_assert((Entities::Kinds >> KindLayers) == 0, "every kind flag needs an occupancy layer");
+
+    inline int LowestBit(uint8_t bits) {
+        int bit = 0;
+        while (!(bits & (1u << bit))) bit++;
+        return bit;
+    }
+}
+
+Entities::Entities()
+    : Grid(BOARD_COLS, BOARD_ROWS, KindLayers) {
+}
+
+Entities::Entity Entities::Create(Board::Pos pos, glm::vec4 color, Mesh mesh, uint8_t flags) {
+    Entity id;
+    if (!FreeIds.empty()) {
+        id = FreeIds.back();
+        FreeIds.pop_back();
+    } else {
+        id = static_cast<Entity>(Slots.size());
+        Slots.push_back(Removed);
+    }
+
+    Slots[id] = static_cast<uint32_t>(Ids.size());
+    Ids.push_back(id);
+    Positions.push_back(pos);
+    Transforms.push_back(glm::mat4(1.0f));
+    Colors.push_back(color);
+    Meshes.push_back(mesh);
+    FlagBits.push_back(flags & ~Moved);
+    MarkMoved(Slots[id]);
+    Place(pos, flags, id);
+    return id;
+}
+
+void Entities::Destroy(Entity entity) {
+    const uint32_t index = Slots[entity];
+    Unplace(Positions[index], FlagBits[index], entity);
+
+    // Move the last entity into the hole
+    const uint32_t last = static_cast<uint32_t>(Ids.size() - 1);
+    if (index != last) {
+        Ids[index] = Ids[last];
+        Positions[index] = Positions[last];
+        Transforms[index] = Transforms[last];
+        Colors[index] = Colors[last];
+        Meshes[index] = Meshes[last];
+        FlagBits[index] = FlagBits[last];
+        Slots[Ids[index]] = index;
+    }
+    Ids.pop_back();
+    Positions.pop_back();
+    Transforms.pop_back();
+    Colors.pop_back();
+    Meshes.pop_back();
+    FlagBits.pop_back();
+
+    Slots[entity] = Removed;
+    FreeIds.push_back(entity);
+}
+
+bool Entities::IsValid(Entity entity) const {
+    return entity < Slots.size() && Slots[entity] != Removed;
+}
+
+void Entities::SetPosition(Entity entity, Board::Pos pos) {
+    const uint32_t index = Slots[entity];
+    Unplace(Positions[index], FlagBits[index], entity);
+    Positions[index] = pos;
+    Place(pos, FlagBits[index], entity);
+    MarkMoved(index);
+}
+
+void Entities::Place(Board::Pos pos, uint8_t flags, Entity entity) {
+    for (uint8_t kinds = flags & Kinds; kinds; kinds &= kinds - 1) Grid.Insert(pos, LowestBit(kinds), entity);
+}
+
+void Entities::Unplace(Board::Pos pos, uint8_t flags, Entity entity) {
+    for (uint8_t kinds = flags & Kinds; kinds; kinds &= kinds - 1) Grid.Remove(pos, LowestBit(kinds), entity);
+}
+
+void Entities::MarkMoved(uint32_t index) {
+    if (FlagBits[index] & Moved) return;
+    FlagBits[index] |= Moved;
+    MovedIds.push_back(Ids[index]);
+}
+
+Entities::Entity Entities::Find(Board::Pos pos, uint8_t kinds) const {
+    const uint8_t found = Grid.GetLayers(pos) & kinds;
+    return found ? Grid.Get(pos, LowestBit(found)) : NoEntity;
+}
+
+void Entities::UpdateTransforms(const glm::mat4& boardMatrix, bool boardChanged) {
+    const float xoffset = BOARD_SQUARE_XSIZE/2.0f;
+    const float yoffset = BOARD_SQUARE_YSIZE/2.0f;
+
+    // The columns of boardMatrix * scale, per mesh
+    glm::mat4 scaled[MeshCount];
+    for (int mesh = 0; mesh < MeshCount; mesh++) {
+        scaled[mesh] = boardMatrix;
+        scaled[mesh][0] *= MeshShapes[mesh].scale;
+        scaled[mesh][1] *= MeshShapes[mesh].scale;
+        scaled[mesh][2] *= MeshShapes[mesh].scale;
+    }
+
+    auto update = [&](size_t i) {
+        // boardMatrix * translate(square center) * scale
+        const uint8_t mesh = Meshes[i];
+        const glm::vec4 translation(1.0f - xoffset - Positions[i].x * BOARD_SQUARE_XSIZE,
+                                    1.0f - yoffset - Positions[i].y * BOARD_SQUARE_YSIZE,
+                                    MeshShapes[mesh].height, 1.0f);
+        glm::mat4& transform = Transforms[i];
+        transform[0] = scaled[mesh][0];
+        transform[1] = scaled[mesh][1];
+        transform[2] = scaled[mesh][2];
+        transform[3] = boardMatrix * translation;
+        FlagBits[i] &= ~Moved;
+    };
+
+    if (boardChanged) {
+        for (size_t i = 0; i < Ids.size(); i++) update(i);
+    } else {
+        // Ids of destroyed entities may be stale or reused; those are skipped or already done
+        for (Entity id : MovedIds) {
+            if (IsValid(id) && (FlagBits[Slots[id]] & Moved)) update(Slots[id]);
+        }
+    }
+    MovedIds.clear();
+}
+
+void Entities::UpdateHighlights() {
+    for (size_t i = 0; i < Ids.size(); i++) {
+        const bool onDestination = (FlagBits[i] & Box) && IsOccupied(Positions[i], Destination);
+        FlagBits[i] = onDestination ? (FlagBits[i] | Highlighted) : (FlagBits[i] & ~Highlighted);
+    }
+}
+
+void Entities::GatherInstances(Mesh mesh, std::vector<Instance>& instances) const {
+    for (size_t i = 0; i < Ids.size(); i++) {
+        if (Meshes[i] != mesh) continue;
+        instances.push_back({Transforms[i], (FlagBits[i] & Highlighted) ? HighlightColor : Colors[i]});
+    }
+}
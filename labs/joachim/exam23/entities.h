@@ -0,0 +1,103 @@
+#ifndef ENTITIES_H
+#define ENTITIES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "board.h"
+#include "occupancyGrid.h"
+
+// Everything that stands on the board (pieces, pillars, boxes, the player and destinations),
+// stored as entities: every component lives in its own dense array (structure of arrays), so a
+// system that needs two components streams through exactly those two arrays.
+//
+// Entity ids stay valid until the entity is destroyed, after which they may be reused. The
+// arrays are kept dense by moving the last entity into the hole left by a destroyed one.
+class Entities {
+  public:
+    using Entity = uint32_t;
+    static constexpr Entity NoEntity = ~0u;
+
+    // Flags component: what an entity is, plus state set by the systems
+    enum Flags : uint8_t {
+        Piece       = 1 << 0,
+        Pillar      = 1 << 1,
+        Box         = 1 << 2,
+        Player      = 1 << 3,
+        Destination = 1 << 4,
+        Highlighted = 1 << 5,   // Box on a destination (UpdateHighlights)
+        Moved       = 1 << 6,   // Transform is out of date (UpdateTransforms)
+
+        Kinds       = Piece | Pillar | Box | Player | Destination
+    };
+
+    // Mesh component: the model drawn for an entity
+    enum Mesh : uint8_t {
+        MeshPiece,              // Cube filling most of a square
+        MeshMarker,             // Small cube flat on the board
+        MeshCount
+    };
+
+    // Per-instance data for instanced drawing, laid out like a std430 struct
+    struct Instance {
+        glm::mat4 Model;
+        glm::vec4 Color;
+    };
+
+    Entities();
+
+    Entity Create(Board::Pos pos, glm::vec4 color, Mesh mesh, uint8_t flags);
+    void Destroy(Entity entity);
+    bool IsValid(Entity entity) const;
+    inline size_t Size() const { return Ids.size(); }
+
+    inline Board::Pos GetPosition(Entity entity) const { return Positions[Slots[entity]]; }
+    void SetPosition(Entity entity, Board::Pos pos);
+    inline const glm::vec4& GetColor(Entity entity) const { return Colors[Slots[entity]]; }
+    inline void SetColor(Entity entity, const glm::vec4& color) { Colors[Slots[entity]] = color; }
+    inline uint8_t GetFlags(Entity entity) const { return FlagBits[Slots[entity]]; }
+    inline const glm::mat4& GetTransform(Entity entity) const { return Transforms[Slots[entity]]; }
+
+    // Lookups through the occupancy grid, in constant time. 'kinds' is a mask of Kinds flags.
+    inline bool IsOccupied(Board::Pos pos, uint8_t kinds) const { return (Grid.GetLayers(pos) & kinds) != 0; }
+    // An entity at 'pos' of one of 'kinds' (the lowest flag first), NoEntity if none.
+    Entity Find(Board::Pos pos, uint8_t kinds) const;
+
+    // Systems
+
+    // Recompute the transforms of moved entities; all of them if the board's matrix changed.
+    void UpdateTransforms(const glm::mat4& boardMatrix, bool boardChanged);
+    // Highlight the boxes that stand on a destination.
+    void UpdateHighlights();
+    // Append the instances of every entity with the given mesh.
+    void GatherInstances(Mesh mesh, std::vector<Instance>& instances) const;
+
+  private:
+    void MarkMoved(uint32_t index);
+    void Place(Board::Pos pos, uint8_t flags, Entity entity);
+    void Unplace(Board::Pos pos, uint8_t flags, Entity entity);
+
+  private:
+    static constexpr uint32_t Removed = ~0u;
+
+    // By id
+    std::vector<uint32_t> Slots;            // Index in the arrays below, Removed if free
+    std::vector<Entity> FreeIds;
+
+    // By index: the components
+    std::vector<Entity> Ids;
+    std::vector<Board::Pos> Positions;
+    std::vector<glm::mat4> Transforms;
+    std::vector<glm::vec4> Colors;
+    std::vector<uint8_t> Meshes;
+    std::vector<uint8_t> FlagBits;
+
+    std::vector<Entity> MovedIds;           // Entities that got the Moved flag, each once
+
+    // Where the entities stand, one layer per kind flag (layer i holds kind 1 << i)
+    OccupancyGrid Grid;
+};
+
+#endif
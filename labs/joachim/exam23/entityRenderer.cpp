@@ -0,0 +1,64 @@
+#include "GeometricTools.h"
+#include "RenderCommands.h"
+
+#include "entityRenderer.h"
+#include "shaders/entity.glsh"
+
+using namespace Framework;
+
+static_assert(sizeof(Entities::Instance) == 80, "Entities::Instance must match the std430 layout in entity.glsh");
+
+EntityRenderer::EntityRenderer() {
+    // Every mesh is a scaled unit cube for now
+    auto cubeVertices = GeometricTools::UnitCubeGeometry3D;
+    auto cubeIndices = GeometricTools::UnitCubeTopology3D;
+
+    // Vertex Buffer
+    auto vb = std::make_shared<VertexBuffer>(cubeVertices.data(), cubeVertices.size() * sizeof(cubeVertices[0]));
+    BufferLayout vblayout = {
+        {ShaderDataType::Float3, "a_Position"}
+    };
+    vb->SetLayout(vblayout);
+
+    // Index buffer
+    auto ib = std::make_shared<IndexBuffer>(cubeIndices.data(), cubeIndices.size());
+
+    // Vertex Array
+    vertexArray = std::make_shared<VertexArray>();
+    vertexArray->AddVertexBuffer(vb);
+    vertexArray->SetIndexBuffer(ib);
+
+    // Shader
+    shader = std::make_shared<Shader>(E_VERTEX_SHADER, E_FRAGMENT_SHADER);
+
+    // Instance buffer, sized on first use
+    glGenBuffers(1, &instanceBuffer);
+}
+
+EntityRenderer::~EntityRenderer() {
+    glDeleteBuffers(1, &instanceBuffer);
+}
+
+void EntityRenderer::Draw(const Entities& entities, glm::mat4 cameraModel) {
+
+    vertexArray->Bind();
+    shader->Bind();
+    shader->UploadUniformMatrix4("u_ViewProjection", cameraModel);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+    for (int mesh = 0; mesh < Entities::MeshCount; mesh++) {
+        instances.clear();
+        entities.GatherInstances(static_cast<Entities::Mesh>(mesh), instances);
+        if (instances.empty()) continue;
+
+        // Grow the buffer, or orphan it so the previous draw can still read the old contents
+        const GLsizeiptr size = instances.size() * sizeof(Entities::Instance);
+        if (size > instanceBufferSize) instanceBufferSize = size;
+        glBufferData(GL_SHADER_STORAGE_BUFFER, instanceBufferSize, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, instances.data());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instanceBuffer);
+
+        RenderCommands::DrawIndexInstanced(vertexArray, GL_TRIANGLES, (GLsizei)instances.size());
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef ENTITYRENDERER_H
+#define ENTITYRENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "VertexArray.h"
+#include "Shader.h"
+
+#include "entities.h"
+
+// Draws all entities with one instanced draw call per mesh. The instances are gathered from
+// the entity arrays every frame and read by the vertex shader from a storage buffer.
+class EntityRenderer {
+  private:
+    std::shared_ptr<Framework::VertexArray> vertexArray;
+    std::shared_ptr<Framework::Shader> shader;
+    GLuint instanceBuffer = 0;
+    GLsizeiptr instanceBufferSize = 0;
+    std::vector<Entities::Instance> instances;     // Reused between frames
+
+  public:
+    EntityRenderer();
+    ~EntityRenderer();
+
+    EntityRenderer(const EntityRenderer&) = delete;
+    EntityRenderer& operator=(const EntityRenderer&) = delete;
+
+    // Entities::UpdateTransforms and UpdateHighlights should have run this frame.
+    void Draw(const Entities& entities, glm::mat4 cameraModel);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Shader.h"
+#include "VertexArray.h"
+
+#include "entities.h"
+
+// Entities benchmark: the structure of arrays against the layout the board objects had before,
+// one 192-byte object per piece with its own GL handles, model matrices, color and position.
+// Both compute the same transforms; the check compares them exactly before anything is timed.
+// Moving an entity also updates the occupancy grid, which the old objects did not have.
+//
+//   entitybench [entities] [frames]
+
+namespace {
+    // The old Piece / DesLoc members. The handles stay null; only the memory layout matters here.
+    struct OldPiece {
+        std::shared_ptr<Framework::VertexArray> vertexArray;
+        std::shared_ptr<Framework::Shader> shader;
+        glm::mat4 modelMatrix;
+        glm::mat4 initModelMatrix;
+        glm::vec4 color;
+        Board::Pos pos;
+        uint8_t mesh;
+    };
+
+    template<class F>
+    double Milliseconds(F frame, int frames) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) frame();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int frames = argc > 2 ? atoi(argv[2]) : 20;
+    if (count < 100 || frames < 1) {
+        printf("usage: entitybench [entities >= 100] [frames]\n");
+        return 1;
+    }
+
+    // Every eighth entity is a destination marker, the rest are pieces
+    uint32_t state = 1;
+    auto random = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+    const float xoffset = BOARD_SQUARE_XSIZE/2.0f;
+    const float yoffset = BOARD_SQUARE_YSIZE/2.0f;
+    std::vector<OldPiece> old(count);
+    Entities entities;
+    for (int i = 0; i < count; i++) {
+        const Board::Pos pos(random() % BOARD_COLS, random() % BOARD_ROWS);
+        const bool marker = i % 8 == 0;
+        const glm::vec4 color(1.0f, 0.0f, 0.0f, 1.0f);
+        const float scale = marker ? 0.1f : 0.2f;
+        const float height = marker ? 0.01f : 0.10f;
+
+        old[i].pos = pos;
+        old[i].color = color;
+        old[i].mesh = marker ? Entities::MeshMarker : Entities::MeshPiece;
+        old[i].initModelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f - xoffset, 1.0f - yoffset, height))
+                               * glm::scale(glm::mat4(1.0f), glm::vec3(scale));
+        entities.Create(pos, color, marker ? Entities::MeshMarker : Entities::MeshPiece, marker ? Entities::Destination : Entities::Box);
+    }
+
+    // The same 1% moves right one square every frame
+    std::vector<Entities::Entity> moving(count / 100);
+    for (Entities::Entity& entity : moving) entity = random() % count;
+
+    const glm::mat4 board(1.0f);
+    std::vector<Entities::Instance> instances;
+    instances.reserve(count);
+
+    auto oldUpdate = [&](OldPiece& piece) {
+        piece.modelMatrix = board * glm::translate(glm::mat4(1.0f), glm::vec3(-piece.pos.x * BOARD_SQUARE_XSIZE, -piece.pos.y * BOARD_SQUARE_YSIZE, 0.0f))
+                          * piece.initModelMatrix;
+    };
+    auto oldUpdateAll = [&]() {
+        for (OldPiece& piece : old) oldUpdate(piece);
+    };
+    auto oldUpdateMoved = [&]() {
+        for (Entities::Entity i : moving) {
+            old[i].pos.x = (old[i].pos.x + 1) % BOARD_COLS;
+            oldUpdate(old[i]);
+        }
+    };
+    auto oldGather = [&]() {
+        instances.clear();
+        for (uint8_t mesh = 0; mesh < Entities::MeshCount; mesh++) {
+            for (const OldPiece& piece : old) {
+                if (piece.mesh == mesh) instances.push_back({piece.modelMatrix, piece.color});
+            }
+        }
+    };
+
+    auto newUpdateAll = [&]() { entities.UpdateTransforms(board, true); };
+    auto newUpdateMoved = [&]() {
+        for (Entities::Entity entity : moving) {
+            Board::Pos pos = entities.GetPosition(entity);
+            pos.x = (pos.x + 1) % BOARD_COLS;
+            entities.SetPosition(entity, pos);
+        }
+        entities.UpdateTransforms(board, false);
+    };
+    auto newGather = [&]() {
+        instances.clear();
+        for (uint8_t mesh = 0; mesh < Entities::MeshCount; mesh++) entities.GatherInstances(static_cast<Entities::Mesh>(mesh), instances);
+    };
+
+    // Check: both layouts must produce the same matrices, before and after moves
+    size_t mismatches = 0;
+    oldUpdateAll();
+    newUpdateAll();
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < count; i++) mismatches += old[i].modelMatrix != entities.GetTransform(i);
+        oldUpdateMoved();
+        newUpdateMoved();
+    }
+    printf("%d entities, %zu bytes per old object: %zu transforms differ\n\n", count, sizeof(OldPiece), mismatches);
+
+    const double times[][2] = {
+        {Milliseconds(oldUpdateAll, frames), Milliseconds(newUpdateAll, frames)},
+        {Milliseconds(oldUpdateMoved, frames), Milliseconds(newUpdateMoved, frames)},
+        {Milliseconds(oldGather, frames), Milliseconds(newGather, frames)},
+        {Milliseconds([&]() { oldUpdateMoved(); oldGather(); }, frames), Milliseconds([&]() { newUpdateMoved(); newGather(); }, frames)},
+    };
+    const char* names[] = {"update all transforms", "update 1% moved", "gather instances", "frame (1% moved + gather)"};
+
+    printf("%-27s %10s %10s %8s\n", "ms", "AoS", "SoA", "speedup");
+    for (int i = 0; i < 4; i++) {
+        printf("%-27s %10.3f %10.3f %8.2f\n", names[i], times[i][0], times[i][1], times[i][0] / times[i][1]);
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include "levelGenerator.h"
+
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+namespace {
+    // Up, down, left, right, as in SokobanSolver
+    const int StepX[4] = {0, 0, -1, 1};
+    const int StepY[4] = {1, -1, 0, 0};
+
+    enum Square : uint8_t { Floor, Wall, Box };
+
+    // xorshift64*, seeded through splitmix64 so nearby seeds give unrelated sequences
+    class Random {
+      public:
+        explicit Random(uint64_t seed) {
+            uint64_t z = seed + 0x9e3779b97f4a7c15ull;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            State = (z ^ (z >> 31)) | 1;
+        }
+
+        uint64_t Next() {
+            State ^= State >> 12;
+            State ^= State << 25;
+            State ^= State >> 27;
+            return State * 0x2545f4914f6cdd1dull;
+        }
+
+        // Uniform in [0, count)
+        int Below(int count) { return static_cast<int>((Next() >> 32) * static_cast<uint64_t>(count) >> 32); }
+
+      private:
+        uint64_t State;
+    };
+
+    struct Pull {
+        int Box;                        // Square of the box before the pull
+        int Direction;                  // The box moves this way, the player one square ahead
+    };
+}
+
+LevelGenerator::LevelGenerator(const SokobanLevel& board) : Base(board) {
+    Base.Boxes.clear();
+    Base.Targets.clear();
+    for (int y = 0; y < Base.Rows; y++) {
+        for (int x = 0; x < Base.Cols; x++) {
+            if (!Base.IsWall(Board::Pos(x, y))) FreeSquares.push_back(y * Base.Cols + x);
+        }
+    }
+}
+
+uint64_t LevelGenerator::CandidateSeed(uint64_t seed, size_t index) {
+    return seed * 0x9e3779b97f4a7c15ull + index;
+}
+
+LevelGenerator::Level LevelGenerator::Generate(uint64_t seed, const Options& options) const {
+    const int cols = Base.Cols, rows = Base.Rows;
+    Random random(seed);
+
+    Level level;
+    level.Seed = seed;
+    level.Puzzle = Base;
+
+    // Pillars, targets and the player on distinct free squares: a partial shuffle, no retries
+    std::vector<int> squares = FreeSquares;
+    const int wanted = options.Pillars + options.Boxes + 1;
+    const int placed = std::min<int>(wanted, static_cast<int>(squares.size()));
+    for (int i = 0; i < placed; i++) std::swap(squares[i], squares[i + random.Below(static_cast<int>(squares.size()) - i)]);
+    if (placed < wanted) return level;                 // The board is too small: an empty level
+
+    std::vector<uint8_t> grid(static_cast<size_t>(cols) * rows, Floor);
+    for (int square = 0; square < cols * rows; square++) {
+        if (Base.Walls[square]) grid[square] = Wall;
+    }
+
+    auto toPos = [cols](int square) { return Board::Pos(square % cols, square / cols); };
+    // The square one step from 'square', -1 off the board
+    auto step = [cols, rows](int square, int d) {
+        const int x = square % cols + StepX[d], y = square / cols + StepY[d];
+        return x < 0 || x >= cols || y < 0 || y >= rows ? -1 : y * cols + x;
+    };
+
+    int next = 0;
+    for (int i = 0; i < options.Pillars; i++, next++) {
+        grid[squares[next]] = Wall;
+        level.Pillars.push_back(toPos(squares[next]));
+        level.Puzzle.Walls[squares[next]] = 1;
+    }
+    std::vector<int> boxes;
+    for (int i = 0; i < options.Boxes; i++, next++) {
+        grid[squares[next]] = Box;
+        boxes.push_back(squares[next]);
+        level.Puzzle.Targets.push_back(toPos(squares[next]));
+    }
+    int player = squares[next];
+
+    // Reverse play. Each pull needs the player next to the box, on its side of the pull, with
+    // room to step back.
+    std::vector<uint8_t> reached(grid.size());
+    std::vector<int> queue;
+    // Marks the squares the player can walk to in 'reached' and lists them in 'queue'
+    auto walk = [&]() {
+        std::fill(reached.begin(), reached.end(), 0);
+        queue.assign(1, player);
+        reached[player] = 1;
+        for (size_t head = 0; head < queue.size(); head++) {
+            for (int d = 0; d < 4; d++) {
+                const int square = step(queue[head], d);
+                if (square < 0 || grid[square] != Floor || reached[square]) continue;
+                reached[square] = 1;
+                queue.push_back(square);
+            }
+        }
+    };
+    std::vector<Pull> pulls;
+    Pull last = {-1, -1};
+    int lines = 0, changes = 0;
+
+    for (int p = 0; p < options.Pulls; p++) {
+        walk();
+
+        // Keep pulling the same box most of the time, so the level has lines to follow rather
+        // than boxes shuffled one square at a time. Going straight back is the last resort: it
+        // gets the player out of dead ends.
+        pulls.clear();
+        size_t same = 0;
+        Pull undo = {-1, -1};
+        for (int box : boxes) {
+            for (int d = 0; d < 4; d++) {
+                const int stand = step(box, d), back = stand < 0 ? -1 : step(stand, d);
+                if (back < 0 || !reached[stand] || grid[back] != Floor) continue;
+                if (box == last.Box && d == (last.Direction ^ 1)) undo = {box, d};
+                else if (box == last.Box) pulls.insert(pulls.begin() + same++, {box, d});
+                else pulls.push_back({box, d});
+            }
+        }
+        if (pulls.empty() && undo.Box < 0) break;
+
+        Pull pull = undo;
+        if (same > 0 && random.Below(4) != 0) pull = pulls[random.Below(static_cast<int>(same))];
+        else if (!pulls.empty()) pull = pulls[random.Below(static_cast<int>(pulls.size()))];
+        const int to = step(pull.Box, pull.Direction);
+        grid[pull.Box] = Floor;
+        grid[to] = Box;
+        *std::find(boxes.begin(), boxes.end(), pull.Box) = to;
+        player = step(to, pull.Direction);
+
+        // A new line whenever the box or its direction changes; the box pulled before this one
+        // has moved to where it stands now
+        if (pull.Box != last.Box) changes++;
+        if (pull.Box != last.Box || pull.Direction != last.Direction) lines++;
+        last = {to, pull.Direction};
+    }
+
+    // The player starts anywhere it can walk to from where the reverse play ended
+    walk();
+    player = queue[random.Below(static_cast<int>(queue.size()))];
+
+    for (int box : boxes) level.Puzzle.Boxes.push_back(toPos(box));
+    level.Puzzle.Player = toPos(player);
+    level.Difficulty = lines + changes;
+    return level;
+}
+
+std::vector<LevelGenerator::Level> LevelGenerator::Generate(const Options& options) const {
+    Framework::ThreadPool& pool = options.Pool ? *options.Pool : Framework::ThreadPool::GetShared();
+
+    std::vector<Level> candidates(options.Candidates);
+    pool.ParallelFor(0, candidates.size(), 8, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) candidates[i] = Generate(CandidateSeed(options.Seed, i), options);
+    });
+
+    std::vector<Level> levels;
+    for (Level& level : candidates) {
+        if (level.Difficulty >= options.MinDifficulty && level.Difficulty <= options.MaxDifficulty) levels.push_back(std::move(level));
+    }
+    return levels;
+}
@@ -0,0 +1,56 @@
+#ifndef LEVELGENERATOR_H
+#define LEVELGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+#include "sokobanSolver.h"
+
+namespace Framework { class ThreadPool; }
+
+// Makes Sokoban levels by playing backwards from a solved one.
+//
+// A candidate starts with pillars on random floor squares and every box on a target. The player
+// then pulls boxes around at random: a pull is a push played in reverse, so the pushes that undo
+// the pulls solve the level and every candidate can be solved. All randomness comes from the
+// candidate's seed, so a seed always gives the same level.
+//
+// Candidates are made in parallel on the thread pool and scored by how much the box being moved
+// and its direction change during the reverse play. Levels within a difficulty range are kept.
+class LevelGenerator {
+  public:
+    struct Options {
+        int Pillars = 6;
+        int Boxes = 6;
+        int Pulls = 60;                     // Random pulls per candidate, fewer if the player gets stuck
+        size_t Candidates = 256;
+        int MinDifficulty = 30, MaxDifficulty = 60;
+        uint64_t Seed = 1;                  // Candidate i uses CandidateSeed(Seed, i)
+        Framework::ThreadPool* Pool = nullptr; // The shared pool if null
+    };
+
+    struct Level {
+        SokobanLevel Puzzle;                // Walls include the pillars
+        std::vector<Board::Pos> Pillars;
+        int Difficulty = 0;                 // Box lines plus box changes of the reverse play
+        uint64_t Seed = 0;
+    };
+
+    // 'board' gives the fixed walls and the size; its boxes, targets and player are ignored.
+    explicit LevelGenerator(const SokobanLevel& board);
+
+    // One candidate
+    Level Generate(uint64_t seed, const Options& options) const;
+    // The candidates within the difficulty range, in seed order
+    std::vector<Level> Generate(const Options& options) const;
+
+    static uint64_t CandidateSeed(uint64_t seed, size_t index);
+
+  private:
+    SokobanLevel Base;
+    std::vector<int> FreeSquares;           // Squares that are not walls, row by row
+};
+
+#endif
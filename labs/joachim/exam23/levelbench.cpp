@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+#include "levelGenerator.h"
+#include "sokobanSolver.h"
+
+// Level generator benchmark: candidates made per second with 1, 2, 4, ... pool threads, then a
+// check of the kept levels with the solver.
+//
+//   levelbench [candidates] [max threads]
+
+int main(int argc, char** argv) {
+    const int candidates = argc > 1 ? atoi(argv[1]) : 2048;
+    unsigned int maxThreads = argc > 2 ? static_cast<unsigned int>(atoi(argv[2])) : std::thread::hardware_concurrency();
+    if (candidates < 1 || maxThreads < 1) {
+        printf("usage: levelbench [candidates] [max threads]\n");
+        return 1;
+    }
+
+    // The exam board: walls all around
+    SokobanLevel board(BOARD_COLS, BOARD_ROWS);
+    for (int y = 0; y < BOARD_ROWS; y++) {
+        for (int x = 0; x < BOARD_COLS; x++) {
+            if (x == 0 || y == 0 || x == BOARD_COLS - 1 || y == BOARD_ROWS - 1) board.Walls[y * BOARD_COLS + x] = 1;
+        }
+    }
+    LevelGenerator generator(board);
+
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    printf("%d candidates, %u hardware threads\n\n", candidates, std::thread::hardware_concurrency());
+    printf("threads      time (s)      levels/s      kept   speedup\n");
+
+    LevelGenerator::Options options;
+    options.Candidates = candidates;
+    std::vector<LevelGenerator::Level> levels;
+    double singleThreadSeconds = 0.0;
+    for (unsigned int threads : threadCounts) {
+        Framework::ThreadPool pool(threads);
+        options.Pool = &pool;
+
+        const auto start = std::chrono::steady_clock::now();
+        levels = generator.Generate(options);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (threads == 1) singleThreadSeconds = seconds;
+        printf("%7u %13.3f %13.0f %9zu %9.2f\n", threads, seconds, candidates / seconds, levels.size(), singleThreadSeconds / seconds);
+    }
+
+    // The solver must never find a kept level unsolvable; the pushes it needs show how hard the
+    // levels are. Open levels can take it longer than its state limit to decide.
+    const size_t checked = std::min<size_t>(levels.size(), 100);
+    size_t solved = 0, gaveUp = 0, pushes = 0;
+    for (size_t i = 0; i < checked; i++) {
+        SokobanSolver::Result result = SokobanSolver(levels[i].Puzzle).Solve();
+        if (result.Outcome == SokobanSolver::Unsolvable) {
+            printf("seed %llu: unsolvable\n", static_cast<unsigned long long>(levels[i].Seed));
+        } else if (result.Outcome == SokobanSolver::GaveUp) {
+            gaveUp++;
+        } else {
+            solved++;
+            pushes += result.Pushes.size();
+        }
+    }
+    printf("\nsolved %zu of %zu kept levels (%zu too big to decide), %.1f pushes on average\n", solved, checked, gaveUp,
+           solved ? static_cast<double>(pushes) / solved : 0.0);
+
+    return solved + gaveUp == checked ? 0 : 1;
+}
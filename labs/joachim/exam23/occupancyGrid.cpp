@@ -0,0 +1,25 @@
+#include "occupancyGrid.h"
+
+#include <cassert>
+
+OccupancyGrid::OccupancyGrid(int cols, int rows, int layers)
+    : Cols(cols), Rows(rows), Layers(layers),
+      Masks(static_cast<size_t>(cols) * rows, 0),
+      Cells(static_cast<size_t>(cols) * rows * layers, Empty) {
+    assert(layers <= 8);
+}
+
+void OccupancyGrid::Insert(Board::Pos pos, int layer, Entity entity) {
+    if (!InBounds(pos)) return;
+    const size_t index = Index(pos);
+    Cells[index * Layers + layer] = entity;
+    Masks[index] |= static_cast<uint8_t>(1u << layer);
+}
+
+void OccupancyGrid::Remove(Board::Pos pos, int layer, Entity entity) {
+    if (!InBounds(pos)) return;
+    const size_t index = Index(pos);
+    if (Cells[index * Layers + layer] != entity) return;
+    Cells[index * Layers + layer] = Empty;
+    Masks[index] &= static_cast<uint8_t>(~(1u << layer));
+}
\ No newline at end of file
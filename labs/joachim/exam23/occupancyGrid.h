@@ -0,0 +1,48 @@
+#ifndef OCCUPANCYGRID_H
+#define OCCUPANCYGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+
+// What stands on each square, for constant-time lookups. Every square has a number of layers
+// (one per kind of object) that each hold at most one entity id, plus a bitmask of the layers
+// in use, so "is any of these kinds here" is a single load. Positions off the board are not
+// indexed: they read as empty.
+class OccupancyGrid {
+  public:
+    using Entity = uint32_t;
+    static constexpr Entity Empty = ~0u;
+
+    OccupancyGrid(int cols, int rows, int layers);
+
+    inline bool InBounds(Board::Pos pos) const { return pos.x >= 0 && pos.x < Cols && pos.y >= 0 && pos.y < Rows; }
+
+    // Adding an entity where the layer is taken replaces the entity there.
+    void Insert(Board::Pos pos, int layer, Entity entity);
+    // Removing only clears the layer if it still holds 'entity'.
+    void Remove(Board::Pos pos, int layer, Entity entity);
+    inline void Move(Board::Pos from, Board::Pos to, int layer, Entity entity) {
+        Remove(from, layer, entity);
+        Insert(to, layer, entity);
+    }
+
+    // Bit i is set if layer i is taken.
+    inline uint8_t GetLayers(Board::Pos pos) const { return InBounds(pos) ? Masks[Index(pos)] : 0; }
+    inline Entity Get(Board::Pos pos, int layer) const { return InBounds(pos) ? Cells[Index(pos) * Layers + layer] : Empty; }
+
+    inline int GetCols() const { return Cols; }
+    inline int GetRows() const { return Rows; }
+
+  private:
+    inline size_t Index(Board::Pos pos) const { return static_cast<size_t>(pos.y) * Cols + pos.x; }
+
+  private:
+    int Cols, Rows, Layers;
+    std::vector<uint8_t> Masks;             // Per square
+    std::vector<Entity> Cells;              // Per square and layer
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "occupancyGrid.h"
+
+// Occupancy grid benchmark on generated square boards, against the linear scans the assignment
+// used before. Pillars, boxes and destinations each take 5% of the squares, placed with Init's
+// rejection loop (a kind may not land on itself or on a kind placed before it), then random
+// squares are tried as pushes to the right. Both versions must place everything on the same
+// squares and agree on every push.
+//
+//   occupancybench [side...]
+
+namespace {
+    enum Kind { Pillar, Box, Destination, KindCount };
+
+    struct Random {
+        uint32_t State;
+        explicit Random(uint32_t seed) : State(seed) {}
+        int Below(int count) {
+            State = State * 1664525u + 1013904223u;
+            return static_cast<int>((State >> 8) % static_cast<uint32_t>(count));
+        }
+    };
+
+    double Milliseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool Same(const Board::Pos& a, const Board::Pos& b) { return a.x == b.x && a.y == b.y; }
+
+    bool Contains(const std::vector<Board::Pos>& list, Board::Pos pos) {
+        for (const Board::Pos& other : list) {
+            if (Same(other, pos)) return true;
+        }
+        return false;
+    }
+
+    // Is there a box at 'square' + 1 that can be pushed one further to the right
+    bool PushScan(const std::vector<Board::Pos> (&kinds)[KindCount], Board::Pos square, int side) {
+        const Board::Pos box(square.x + 1, square.y), target(square.x + 2, square.y);
+        if (!Contains(kinds[Box], box)) return false;
+        return target.x < side && !Contains(kinds[Pillar], target) && !Contains(kinds[Box], target);
+    }
+
+    bool PushGrid(const OccupancyGrid& grid, Board::Pos square) {
+        const Board::Pos box(square.x + 1, square.y), target(square.x + 2, square.y);
+        if (!(grid.GetLayers(box) & (1 << Box))) return false;
+        return grid.InBounds(target) && !(grid.GetLayers(target) & ((1 << Pillar) | (1 << Box)));
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> sides;
+    for (int i = 1; i < argc; i++) sides.push_back(atoi(argv[i]));
+    if (sides.empty()) sides = {100, 300, 1000};
+    if (std::any_of(sides.begin(), sides.end(), [](int side) { return side < 10; })) {
+        printf("usage: occupancybench [side >= 10...]\n");
+        return 1;
+    }
+
+    printf("%11s %8s %12s %12s %15s %15s %9s\n", "board", "per kind", "scan (ms)", "grid (ms)", "push scan (us)", "push grid (us)", "pushable");
+    bool same = true;
+    for (int side : sides) {
+        const size_t perKind = static_cast<size_t>(side) * side / 20;
+
+        // Placement, scanning the lists
+        std::vector<Board::Pos> scanned[KindCount];
+        Random random(7);
+        auto start = std::chrono::steady_clock::now();
+        for (int kind = 0; kind < KindCount; kind++) {
+            while (scanned[kind].size() < perKind) {
+                const Board::Pos pos(random.Below(side), random.Below(side));
+                bool occupied = false;
+                for (int other = 0; other <= kind && !occupied; other++) occupied = Contains(scanned[other], pos);
+                if (!occupied) scanned[kind].push_back(pos);
+            }
+        }
+        const double setupScanMs = Milliseconds(start);
+
+        // Placement, asking the grid
+        OccupancyGrid grid(side, side, KindCount);
+        std::vector<Board::Pos> indexed[KindCount];
+        random = Random(7);
+        start = std::chrono::steady_clock::now();
+        for (int kind = 0; kind < KindCount; kind++) {
+            const uint8_t kinds = static_cast<uint8_t>((2u << kind) - 1);
+            while (indexed[kind].size() < perKind) {
+                const Board::Pos pos(random.Below(side), random.Below(side));
+                if (grid.GetLayers(pos) & kinds) continue;
+                grid.Insert(pos, kind, static_cast<OccupancyGrid::Entity>(indexed[kind].size()));
+                indexed[kind].push_back(pos);
+            }
+        }
+        const double setupGridMs = Milliseconds(start);
+
+        for (int kind = 0; kind < KindCount; kind++) {
+            same &= scanned[kind].size() == indexed[kind].size()
+                 && std::equal(scanned[kind].begin(), scanned[kind].end(), indexed[kind].begin(), Same);
+        }
+
+        // Pushes; the scans get fewer squares on large boards
+        const int gridQueries = 1000000;
+        const int scanQueries = side >= 1000 ? gridQueries / 100 : gridQueries / 10;
+        std::vector<Board::Pos> squares(gridQueries);
+        for (Board::Pos& square : squares) square = Board::Pos(random.Below(side), random.Below(side));
+
+        std::vector<bool> pushScan(scanQueries), pushGrid(gridQueries);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < scanQueries; i++) pushScan[i] = PushScan(scanned, squares[i], side);
+        const double queryScanUs = Milliseconds(start) * 1000.0 / scanQueries;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < gridQueries; i++) pushGrid[i] = PushGrid(grid, squares[i]);
+        const double queryGridUs = Milliseconds(start) * 1000.0 / gridQueries;
+
+        same &= std::equal(pushScan.begin(), pushScan.end(), pushGrid.begin());
+
+        printf("%5dx%-5d %8zu %12.2f %12.3f %15.3f %15.4f %9zu\n", side, side, perKind, setupScanMs, setupGridMs, queryScanUs,
+               queryGridUs, static_cast<size_t>(std::count(pushGrid.begin(), pushGrid.end(), true)));
+    }
+
+    printf("\nlayouts and pushes %s\n", same ? "identical" : "DIFFER");
+    return same ? 0 : 1;
+}
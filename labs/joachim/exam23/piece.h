@@ -2,30 +2,24 @@
 #define PIECE_H
 
 #include <glm/glm.hpp>
-#include <memory>
-
-#include "VertexArray.h"
-#include "Shader.h"
 
 #include "board.h"
+#include "entities.h"
 
+// Handle to a cube standing on the board (piece, pillar, box or the player). The data lives in
+// the Entities arrays; copies of a Piece refer to the same entity.
 class Piece {
   private:
-    std::shared_ptr<Framework::VertexArray> vertexArray;
-    std::shared_ptr<Framework::Shader> shader;
-    glm::mat4 modelMatrix;
-    glm::mat4 initModelMatrix;
-    glm::vec4 color;
-    Board::Pos pos;
+    Entities* entities;
+    Entities::Entity entity;
     
   public:
-    Piece(int x, int y, glm::vec4 color);
+    Piece(Entities& entities, uint8_t kind, int x, int y, glm::vec4 color);
     ~Piece() { }   
 
-    void SetPosition(Board::Pos pos);
-    Board::Pos GetPosition() const { return pos; }
-
-    void Draw(glm::mat4 cameraModel, std::shared_ptr<glm::vec4> overrideColor = nullptr);
+    void SetPosition(Board::Pos pos) { entities->SetPosition(entity, pos); }
+    Board::Pos GetPosition() const { return entities->GetPosition(entity); }
+    Entities::Entity GetEntity() const { return entity; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,541 @@
+#include "sokobanSolver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <queue>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "ThreadPool.h"
+
+namespace {
+    // Up, down, left, right: the opposite of direction d is d ^ 1
+    const int StepX[4] = {0, 0, -1, 1};
+    const int StepY[4] = {1, -1, 0, 0};
+
+    inline void SetBit(uint64_t* bits, int i) { bits[i >> 6] |= 1ull << (i & 63); }
+    inline void ClearBit(uint64_t* bits, int i) { bits[i >> 6] &= ~(1ull << (i & 63)); }
+    inline bool TestBit(const uint64_t* bits, int i) { return (bits[i >> 6] >> (i & 63)) & 1; }
+
+    // Index of the lowest set bit of a non-zero word
+    inline int LowestBit(uint64_t bits) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    // splitmix64, fixed seed: the same keys on every run
+    uint64_t NextKey(uint64_t& state) {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // Set of 64-bit keys that threads insert into without locks (open addressing, linear
+    // probing). Key 0 marks an empty slot, so a zero key is stored as 1. Growing is not
+    // thread safe: Reserve() runs between the parallel phases.
+    class KeySet {
+      public:
+        void Reserve(size_t count) {
+            if (count * 2 <= Capacity) return;
+            size_t capacity = 1024;
+            while (capacity < count * 2) capacity *= 2;
+
+            std::unique_ptr<std::atomic<uint64_t>[]> old(Slots.release());
+            const size_t oldCapacity = Capacity;
+            Slots.reset(new std::atomic<uint64_t>[capacity]);
+            for (size_t i = 0; i < capacity; i++) Slots[i].store(0, std::memory_order_relaxed);
+            Capacity = capacity;
+            Count.store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < oldCapacity; i++) {
+                const uint64_t key = old[i].load(std::memory_order_relaxed);
+                if (key) Insert(key);
+            }
+        }
+
+        // False if the key was there already
+        bool Insert(uint64_t key) {
+            if (!key) key = 1;
+            const size_t mask = Capacity - 1;
+            for (size_t i = key & mask;; i = (i + 1) & mask) {
+                uint64_t current = Slots[i].load(std::memory_order_relaxed);
+                while (!current) {
+                    if (Slots[i].compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+                        Count.fetch_add(1, std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+                if (current == key) return false;
+            }
+        }
+
+        size_t Size() const { return Count.load(std::memory_order_relaxed); }
+
+      private:
+        std::unique_ptr<std::atomic<uint64_t>[]> Slots;
+        size_t Capacity = 0;
+        std::atomic<size_t> Count{0};
+    };
+
+    // A stored state. Its box set is at Words * index in the box arena.
+    struct Node {
+        uint32_t Parent;
+        int32_t Player;                 // Normalized
+        int32_t From;                   // Cell of the pushed box before the push, -1 at the start
+        uint8_t Direction;
+        uint32_t Pushes;
+        uint32_t Estimate;              // Pushes still needed, at least
+    };
+
+    // States found while expanding one chunk of a round
+    struct ChunkOutput {
+        std::vector<Node> Nodes;
+        std::vector<uint64_t> Boxes;
+        int Goal = -1;                  // Index in Nodes of a solved state
+    };
+
+    struct OpenEntry {
+        uint32_t Cost;                  // Pushes + estimate
+        uint32_t Estimate;
+        uint32_t Index;
+        // Lowest cost first, then the state closest to the goal
+        bool operator<(const OpenEntry& other) const {
+            return Cost != other.Cost ? Cost > other.Cost : Estimate > other.Estimate;
+        }
+    };
+}
+
+struct SokobanSolver::Scratch {
+    std::vector<uint64_t> Reach;        // Flood fill marks
+    std::vector<uint64_t> Region;       // Where the player of the state being expanded can go
+    std::vector<uint64_t> Open, Grown, Shifted;   // Flood fill buffers
+    std::vector<uint64_t> Boxes;        // Box set being built
+    std::vector<uint64_t> Walled;       // Boxes taken as walls by the freeze test
+    std::vector<int> Stack;
+    std::vector<int> Came;              // Path search: direction into each cell
+
+    explicit Scratch(int words, int cells)
+        : Reach(words), Region(words), Open(words), Grown(words), Shifted(words), Boxes(words), Walled(words, 0), Came(cells) { Stack.reserve(cells); }
+};
+
+SokobanLevel SokobanLevel::FromEntities(const Entities& entities, Board::Pos player, int cols, int rows) {
+    SokobanLevel level(cols, rows);
+    level.Player = player;
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            Board::Pos pos(x, y);
+            if (entities.IsOccupied(pos, Entities::Piece | Entities::Pillar)) level.Walls[static_cast<size_t>(y) * cols + x] = 1;
+            if (entities.IsOccupied(pos, Entities::Box)) level.Boxes.push_back(pos);
+            if (entities.IsOccupied(pos, Entities::Destination)) level.Targets.push_back(pos);
+        }
+    }
+    return level;
+}
+
+SokobanSolver::SokobanSolver(const SokobanLevel& level)
+    : Cols(level.Cols), Rows(level.Rows) {
+
+    // Cells are the squares of the floor's bounding box, row by row, so the squares the player
+    // can reach spread with a few shifts per step (Normalize)
+    int minX = Cols, minY = Rows, maxX = -1, maxY = -1;
+    for (int y = 0; y < Rows; y++) {
+        for (int x = 0; x < Cols; x++) {
+            if (level.IsWall(Board::Pos(x, y))) continue;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+    }
+    if (maxX < 0) minX = maxX = minY = maxY = 0;        // No floor at all
+    OriginX = minX;
+    OriginY = minY;
+    Stride = maxX - minX + 1;
+    CellCount = Stride * (maxY - minY + 1);
+    Words = (CellCount + 63) / 64;
+
+    FloorMask.assign(Words, 0);
+    FirstColumn.assign(Words, 0);
+    LastColumn.assign(Words, 0);
+    for (int cell = 0; cell < CellCount; cell++) {
+        if (!level.IsWall(SquareOf(cell))) SetBit(FloorMask.data(), cell);
+        if (cell % Stride == 0) SetBit(FirstColumn.data(), cell);
+        if (cell % Stride == Stride - 1) SetBit(LastColumn.data(), cell);
+    }
+
+    auto cellAt = [this](int x, int y) { return CellAt(Board::Pos(x, y)); };
+
+    Neighbors.resize(CellCount);
+    for (int cell = 0; cell < CellCount; cell++) {
+        const Board::Pos square = SquareOf(cell);
+        for (int d = 0; d < 4; d++) {
+            Neighbors[cell][d] = IsFloor(cell) ? cellAt(square.x + StepX[d], square.y + StepY[d]) : -1;
+        }
+    }
+
+    TargetMask.assign(Words, 0);
+    StartBoxes.assign(Words, 0);
+    for (const Board::Pos& target : level.Targets) {
+        const int cell = cellAt(target.x, target.y);
+        if (cell >= 0 && !TestBit(TargetMask.data(), cell)) {
+            SetBit(TargetMask.data(), cell);
+            TargetCount++;
+        }
+    }
+    for (const Board::Pos& box : level.Boxes) {
+        const int cell = cellAt(box.x, box.y);
+        if (cell < 0 || TestBit(StartBoxes.data(), cell)) BoxesOverlap = true;
+        else SetBit(StartBoxes.data(), cell);
+        BoxCount++;
+    }
+    StartPlayer = cellAt(level.Player.x, level.Player.y);
+
+    // Pushes to the nearest target, by pulling boxes away from every target at once: a box
+    // moves from 'cell' to 'next' if the player has room to stand beyond 'next'
+    Distance.assign(CellCount, Unreachable);
+    std::vector<int> queue;
+    for (int cell = 0; cell < CellCount; cell++) {
+        if (IsTarget(cell)) {
+            Distance[cell] = 0;
+            queue.push_back(cell);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); head++) {
+        const int cell = queue[head];
+        for (int d = 0; d < 4; d++) {
+            const int next = Neighbors[cell][d];
+            if (next < 0 || Neighbors[next][d] < 0 || Distance[next] != Unreachable) continue;
+            Distance[next] = Distance[cell] + 1;
+            queue.push_back(next);
+        }
+    }
+
+    uint64_t seed = 0x5eed50c0ba11ull;
+    BoxKeys.resize(CellCount);
+    PlayerKeys.resize(CellCount);
+    for (int cell = 0; cell < CellCount; cell++) {
+        BoxKeys[cell] = NextKey(seed);
+        PlayerKeys[cell] = NextKey(seed);
+    }
+}
+
+// Marks the squares the player can walk to in scratch.Reach and returns the lowest one. The
+// region grows by one step in every direction at once, a word of squares at a time.
+int SokobanSolver::Normalize(const uint64_t* boxes, int player, Scratch& scratch) const {
+    uint64_t* reach = scratch.Reach.data();
+
+    if (Words == 1 && Stride < 64) {
+        const uint64_t open = FloorMask[0] & ~boxes[0];
+        const uint64_t notFirst = ~FirstColumn[0], notLast = ~LastColumn[0];
+        uint64_t region = 1ull << player, previous;
+        do {
+            previous = region;
+            region |= (((region << 1) & notFirst) | ((region >> 1) & notLast) | (region << Stride) | (region >> Stride)) & open;
+        } while (region != previous);
+        reach[0] = region;
+        return LowestBit(region);
+    }
+
+    uint64_t* open = scratch.Open.data();
+    uint64_t* grown = scratch.Grown.data();
+    uint64_t* shifted = scratch.Shifted.data();
+    for (int w = 0; w < Words; w++) {
+        open[w] = FloorMask[w] & ~boxes[w];
+        reach[w] = 0;
+    }
+    SetBit(reach, player);
+
+    for (bool changed = true; changed;) {
+        std::copy(reach, reach + Words, grown);
+        ShiftUp(reach, shifted, 1);
+        for (int w = 0; w < Words; w++) grown[w] |= shifted[w] & ~FirstColumn[w];
+        ShiftDown(reach, shifted, 1);
+        for (int w = 0; w < Words; w++) grown[w] |= shifted[w] & ~LastColumn[w];
+        ShiftUp(reach, shifted, Stride);
+        for (int w = 0; w < Words; w++) grown[w] |= shifted[w];
+        ShiftDown(reach, shifted, Stride);
+        for (int w = 0; w < Words; w++) grown[w] |= shifted[w];
+
+        changed = false;
+        for (int w = 0; w < Words; w++) {
+            const uint64_t region = reach[w] | (grown[w] & open[w]);
+            changed |= region != reach[w];
+            reach[w] = region;
+        }
+    }
+
+    for (int w = 0;; w++) {
+        if (reach[w]) return w * 64 + LowestBit(reach[w]);
+    }
+}
+
+// Multi-word shifts of a cell set towards higher and lower cells
+void SokobanSolver::ShiftUp(const uint64_t* bits, uint64_t* result, int count) const {
+    const int words = count / 64, shift = count % 64;
+    for (int w = Words - 1; w >= 0; w--) {
+        const int from = w - words;
+        uint64_t value = from >= 0 ? bits[from] << shift : 0;
+        if (shift && from - 1 >= 0) value |= bits[from - 1] >> (64 - shift);
+        result[w] = value;
+    }
+}
+
+void SokobanSolver::ShiftDown(const uint64_t* bits, uint64_t* result, int count) const {
+    const int words = count / 64, shift = count % 64;
+    for (int w = 0; w < Words; w++) {
+        const int from = w + words;
+        uint64_t value = from < Words ? bits[from] >> shift : 0;
+        if (shift && from + 1 < Words) value |= bits[from + 1] << (64 - shift);
+        result[w] = value;
+    }
+}
+
+// Can the box at 'cell' never move again? A box is stuck along an axis if a wall is next to
+// it on that axis, if both squares on the axis are dead, or if a box next to it on the axis is
+// frozen itself (with this box taken as a wall, which stops cycles). 'offTarget' is set if a
+// frozen box found on the way is not on a target: then the level can no longer be solved.
+bool SokobanSolver::IsFrozen(int cell, const uint64_t* boxes, Scratch& scratch, bool& offTarget) const {
+    uint64_t* walled = scratch.Walled.data();
+    SetBit(walled, cell);
+
+    bool frozen = true;
+    bool off = !IsTarget(cell);
+    for (int axis = 0; axis < 4 && frozen; axis += 2) {
+        const int a = Neighbors[cell][axis], b = Neighbors[cell][axis + 1];
+        bool stuck = a < 0 || b < 0 || TestBit(walled, a) || TestBit(walled, b)
+                  || (Distance[a] == Unreachable && Distance[b] == Unreachable);
+        for (int side : {a, b}) {
+            if (stuck) break;
+            bool sideOff = false;
+            if (IsBox(boxes, side) && IsFrozen(side, boxes, scratch, sideOff)) {
+                stuck = true;
+                off |= sideOff;
+            }
+        }
+        frozen = stuck;
+    }
+
+    ClearBit(walled, cell);
+    if (frozen) offTarget |= off;
+    return frozen;
+}
+
+// Shortest walk from 'from' to 'to' around the boxes, as directions
+bool SokobanSolver::PathTo(const uint64_t* boxes, int from, int to, Scratch& scratch, std::vector<int>& directions) const {
+    std::fill(scratch.Reach.begin(), scratch.Reach.end(), 0);
+    std::vector<int>& queue = scratch.Stack;
+    queue.clear();
+    queue.push_back(from);
+    SetBit(scratch.Reach.data(), from);
+
+    for (size_t head = 0; head < queue.size() && !TestBit(scratch.Reach.data(), to); head++) {
+        const int cell = queue[head];
+        for (int d = 0; d < 4; d++) {
+            const int next = Neighbors[cell][d];
+            if (next < 0 || IsBox(boxes, next) || TestBit(scratch.Reach.data(), next)) continue;
+            SetBit(scratch.Reach.data(), next);
+            scratch.Came[next] = d;
+            queue.push_back(next);
+        }
+    }
+    if (!TestBit(scratch.Reach.data(), to)) return false;
+
+    const size_t first = directions.size();
+    for (int cell = to; cell != from; cell = Neighbors[cell][scratch.Came[cell] ^ 1]) directions.push_back(scratch.Came[cell]);
+    std::reverse(directions.begin() + first, directions.end());
+    return true;
+}
+
+uint64_t SokobanSolver::HashBoxes(const uint64_t* boxes) const {
+    uint64_t hash = 0;
+    for (int w = 0; w < Words; w++) {
+        for (uint64_t bits = boxes[w]; bits; bits &= bits - 1) {
+            hash ^= BoxKeys[w * 64 + LowestBit(bits)];
+        }
+    }
+    return hash;
+}
+
+// Sum of every box's pushes to its nearest target: never more than the pushes needed
+int SokobanSolver::Heuristic(const uint64_t* boxes) const {
+    int sum = 0;
+    for (int w = 0; w < Words; w++) {
+        for (uint64_t bits = boxes[w]; bits; bits &= bits - 1) {
+            sum += Distance[w * 64 + LowestBit(bits)];
+        }
+    }
+    return sum;
+}
+
+SokobanSolver::Result SokobanSolver::Solve(const Options& options) const {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    Result result;
+    auto finish = [&result, start](Status outcome) {
+        result.Outcome = outcome;
+        result.Seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return result;
+    };
+
+    if (StartPlayer < 0 || BoxesOverlap || BoxCount > TargetCount) return finish(Unsolvable);
+
+    // Dead or frozen from the start?
+    Scratch scratch(Words, CellCount);
+    bool solved = true;
+    for (int cell = 0; cell < CellCount; cell++) {
+        if (!IsBox(StartBoxes.data(), cell)) continue;
+        if (Distance[cell] == Unreachable) return finish(Unsolvable);
+        bool offTarget = false;
+        if (IsFrozen(cell, StartBoxes.data(), scratch, offTarget) && offTarget) return finish(Unsolvable);
+        if (!IsTarget(cell)) solved = false;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<uint64_t> boxArena;
+    KeySet visited;
+    std::priority_queue<OpenEntry> open;
+
+    const int startPlayer = Normalize(StartBoxes.data(), StartPlayer, scratch);
+    nodes.push_back({0, startPlayer, -1, 0, 0, static_cast<uint32_t>(Heuristic(StartBoxes.data()))});
+    boxArena.insert(boxArena.end(), StartBoxes.begin(), StartBoxes.end());
+    visited.Reserve(1024);
+    visited.Insert(HashBoxes(StartBoxes.data()) ^ PlayerKeys[startPlayer]);
+    open.push({nodes[0].Estimate, nodes[0].Estimate, 0});
+
+    int goal = solved ? 0 : -1;
+    Framework::ThreadPool& pool = options.Pool ? *options.Pool : Framework::ThreadPool::GetShared();
+    const size_t batchSize = std::max<size_t>(options.BatchSize, 1);
+    const size_t grain = 4;
+    std::vector<uint32_t> batch;
+    std::vector<ChunkOutput> outputs;
+
+    while (goal < 0 && !open.empty()) {
+        if (visited.Size() >= options.MaxStates) {
+            result.States = visited.Size();
+            return finish(GaveUp);
+        }
+
+        // Take the best states of this round
+        batch.clear();
+        while (!open.empty() && batch.size() < batchSize) {
+            batch.push_back(open.top().Index);
+            open.pop();
+        }
+
+        // Room for every state the round can find, so the set never grows while threads insert
+        visited.Reserve(visited.Size() + batch.size() * BoxCount * 4);
+        outputs.assign((batch.size() + grain - 1) / grain, ChunkOutput());
+
+        pool.ParallelFor(0, batch.size(), grain, [&](size_t first, size_t last) {
+            Scratch local(Words, CellCount);
+            ChunkOutput& output = outputs[first / grain];
+            uint64_t* boxes = local.Boxes.data();
+
+            for (size_t b = first; b < last && output.Goal < 0; b++) {
+                const uint32_t index = batch[b];
+                const Node& node = nodes[index];
+                const uint64_t* parentBoxes = &boxArena[static_cast<size_t>(index) * Words];
+                const uint64_t parentHash = HashBoxes(parentBoxes);
+
+                // Where the player can go decides which pushes are possible
+                Normalize(parentBoxes, node.Player, local);
+                local.Region.swap(local.Reach);
+                const uint64_t* region = local.Region.data();
+
+                for (int w = 0; w < Words && output.Goal < 0; w++) {
+                    for (uint64_t bits = parentBoxes[w]; bits; bits &= bits - 1) {
+                        const int box = w * 64 + LowestBit(bits);
+                        for (int d = 0; d < 4; d++) {
+                            const int behind = Neighbors[box][d ^ 1];
+                            const int to = Neighbors[box][d];
+                            if (behind < 0 || to < 0 || !TestBit(region, behind)) continue;
+                            if (IsBox(parentBoxes, to) || Distance[to] == Unreachable) continue;
+
+                            std::copy(parentBoxes, parentBoxes + Words, boxes);
+                            ClearBit(boxes, box);
+                            SetBit(boxes, to);
+
+                            bool offTarget = false;
+                            if (IsFrozen(to, boxes, local, offTarget) && offTarget) continue;
+
+                            const int player = Normalize(boxes, box, local);
+                            const uint64_t hash = parentHash ^ BoxKeys[box] ^ BoxKeys[to] ^ PlayerKeys[player];
+                            if (!visited.Insert(hash)) continue;
+
+                            Node child;
+                            child.Parent = index;
+                            child.Player = player;
+                            child.From = box;
+                            child.Direction = static_cast<uint8_t>(d);
+                            child.Pushes = node.Pushes + 1;
+                            child.Estimate = static_cast<uint32_t>(node.Estimate - Distance[box] + Distance[to]);
+                            output.Nodes.push_back(child);
+                            output.Boxes.insert(output.Boxes.end(), boxes, boxes + Words);
+
+                            bool done = true;
+                            for (int i = 0; i < Words; i++) done &= (boxes[i] & ~TargetMask[i]) == 0;
+                            if (done) {
+                                output.Goal = static_cast<int>(output.Nodes.size() - 1);
+                                break;
+                            }
+                        }
+                        if (output.Goal >= 0) break;
+                    }
+                }
+            }
+        });
+
+        // Store the new states (serially, so the arena never moves under the workers)
+        for (ChunkOutput& output : outputs) {
+            const uint32_t base = static_cast<uint32_t>(nodes.size());
+            for (size_t i = 0; i < output.Nodes.size(); i++) {
+                const Node& child = output.Nodes[i];
+                nodes.push_back(child);
+                open.push({static_cast<uint32_t>(child.Pushes + child.Estimate), child.Estimate, base + static_cast<uint32_t>(i)});
+            }
+            boxArena.insert(boxArena.end(), output.Boxes.begin(), output.Boxes.end());
+            if (output.Goal >= 0 && (goal < 0 || output.Nodes[output.Goal].Pushes < nodes[goal].Pushes)) {
+                goal = static_cast<int>(base) + output.Goal;
+            }
+        }
+    }
+
+    result.States = visited.Size();
+    if (goal < 0) return finish(Unsolvable);
+
+    // Pushes, from the goal back to the start
+    for (uint32_t index = static_cast<uint32_t>(goal); nodes[index].From >= 0; index = nodes[index].Parent) {
+        const Node& node = nodes[index];
+        result.Pushes.push_back({SquareOf(node.From), Board::Pos(StepX[node.Direction], StepY[node.Direction])});
+    }
+    std::reverse(result.Pushes.begin(), result.Pushes.end());
+
+    // Replay them from the real start square to get the walk between pushes
+    std::vector<uint64_t> boxes = StartBoxes;
+    std::vector<int> directions;
+    int player = StartPlayer;
+    for (const Push& push : result.Pushes) {
+        const int box = CellAt(push.Box);
+        int d = 0;
+        while (StepX[d] != push.Direction.x || StepY[d] != push.Direction.y) d++;
+
+        PathTo(boxes.data(), player, Neighbors[box][d ^ 1], scratch, directions);
+        directions.push_back(d);
+        ClearBit(boxes.data(), box);
+        SetBit(boxes.data(), Neighbors[box][d]);
+        player = box;
+    }
+    for (int d : directions) result.Steps.push_back(Board::Pos(StepX[d], StepY[d]));
+
+    return finish(Solved);
+}
@@ -0,0 +1,122 @@
+#ifndef SOKOBANSOLVER_H
+#define SOKOBANSOLVER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+#include "entities.h"
+
+namespace Framework { class ThreadPool; }
+
+// A box pushing puzzle: walls, boxes, targets and the player on a cols x rows grid. Squares off
+// the grid count as walls. It is solved when every box stands on a target.
+struct SokobanLevel {
+    int Cols = 0, Rows = 0;
+    std::vector<uint8_t> Walls;             // Per square, row by row: nonzero for a wall
+    std::vector<Board::Pos> Boxes;
+    std::vector<Board::Pos> Targets;
+    Board::Pos Player;
+
+    SokobanLevel() {}
+    SokobanLevel(int cols, int rows) : Cols(cols), Rows(rows), Walls(static_cast<size_t>(cols) * rows, 0) {}
+
+    inline bool IsWall(Board::Pos pos) const {
+        return pos.x < 0 || pos.x >= Cols || pos.y < 0 || pos.y >= Rows || Walls[static_cast<size_t>(pos.y) * Cols + pos.x];
+    }
+
+    // The level standing on the board: pieces and pillars are walls, destinations are targets.
+    static SokobanLevel FromEntities(const Entities& entities, Board::Pos player, int cols = BOARD_COLS, int rows = BOARD_ROWS);
+};
+
+// Solves a level by best-first search over box pushes.
+//
+// A state is the set of boxes (one bit per square of the floor's bounding box) plus the
+// player's region, stored as the lowest square the player can walk to, so walking around never makes a new state. States
+// are deduplicated by Zobrist key in a lock-free set. Pushes that make the level unsolvable are
+// never generated: a box on a square from which no target can be reached (simple deadlock), or
+// boxes that block each other against the walls away from the targets (freeze deadlock).
+//
+// The search is A* on the number of pushes, in rounds: each round takes the best open states
+// and expands them in parallel on the thread pool. Solutions are short, but with more than one
+// state expanded per round they are not guaranteed to be the shortest.
+class SokobanSolver {
+  public:
+    enum Status { Solved, Unsolvable, GaveUp };
+
+    struct Push {
+        Board::Pos Box;                     // Before the push
+        Board::Pos Direction;               // Unit step
+    };
+
+    struct Result {
+        Status Outcome = GaveUp;
+        std::vector<Push> Pushes;
+        std::vector<Board::Pos> Steps;      // Every player step (unit steps), pushes included
+        size_t States = 0;                  // Distinct states generated
+        double Seconds = 0.0;
+
+        double StatesPerSecond() const { return Seconds > 0.0 ? States / Seconds : 0.0; }
+    };
+
+    struct Options {
+        size_t MaxStates = 2000000;         // Give up beyond this many states
+        size_t BatchSize = 256;             // States expanded per round
+        Framework::ThreadPool* Pool = nullptr; // The shared pool if null
+    };
+
+    explicit SokobanSolver(const SokobanLevel& level);
+
+    Result Solve(const Options& options) const;
+    Result Solve() const { return Solve(Options()); }
+
+  private:
+    struct Scratch;                         // Per-thread buffers of a search
+
+    int Normalize(const uint64_t* boxes, int player, Scratch& scratch) const;
+    void ShiftUp(const uint64_t* bits, uint64_t* result, int count) const;
+    void ShiftDown(const uint64_t* bits, uint64_t* result, int count) const;
+    bool IsFrozen(int cell, const uint64_t* boxes, Scratch& scratch, bool& offTarget) const;
+    bool PathTo(const uint64_t* boxes, int from, int to, Scratch& scratch, std::vector<int>& directions) const;
+    uint64_t HashBoxes(const uint64_t* boxes) const;
+    int Heuristic(const uint64_t* boxes) const;
+
+    inline bool IsBox(const uint64_t* boxes, int cell) const { return (boxes[cell >> 6] >> (cell & 63)) & 1; }
+    inline bool IsTarget(int cell) const { return (TargetMask[cell >> 6] >> (cell & 63)) & 1; }
+    inline bool IsFloor(int cell) const { return (FloorMask[cell >> 6] >> (cell & 63)) & 1; }
+
+    inline Board::Pos SquareOf(int cell) const { return Board::Pos(OriginX + cell % Stride, OriginY + cell / Stride); }
+    // -1 for walls
+    inline int CellAt(Board::Pos pos) const {
+        const int x = pos.x - OriginX, y = pos.y - OriginY;
+        if (x < 0 || x >= Stride || y < 0 || y * Stride >= CellCount) return -1;
+        return IsFloor(y * Stride + x) ? y * Stride + x : -1;
+    }
+
+  private:
+    static constexpr uint32_t Unreachable = 0xffffffff;
+
+    // Cells: the squares of the floor's bounding box, row by row from (OriginX, OriginY)
+    int Cols, Rows;
+    int OriginX = 0, OriginY = 0;
+    int Stride = 1;                         // Cells per row
+    int CellCount = 0;
+    int Words = 0;                          // 64-bit words per cell set
+    std::vector<uint64_t> FloorMask;
+    std::vector<uint64_t> FirstColumn, LastColumn;  // Stop row shifts wrapping around
+    std::vector<std::array<int, 4>> Neighbors; // Up, down, left, right; -1 for walls
+
+    std::vector<uint64_t> TargetMask;
+    std::vector<uint32_t> Distance;         // Pushes from each cell to the nearest target, ignoring other boxes
+    std::vector<uint64_t> BoxKeys, PlayerKeys;
+
+    std::vector<uint64_t> StartBoxes;
+    int StartPlayer = -1;                   // -1 if the player stands on a wall
+    int BoxCount = 0;
+    int TargetCount = 0;
+    bool BoxesOverlap = false;              // Two boxes, or a box and a wall, on one square
+};
+
+#endif
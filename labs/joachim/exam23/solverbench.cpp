@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "sokobanSolver.h"
+
+// Solver check and benchmark. On small random levels the solver must agree with a plain
+// breadth-first search over every (boxes, player) state, without any pruning, on whether the
+// level can be solved. Every solution must replay: its steps walk the player over floor only,
+// the pushes they make are the pushes reported, and all boxes end on targets. Bigger levels then
+// give the states per second, and a level whose floor spans more cells than 16 bits can number
+// checks that large levels still solve.
+//
+//   solverbench [small levels] [timed levels]
+
+namespace {
+    struct Random {
+        uint32_t State;
+        explicit Random(uint32_t seed) : State(seed) {}
+        int Below(int count) {
+            State = State * 1664525u + 1013904223u;
+            return static_cast<int>((State >> 8) % static_cast<uint32_t>(count));
+        }
+    };
+
+    bool Same(const Board::Pos& a, const Board::Pos& b) { return a.x == b.x && a.y == b.y; }
+
+    bool Contains(const std::vector<Board::Pos>& list, Board::Pos pos) {
+        for (const Board::Pos& other : list) {
+            if (Same(other, pos)) return true;
+        }
+        return false;
+    }
+
+    // A side x side room with walls all around, pillars inside, and boxes, targets and the
+    // player on distinct free squares
+    SokobanLevel RandomLevel(int side, int boxes, int pillars, uint32_t seed) {
+        SokobanLevel level(side, side);
+        for (int y = 0; y < side; y++) {
+            for (int x = 0; x < side; x++) {
+                if (x == 0 || y == 0 || x == side - 1 || y == side - 1) level.Walls[y * side + x] = 1;
+            }
+        }
+        Random random(seed);
+        auto inside = [&]() { return Board::Pos(1 + random.Below(side - 2), 1 + random.Below(side - 2)); };
+        for (int placed = 0; placed < pillars;) {
+            const Board::Pos pos = inside();
+            if (!level.IsWall(pos)) {
+                level.Walls[pos.y * side + pos.x] = 1;
+                placed++;
+            }
+        }
+        auto free = [&](Board::Pos pos) { return !level.IsWall(pos) && !Contains(level.Boxes, pos) && !Contains(level.Targets, pos); };
+        while (static_cast<int>(level.Boxes.size()) < boxes) {
+            const Board::Pos pos = inside();
+            if (free(pos)) level.Boxes.push_back(pos);
+        }
+        while (static_cast<int>(level.Targets.size()) < boxes) {
+            const Board::Pos pos = inside();
+            if (free(pos)) level.Targets.push_back(pos);
+        }
+        do {
+            level.Player = inside();
+        } while (!free(level.Player));
+        return level;
+    }
+
+    enum Reference { ReferenceSolved, ReferenceUnsolvable, ReferenceTooBig };
+
+    // Breadth-first search over the sorted box squares and the player's square
+    Reference SearchAll(const SokobanLevel& level, size_t maxStates) {
+        typedef std::pair<std::vector<int>, int> State;
+        auto square = [&level](Board::Pos pos) { return pos.y * level.Cols + pos.x; };
+        std::vector<int> targets;
+        for (const Board::Pos& target : level.Targets) targets.push_back(square(target));
+
+        State start;
+        for (const Board::Pos& box : level.Boxes) start.first.push_back(square(box));
+        std::sort(start.first.begin(), start.first.end());
+        start.second = square(level.Player);
+
+        const int stepX[4] = {0, 0, -1, 1}, stepY[4] = {-1, 1, 0, 0};
+        std::set<State> seen = {start};
+        std::queue<State> open;
+        open.push(start);
+        while (!open.empty()) {
+            const State state = open.front();
+            open.pop();
+            bool solved = true;
+            for (int box : state.first) solved = solved && std::find(targets.begin(), targets.end(), box) != targets.end();
+            if (solved) return ReferenceSolved;
+            if (seen.size() > maxStates) return ReferenceTooBig;
+
+            const Board::Pos player(state.second % level.Cols, state.second / level.Cols);
+            for (int d = 0; d < 4; d++) {
+                const Board::Pos next(player.x + stepX[d], player.y + stepY[d]);
+                if (level.IsWall(next)) continue;
+                State child(state.first, square(next));
+                auto box = std::find(child.first.begin(), child.first.end(), child.second);
+                if (box != child.first.end()) {
+                    const Board::Pos to(next.x + stepX[d], next.y + stepY[d]);
+                    if (level.IsWall(to) || std::find(child.first.begin(), child.first.end(), square(to)) != child.first.end()) continue;
+                    *box = square(to);
+                    std::sort(child.first.begin(), child.first.end());
+                }
+                if (seen.insert(child).second) open.push(child);
+            }
+        }
+        return ReferenceUnsolvable;
+    }
+
+    // Walks the steps of a solution; returns false unless they are legal, make exactly the
+    // reported pushes and leave every box on a target
+    bool Replays(const SokobanLevel& level, const SokobanSolver::Result& result) {
+        std::vector<Board::Pos> boxes = level.Boxes;
+        Board::Pos player = level.Player;
+        size_t pushes = 0;
+        for (const Board::Pos& step : result.Steps) {
+            if (std::abs(step.x) + std::abs(step.y) != 1) return false;
+            const Board::Pos next(player.x + step.x, player.y + step.y);
+            if (level.IsWall(next)) return false;
+            for (Board::Pos& box : boxes) {
+                if (!Same(box, next)) continue;
+                const Board::Pos to(next.x + step.x, next.y + step.y);
+                if (level.IsWall(to) || Contains(boxes, to)) return false;
+                if (pushes == result.Pushes.size() || !Same(result.Pushes[pushes].Box, box)
+                    || !Same(result.Pushes[pushes].Direction, step)) return false;
+                pushes++;
+                box = to;
+                break;
+            }
+            player = next;
+        }
+        for (const Board::Pos& box : boxes) {
+            if (!Contains(level.Targets, box)) return false;
+        }
+        return pushes == result.Pushes.size();
+    }
+
+    const char* OutcomeName(SokobanSolver::Status outcome) {
+        return outcome == SokobanSolver::Solved ? "solved" : outcome == SokobanSolver::Unsolvable ? "unsolvable" : "gave up";
+    }
+}
+
+int main(int argc, char** argv) {
+    const int smallLevels = argc > 1 ? atoi(argv[1]) : 300;
+    const int timedLevels = argc > 2 ? atoi(argv[2]) : 200;
+    if (smallLevels < 0 || timedLevels < 0) {
+        printf("usage: solverbench [small levels] [timed levels]\n");
+        return 1;
+    }
+    bool correct = true;
+
+    // Against the full search: 8x8 floors, 6 pillars, 2 or 3 boxes
+    int compared = 0, solvable = 0, tooBig = 0;
+    for (int i = 0; i < smallLevels; i++) {
+        const uint32_t seed = static_cast<uint32_t>(i + 1);
+        const SokobanLevel level = RandomLevel(10, 2 + i % 2, 6, seed);
+        const Reference reference = SearchAll(level, 3000000);
+        if (reference == ReferenceTooBig) {
+            tooBig++;
+            continue;
+        }
+        compared++;
+        solvable += reference == ReferenceSolved;
+
+        const SokobanSolver::Result result = SokobanSolver(level).Solve();
+        const bool expected = reference == ReferenceSolved;
+        if ((result.Outcome == SokobanSolver::Solved) != expected || result.Outcome == SokobanSolver::GaveUp) {
+            printf("seed %u: solver %s, full search %s\n", seed, OutcomeName(result.Outcome), expected ? "solved" : "unsolvable");
+            correct = false;
+        } else if (result.Outcome == SokobanSolver::Solved && !Replays(level, result)) {
+            printf("seed %u: the solution does not replay\n", seed);
+            correct = false;
+        }
+    }
+    printf("%d small levels against the full search (%d solvable, %d skipped as too big): %s\n\n", compared, solvable, tooBig,
+           correct ? "all agree" : "DIFFER");
+
+    // Timed: the exam board's size with 6 boxes
+    printf("%-22s %7s %7s %7s %12s %10s %12s\n", "levels", "solved", "unsolv.", "gave up", "states", "time (s)", "states/s");
+    int outcomes[3] = {0, 0, 0};
+    size_t states = 0;
+    double seconds = 0.0;
+    for (int i = 0; i < timedLevels; i++) {
+        const uint32_t seed = static_cast<uint32_t>(i + 1);
+        const SokobanLevel level = RandomLevel(10, 6, 6, seed);
+        const SokobanSolver::Result result = SokobanSolver(level).Solve();
+        outcomes[result.Outcome]++;
+        states += result.States;
+        seconds += result.Seconds;
+        if (result.Outcome == SokobanSolver::Solved && !Replays(level, result)) {
+            printf("seed %u: the solution does not replay\n", seed);
+            correct = false;
+        }
+    }
+    printf("%-22s %7d %7d %7d %12zu %10.3f %12.0f\n", "10x10, 6 boxes", outcomes[SokobanSolver::Solved],
+           outcomes[SokobanSolver::Unsolvable], outcomes[SokobanSolver::GaveUp], states, seconds, seconds > 0.0 ? states / seconds : 0.0);
+
+    // A 12x12 room in the far corner of a 200x200 level whose only other floor is the opposite
+    // corner: the floor's bounding box has more cells than 16 bits can number, and the room's
+    // cells are all beyond that
+    SokobanLevel room(200, 200);
+    for (int y = 0; y < 200; y++) {
+        for (int x = 0; x < 200; x++) room.Walls[y * 200 + x] = !(x >= 187 && x < 199 && y >= 187 && y < 199);
+    }
+    room.Walls[1 * 200 + 1] = 0;
+    room.Boxes = {Board::Pos(189, 189), Board::Pos(196, 190)};
+    room.Targets = {Board::Pos(196, 196), Board::Pos(190, 195)};
+    room.Player = Board::Pos(188, 188);
+    const SokobanSolver::Result result = SokobanSolver(room).Solve();
+    const bool roomSolved = result.Outcome == SokobanSolver::Solved && Replays(room, result);
+    printf("%-22s %7d %7d %7d %12zu %10.3f %12.0f  %zu pushes%s\n", "200x200, far room", result.Outcome == SokobanSolver::Solved,
+           result.Outcome == SokobanSolver::Unsolvable, result.Outcome == SokobanSolver::GaveUp, result.States, result.Seconds,
+           result.StatesPerSecond(), result.Pushes.size(), roomSolved ? "" : ", NOT SOLVED");
+    correct = correct && roomSolved;
+
+    return correct ? 0 : 1;
+}
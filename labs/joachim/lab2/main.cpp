@@ -47,7 +47,7 @@ class harIkkeKreativitet : public Framework::GLFWApplication{
 
     GLint createChessBoard(){
         auto chessBoardVerticies = Framework::GeometricTools::UnitGridGeometry2D<rows, cols>(); //data for verticies
-        chessBoardIndecies = Framework::GeometricTools::UnitGridTopologyTriangles<rows, cols>(); //data for squares/incencies
+        chessBoardIndecies = Framework::GeometricTools::UnitGridTopologyTriangles(rows, cols); //data for squares/incencies
 
         //Create VAO
         GLuint VAO;